@@ -49,27 +49,36 @@ using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
-BhKmerCollector::BhKmerCollector(const Settings &s, const string &filename, CircularQueue<string> &queue):
-  KmerCollector(s.kmer_length, filename, queue, s.verbose),
-  _lcp_stats(), _transformer(s.transformer()), _prev_transformed_kmer()
+BhKmerCollector::BhKmerCollector(const Settings &s, const string &filename, CircularQueue<KmerBlock> &queue,
+                                 size_t first_byte, size_t last_byte):
+  KmerCollector(s.kmer_length, filename, queue, s.verbose, s.block_size, first_byte, last_byte),
+  _lcp_stats(), _transformer(s.transformer()), _static_transformer(_transformer),
+  _prev_transformed_kmer()
 {
   _lcp_stats.start();
 }
 
-void BhKmerCollector::_process(string &kmer) {
-  DEBUG_MSG("Computing encoded k-mer for '" << kmer << " for LCP statistics");
-  Transformer::EncodedKmer transformed_kmer;
-  transformed_kmer = (*_transformer)(kmer);
+void BhKmerCollector::_updateLcpStats(const Transformer::EncodedKmer &transformed_kmer) {
   if (_reader.getCurrentKmerID(false) != 1) {
 #ifdef DEBUG
     size_t lcp =
 #endif
       _lcp_stats.LCP(_prev_transformed_kmer, transformed_kmer, _transformer->kmer_length, _transformer->prefix_length);
-    DEBUG_MSG("LCP between previous encoded k-mer and '" << kmer << "' is " << lcp);
+    DEBUG_MSG("LCP between previous encoded k-mer and current one is " << lcp);
   }
   _prev_transformed_kmer = transformed_kmer;
 }
 
+void BhKmerCollector::_process(string &kmer) {
+  DEBUG_MSG("Computing encoded k-mer for '" << kmer << " for LCP statistics");
+  _updateLcpStats((*_transformer)(kmer));
+}
+
+void BhKmerCollector::_process(uint64_t &kmer) {
+  DEBUG_MSG("Computing encoded k-mer for packed k-mer " << kmer << " for LCP statistics");
+  _updateLcpStats(_static_transformer(kmer));
+}
+
 LcpStats BhKmerCollector::getLcpStats(bool reset) {
   LcpStats stats = _lcp_stats;
   stats.stop();
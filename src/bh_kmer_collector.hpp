@@ -50,6 +50,7 @@
 #include <kmer_collector.hpp>
 #include <lcp_stats.hpp>
 #include <settings.hpp>
+#include <static_transformer.hpp>
 
 namespace bijecthash {
 
@@ -75,21 +76,40 @@ namespace bijecthash {
      */
     std::shared_ptr<const Transformer> _transformer;
 
+    /**
+     * The statically dispatched encoder of the packed k-mers (using
+     * the k-mer transformer).
+     */
+    StaticTransformer _static_transformer;
+
     /**
      * The previously encoded k-mer (needed to computing the LCP statistics)
      */
     Transformer::EncodedKmer _prev_transformed_kmer;
 
     /**
-     * Perform some processing on the given k-mer before enqueuing it.
+     * Update the LCP statistics using the given transformed k-mer and
+     * the previous one.
      *
-     * By default, this does nothing but any derived class can
-     * override this method.
+     * \param transformed_kmer The transformed current k-mer.
+     */
+    void _updateLcpStats(const Transformer::EncodedKmer &transformed_kmer);
+
+    /**
+     * Compute the LCP statistics of the given k-mer before enqueuing it.
      *
      * \param kmer The k-mer to process before enqueuing it.
      */
     virtual void _process(std::string &kmer) override;
 
+    /**
+     * Compute the LCP statistics of the given packed k-mer before
+     * enqueuing it.
+     *
+     * \param kmer The packed k-mer to process before enqueuing it.
+     */
+    virtual void _process(uint64_t &kmer) override;
+
   public:
 
     /**
@@ -99,9 +119,16 @@ namespace bijecthash {
      *
      * \param filename The name of the file to parse (see open() method).
      *
-     * \param queue The queue to feed with k-mers.
+     * \param queue The queue to feed with blocks of k-mers.
+     *
+     * \param first_byte The offset of the first byte of the range of
+     * the file to parse (see MappedFileReader::open()).
+     *
+     * \param last_byte The offset of the byte after the range of the
+     * file to parse (see MappedFileReader::open()).
      */
-    BhKmerCollector(const Settings &s, const std::string &filename, CircularQueue<std::string> &queue);
+    BhKmerCollector(const Settings &s, const std::string &filename, CircularQueue<KmerBlock> &queue,
+                    size_t first_byte = 0, size_t last_byte = size_t(-1));
 
     /**
      * Return the longest common prefix statistics between consecutive
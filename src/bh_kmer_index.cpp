@@ -47,7 +47,15 @@
 #include "exception.hpp"
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
 #include <iostream>
+#include <numeric>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -60,7 +68,7 @@ BEGIN_BIJECTHASH_NAMESPACE
 BhKmerIndex::Subindex &BhKmerIndex::Subindex::operator=(const BhKmerIndex::Subindex &subindex) {
   if (this != &subindex) {
     _rw_lock.requestWriteAccess();
-    base_t::operator=(subindex);
+    _values = subindex._values;
     _rw_lock.releaseWriteAccess();
   }
   return *this;
@@ -68,20 +76,42 @@ BhKmerIndex::Subindex &BhKmerIndex::Subindex::operator=(const BhKmerIndex::Subin
 
 size_t BhKmerIndex::Subindex::size() const {
   _rw_lock.requestReadAccess();
-  size_t s = base_t::size();
+  size_t s = (_values.index()
+              ? std::get<hash_set_t>(_values).size()
+              : std::get<ordered_set_t>(_values).size());
   _rw_lock.releaseReadAccess();
   return s;
 }
 
 bool BhKmerIndex::Subindex::insert(const value_type& value) {
   DEBUG_MSG(" suffix value is " << value << " for subindex at " << this << "." << '\n'
-            << MSG_DBG_HEADER <<  "The subindex size was " /*<< base_t::size()*/);
+            << MSG_DBG_HEADER <<  "The subindex size was " /*<< size()*/);
   _rw_lock.requestWriteAccess();
-  pair<base_t::iterator, bool> res = set<uint64_t>::insert(value);
+  bool res = _insert(value);
   DEBUG_MSG("(" << value << "):" << this << "." << '\n'
-            <<  MSG_DBG_HEADER << "Now, subindex size is " << base_t::size());
+            <<  MSG_DBG_HEADER << "Now, subindex size is "
+            << (_values.index()
+                ? std::get<hash_set_t>(_values).size()
+                : std::get<ordered_set_t>(_values).size()));
+  _rw_lock.releaseWriteAccess();
+  return res;
+}
+
+bool BhKmerIndex::Subindex::contains(const value_type& value) const {
+  _rw_lock.requestReadAccess();
+  bool res = _contains(value);
+  _rw_lock.releaseReadAccess();
+  return res;
+}
+
+void BhKmerIndex::Subindex::clear() {
+  _rw_lock.requestWriteAccess();
+  if (_values.index()) {
+    std::get<hash_set_t>(_values).clear();
+  } else {
+    std::get<ordered_set_t>(_values).clear();
+  }
   _rw_lock.releaseWriteAccess();
-  return res.second;
 }
 
 
@@ -89,10 +119,80 @@ bool BhKmerIndex::Subindex::insert(const value_type& value) {
 // BhKmerIndex //
 /////////////////
 
+const char BhKmerIndex::file_magic[8] = { 'B', 'H', 'I', 'N', 'D', 'E', 'X', '\0' };
+
+const uint32_t BhKmerIndex::file_version = 1;
+
+/**
+ * The byte order mark of the index files.
+ */
+static const uint32_t _file_byte_order = 0x01020304;
+
+/**
+ * The header of the index files.
+ */
+struct _IndexFileHeader {
+  char magic[8];               /**< The magic number (see BhKmerIndex::file_magic) */
+  uint32_t version;            /**< The file format version (see BhKmerIndex::file_version) */
+  uint32_t byte_order;         /**< The byte order mark (see _file_byte_order) */
+  uint64_t kmer_length;        /**< The k-mer length */
+  uint64_t prefix_length;      /**< The k-mer prefix length */
+  uint64_t nb_kmers;           /**< The number of indexed k-mers */
+  uint64_t method_length;      /**< The length of the transformer method */
+  uint64_t description_length; /**< The length of the transformer description */
+};
+
+static_assert(sizeof(_IndexFileHeader) == 56, "Unexpected index file header size");
+
+/**
+ * Round the given size to the next multiple of 8.
+ *
+ * \param n The size to round.
+ *
+ * \return Returns the smallest multiple of 8 greater than or equal to n.
+ */
+static inline size_t _pad8(size_t n) {
+  return (n + 7) & ~size_t(7);
+}
+
+/**
+ * Check the given index file header.
+ *
+ * \param header The header to check.
+ *
+ * \param filename The index file name (for error messages).
+ */
+static void _checkHeader(const _IndexFileHeader &header, const string &filename) {
+  if (memcmp(header.magic, BhKmerIndex::file_magic, sizeof(header.magic))) {
+    Exception e;
+    e << "Error: The file '" << filename << "' is not a k-mer index file.\n";
+    throw e;
+  }
+  if (header.byte_order != _file_byte_order) {
+    Exception e;
+    e << "Error: The k-mer index file '" << filename << "' was created on a machine having a different byte order.\n";
+    throw e;
+  }
+  if (header.version != BhKmerIndex::file_version) {
+    Exception e;
+    e << "Error: The k-mer index file '" << filename << "' uses format version " << header.version
+      << " but only version " << BhKmerIndex::file_version << " is supported.\n";
+    throw e;
+  }
+  if ((header.prefix_length == 0) || (header.prefix_length > 13) || (header.prefix_length >= header.kmer_length)) {
+    Exception e;
+    e << "Error: The k-mer index file '" << filename << "' is corrupted (invalid k-mer and prefix lengths).\n";
+    throw e;
+  }
+}
+
 BhKmerIndex::BhKmerIndex(const Settings &s):
   _rw_lock(),
-  _subindexes(1ul << (2 * s.prefix_length)),
-  _size(0), _transformer(s.transformer()),
+  _subindexes(1ul << (2 * s.prefix_length), Subindex(s.index_backend)),
+  _size(0), _transformer(s.transformer()), _static_transformer(_transformer),
+  _frozen_offsets(NULL), _frozen_suffixes(NULL),
+  _frozen_offsets_data(), _frozen_suffixes_data(),
+  _mapping(NULL), _mapping_size(0),
   settings(s)
 {
   DEBUG_MSG("Creation of " << _subindexes.size() << " subindexes "
@@ -107,17 +207,43 @@ BhKmerIndex::BhKmerIndex(const Settings &s):
   DEBUG_MSG("Transformer is " << _transformer->description << "_{" << _transformer->kmer_length << " = " << _transformer->prefix_length << " + " << _transformer->suffix_length << "}");
 }
 
+BhKmerIndex::BhKmerIndex(const Settings &s, const string &filename):
+  _rw_lock(),
+  _subindexes(),
+  _size(0), _transformer(s.transformer()), _static_transformer(_transformer),
+  _frozen_offsets(NULL), _frozen_suffixes(NULL),
+  _frozen_offsets_data(), _frozen_suffixes_data(),
+  _mapping(NULL), _mapping_size(0),
+  settings(s)
+{
+  if (!_transformer) {
+    Exception e;
+    e << "Error: Unable to find valid transformer for settings:\n"
+      << s << "\n";
+    throw e;
+  }
+  _mapFile(filename);
+  DEBUG_MSG("Index " << this << " loaded from '" << filename << "' with " << _size << " k-mers");
+}
+
 BhKmerIndex::BhKmerIndex(const BhKmerIndex &index):
   _rw_lock(),
-  _subindexes(index.size()),
+  _subindexes(),
   _size(index._size.load()),
   _transformer(index._transformer),
+  _static_transformer(index._static_transformer),
+  _frozen_offsets(NULL), _frozen_suffixes(NULL),
+  _frozen_offsets_data(), _frozen_suffixes_data(),
+  _mapping(NULL), _mapping_size(0),
   settings(index.settings)
 {
   DEBUG_MSG("Copying existing index having " << _size
             << " elements in this new index (" << this << ")");
   index._rw_lock.requestReadAccess();
   _subindexes = index._subindexes;
+  if (index.frozen()) {
+    _copyFrozenData(index);
+  }
   index._rw_lock.releaseReadAccess();
 }
 
@@ -128,14 +254,253 @@ BhKmerIndex &BhKmerIndex::operator=(const BhKmerIndex &index) {
     index._rw_lock.requestReadAccess();
     _rw_lock.requestWriteAccess();
     _subindexes = index._subindexes;
-    _size.store(index._size.load());
     *(const_cast<shared_ptr<const Transformer> *>(&_transformer)) = index._transformer;
+    _static_transformer = index._static_transformer;
+    _releaseFrozenData();
+    if (index.frozen()) {
+      _copyFrozenData(index);
+    }
+    _size.store(index._size.load());
     _rw_lock.releaseWriteAccess();
     index._rw_lock.releaseReadAccess();
   }
   return *this;
 }
 
+BhKmerIndex::~BhKmerIndex() {
+  _releaseFrozenData();
+}
+
+void BhKmerIndex::_copyFrozenData(const BhKmerIndex &index) {
+  assert(index.frozen());
+  assert(!frozen());
+  _frozen_offsets_data.assign(index._frozen_offsets, index._frozen_offsets + index._nbSubindexes() + 1);
+  _frozen_suffixes_data.assign(index._frozen_suffixes, index._frozen_suffixes + index.size());
+  _frozen_offsets = _frozen_offsets_data.data();
+  _frozen_suffixes = _frozen_suffixes_data.data();
+}
+
+void BhKmerIndex::_releaseFrozenData() {
+  if (_mapping) {
+    munmap(_mapping, _mapping_size);
+    _mapping = NULL;
+    _mapping_size = 0;
+  }
+  vector<uint64_t>().swap(_frozen_offsets_data);
+  vector<uint64_t>().swap(_frozen_suffixes_data);
+  _frozen_offsets = NULL;
+  _frozen_suffixes = NULL;
+}
+
+void BhKmerIndex::_mapFile(const string &filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    Exception e;
+    e << "Error: Unable to open the k-mer index file '" << filename << "': " << strerror(errno) << ".\n";
+    throw e;
+  }
+  struct stat st;
+  if (fstat(fd, &st) || (size_t(st.st_size) < sizeof(_IndexFileHeader))) {
+    close(fd);
+    Exception e;
+    e << "Error: The file '" << filename << "' is not a k-mer index file.\n";
+    throw e;
+  }
+  _mapping_size = st.st_size;
+  _mapping = mmap(NULL, _mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (_mapping == MAP_FAILED) {
+    _mapping = NULL;
+    _mapping_size = 0;
+    Exception e;
+    e << "Error: Unable to map the k-mer index file '" << filename << "': " << strerror(errno) << ".\n";
+    throw e;
+  }
+
+  try {
+    const char *data = static_cast<const char *>(_mapping);
+    const _IndexFileHeader &header = *reinterpret_cast<const _IndexFileHeader *>(data);
+    _checkHeader(header, filename);
+    const size_t nb_subindexes = 1ul << (2 * header.prefix_length);
+    // Each length is bounded by the file size, thus the expected size
+    // can't overflow.
+    if ((header.method_length > _mapping_size) || (header.description_length > _mapping_size)
+        || (header.nb_kmers > _mapping_size / sizeof(uint64_t))) {
+      Exception e;
+      e << "Error: The k-mer index file '" << filename << "' is corrupted (invalid header lengths).\n";
+      throw e;
+    }
+    const size_t strings_size = _pad8(header.method_length + header.description_length);
+    const size_t expected_size = (sizeof(_IndexFileHeader) + strings_size
+                                  + (nb_subindexes + 1 + header.nb_kmers) * sizeof(uint64_t));
+    if (_mapping_size != expected_size) {
+      Exception e;
+      e << "Error: The k-mer index file '" << filename << "' is corrupted "
+        << "(" << _mapping_size << " bytes instead of " << expected_size << ").\n";
+      throw e;
+    }
+    const string description(data + sizeof(_IndexFileHeader) + header.method_length, header.description_length);
+    if ((header.kmer_length != _transformer->kmer_length)
+        || (header.prefix_length != _transformer->prefix_length)
+        || (description != _transformer->description)) {
+      Exception e;
+      e << "Error: The k-mer index file '" << filename << "' was built using "
+        << "k = " << header.kmer_length << ", "
+        << "k1 = " << header.prefix_length << " and "
+        << "transformer " << description << " instead of "
+        << "k = " << _transformer->kmer_length << ", "
+        << "k1 = " << _transformer->prefix_length << " and "
+        << "transformer " << _transformer->description << ".\n";
+      throw e;
+    }
+    const uint64_t *offsets = reinterpret_cast<const uint64_t *>(data + sizeof(_IndexFileHeader) + strings_size);
+    // The sub-index bounds are used without any further check.
+    bool valid_offsets = (offsets[0] == 0) && (offsets[nb_subindexes] == header.nb_kmers);
+    for (size_t i = 0; valid_offsets && (i < nb_subindexes); ++i) {
+      valid_offsets = (offsets[i] <= offsets[i + 1]);
+    }
+    if (!valid_offsets) {
+      Exception e;
+      e << "Error: The k-mer index file '" << filename << "' is corrupted (invalid sub-index offsets).\n";
+      throw e;
+    }
+    _frozen_offsets = offsets;
+    _frozen_suffixes = _frozen_offsets + nb_subindexes + 1;
+    _size = header.nb_kmers;
+  } catch (...) {
+    _releaseFrozenData();
+    throw;
+  }
+}
+
+Settings BhKmerIndex::readSettings(const string &filename, bool verbose) {
+  ifstream ifs(filename, ios::binary);
+  _IndexFileHeader header;
+  if (!ifs.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    Exception e;
+    e << "Error: Unable to read the k-mer index file '" << filename << "'.\n";
+    throw e;
+  }
+  _checkHeader(header, filename);
+  string method(header.method_length, '\0');
+  if (!ifs.read(&method[0], header.method_length)) {
+    Exception e;
+    e << "Error: The k-mer index file '" << filename << "' is corrupted (truncated transformer method).\n";
+    throw e;
+  }
+  Settings s(header.kmer_length, header.prefix_length, method, filename);
+  s.verbose = verbose;
+  s.freeze_index = true;
+  if (!s.setMethod(method)) {
+    Exception e;
+    e << "Error: Unable to build the transformer '" << method << "' of the k-mer index file '" << filename << "'.\n";
+    throw e;
+  }
+  return s;
+}
+
+void BhKmerIndex::save(const string &filename) const {
+  if (!frozen()) {
+    Exception e;
+    e << "Error: Only frozen k-mer indexes can be saved.\n";
+    throw e;
+  }
+  const string method = _transformer->getMethod();
+  if (method.empty()) {
+    Exception e;
+    e << "Error: Unable to save an index whose transformer (" << _transformer->description << ") can't be rebuilt.\n";
+    throw e;
+  }
+  _IndexFileHeader header;
+  memcpy(header.magic, file_magic, sizeof(header.magic));
+  header.version = file_version;
+  header.byte_order = _file_byte_order;
+  header.kmer_length = _transformer->kmer_length;
+  header.prefix_length = _transformer->prefix_length;
+  header.nb_kmers = size();
+  header.method_length = method.size();
+  header.description_length = _transformer->description.size();
+  const size_t nb_subindexes = _nbSubindexes();
+  const size_t strings_size = header.method_length + header.description_length;
+  const string padding(_pad8(strings_size) - strings_size, '\0');
+
+  DEBUG_MSG("Saving index " << this << " in '" << filename << "'");
+  ofstream ofs(filename, ios::binary | ios::trunc);
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  ofs.write(method.data(), method.size());
+  ofs.write(_transformer->description.data(), _transformer->description.size());
+  ofs.write(padding.data(), padding.size());
+  ofs.write(reinterpret_cast<const char *>(_frozen_offsets), (nb_subindexes + 1) * sizeof(uint64_t));
+  ofs.write(reinterpret_cast<const char *>(_frozen_suffixes), size() * sizeof(uint64_t));
+  ofs.close();
+  if (!ofs) {
+    Exception e;
+    e << "Error: Unable to write the k-mer index file '" << filename << "'.\n";
+    throw e;
+  }
+}
+
+void BhKmerIndex::freeze() {
+  _rw_lock.requestWriteAccess();
+  if (!frozen()) {
+    DEBUG_MSG("Freezing index " << this << " having " << _size << " k-mers");
+    _frozen_offsets_data.reserve(_subindexes.size() + 1);
+    _frozen_suffixes_data.reserve(_size);
+    _frozen_offsets_data.push_back(0);
+    for (auto &subindex: _subindexes) {
+      const size_t start = _frozen_suffixes_data.size();
+      subindex.forEach([this](uint64_t v) {
+                         _frozen_suffixes_data.push_back(v);
+                       });
+      // Release the memory as soon as possible to lower the peak usage.
+      subindex.clear();
+      sort(_frozen_suffixes_data.begin() + start, _frozen_suffixes_data.end());
+      _frozen_offsets_data.push_back(_frozen_suffixes_data.size());
+    }
+    assert(_frozen_suffixes_data.size() == _size);
+    vector<Subindex>().swap(_subindexes);
+    _frozen_offsets = _frozen_offsets_data.data();
+    _frozen_suffixes = _frozen_suffixes_data.data();
+  }
+  _rw_lock.releaseWriteAccess();
+}
+
+bool BhKmerIndex::_insert(const Transformer::EncodedKmer &encoded) {
+  if (frozen()) {
+    Exception e;
+    e << "Error: Unable to insert some k-mer in a frozen index.\n";
+    throw e;
+  }
+  bool res = _subindexes[encoded.prefix].insert(encoded.suffix);
+  if (res) {
+    ++_size;
+  }
+  return res;
+}
+
+size_t BhKmerIndex::insertExclusive(const vector<Transformer::EncodedKmer> &kmers) {
+  if (frozen()) {
+    Exception e;
+    e << "Error: Unable to insert some k-mer in a frozen index.\n";
+    throw e;
+  }
+  size_t nb = 0;
+  for (const Transformer::EncodedKmer &encoded: kmers) {
+    nb += _subindexes[encoded.prefix]._insert(encoded.suffix);
+  }
+  _size += nb;
+  return nb;
+}
+
+bool BhKmerIndex::_contains(const Transformer::EncodedKmer &encoded) const {
+  if (frozen()) {
+    return binary_search(_frozen_suffixes + _frozen_offsets[encoded.prefix],
+                         _frozen_suffixes + _frozen_offsets[encoded.prefix + 1],
+                         encoded.suffix);
+  }
+  return _subindexes[encoded.prefix].contains(encoded.suffix);
+}
+
 bool BhKmerIndex::insert(const string &kmer) {
   Transformer::EncodedKmer encoded = (*_transformer)(kmer);
 #if defined(DEBUG) || not(defined(NDEBUG))
@@ -144,11 +509,103 @@ bool BhKmerIndex::insert(const string &kmer) {
             << MSG_DBG_HEADER << "decoded kmer:  '" << decoded << "'");
   assert(decoded == kmer);
 #endif
-  bool res = _subindexes[encoded.prefix].insert(encoded.suffix);
-  if (res) {
-    ++_size;
+  return _insert(encoded);
+}
+
+bool BhKmerIndex::insert(uint64_t kmer) {
+  Transformer::EncodedKmer encoded = _static_transformer(kmer);
+#if defined(DEBUG) || not(defined(NDEBUG))
+  string original = Transformer::decode(kmer, _transformer->kmer_length);
+  string decoded = (*_transformer)(encoded);
+  DEBUG_MSG("original kmer: '" << original << "'" << '\n'
+            << MSG_DBG_HEADER << "decoded kmer:  '" << decoded << "'");
+  assert(decoded == original);
+#endif
+  return _insert(encoded);
+}
+
+size_t BhKmerIndex::insert(const vector<Transformer::EncodedKmer> &kmers) {
+  size_t nb = 0;
+  for (const Transformer::EncodedKmer &encoded: kmers) {
+#if defined(DEBUG) || not(defined(NDEBUG))
+    // The original k-mer is not known here, but encoding the decoded
+    // k-mer must give back the same code.
+    string decoded = (*_transformer)(encoded);
+    Transformer::EncodedKmer reencoded = (*_transformer)(decoded);
+    DEBUG_MSG("decoded kmer: '" << decoded << "'");
+    assert((reencoded.prefix == encoded.prefix) && (reencoded.suffix == encoded.suffix));
+#endif
+    nb += _insert(encoded);
   }
-  return res;
+  return nb;
+}
+
+bool BhKmerIndex::contains(const string &kmer) const {
+  return _contains((*_transformer)(kmer));
+}
+
+bool BhKmerIndex::contains(uint64_t kmer) const {
+  return _contains(_static_transformer(kmer));
+}
+
+size_t BhKmerIndex::_containsMany(const vector<Transformer::EncodedKmer> &encoded, vector<bool> &results) const {
+  const size_t n = encoded.size();
+  results.assign(n, false);
+  vector<size_t> order(n);
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(),
+       [&encoded](size_t a, size_t b) {
+         return ((encoded[a].prefix < encoded[b].prefix)
+                 || ((encoded[a].prefix == encoded[b].prefix)
+                     && (encoded[a].suffix < encoded[b].suffix)));
+       });
+  size_t nb = 0;
+  size_t i = 0;
+  while (i < n) {
+    const uint64_t prefix = encoded[order[i]].prefix;
+    size_t j = i + 1;
+    while ((j < n) && (encoded[order[j]].prefix == prefix)) {
+      ++j;
+    }
+    DEBUG_MSG("Looking for " << (j - i) << " k-mers having prefix " << prefix);
+    if (frozen()) {
+      const uint64_t *first = _frozen_suffixes + _frozen_offsets[prefix];
+      const uint64_t *last = _frozen_suffixes + _frozen_offsets[prefix + 1];
+      for (; i < j; ++i) {
+        // Since queries are sorted, the search range can only shrink.
+        const uint64_t suffix = encoded[order[i]].suffix;
+        first = lower_bound(first, last, suffix);
+        const bool found = ((first != last) && (*first == suffix));
+        results[order[i]] = found;
+        nb += found;
+      }
+    } else {
+      const Subindex &subindex = _subindexes[prefix];
+      subindex._rw_lock.requestReadAccess();
+      for (; i < j; ++i) {
+        const bool found = subindex._contains(encoded[order[i]].suffix);
+        results[order[i]] = found;
+        nb += found;
+      }
+      subindex._rw_lock.releaseReadAccess();
+    }
+  }
+  return nb;
+}
+
+size_t BhKmerIndex::containsMany(const vector<string> &kmers, vector<bool> &results) const {
+  vector<Transformer::EncodedKmer> encoded;
+  encoded.reserve(kmers.size());
+  for (const string &kmer: kmers) {
+    encoded.push_back((*_transformer)(kmer));
+  }
+  return _containsMany(encoded, results);
+}
+
+size_t BhKmerIndex::containsMany(const vector<uint64_t> &kmers, vector<bool> &results) const {
+  vector<Transformer::EncodedKmer> encoded(kmers.size());
+  _static_transformer.transformBatch(kmers.data(), kmers.size(), encoded.data());
+  return _containsMany(encoded, results);
 }
 
 static string fmt(string w, size_t i, size_t max) {
@@ -168,7 +625,7 @@ map<string, double> BhKmerIndex::statistics() const {
   _rw_lock.requestReadAccess();
 
   vector<size_t> sizes;
-  size_t n = _subindexes.size();
+  size_t n = _nbSubindexes();
   sizes.reserve(n);
   size_t nb_bins = settings.nb_bins;
   if (nb_bins > n) {
@@ -179,10 +636,11 @@ map<string, double> BhKmerIndex::statistics() const {
   double mean = 0;
   double variance = 0;
 
-  for (const auto &s: _subindexes) {
-    sizes.push_back(s.size());
-    mean += s.size();
-    variance += s.size() * s.size();
+  for (uint64_t prefix = 0; prefix < n; ++prefix) {
+    const size_t s = _subindexSize(prefix);
+    sizes.push_back(s);
+    mean += s;
+    variance += s * s;
   }
   assert(mean == _size);
   _rw_lock.releaseReadAccess();
@@ -220,16 +678,23 @@ map<string, double> BhKmerIndex::statistics() const {
 void BhKmerIndex::toStream(ostream &os) const {
   _rw_lock.requestReadAccess();
   size_t n = size();
-  size_t nb = _subindexes.size();
+  size_t nb = _nbSubindexes();
   os << "Index (" << n << " k-mers in " << nb << " subindexes using transformer " << _transformer->description << "):\n";
   Transformer::EncodedKmer encoded;
   for (encoded.prefix = 0; encoded.prefix < nb; ++encoded.prefix) {
-    _subindexes[encoded.prefix]._rw_lock.requestReadAccess();
-    for (const auto &e: _subindexes[encoded.prefix]) {
-      encoded.suffix = e;
-      os << "- '" << (*_transformer)(encoded) << "'\n";
+    if (frozen()) {
+      for (size_t i = _frozen_offsets[encoded.prefix]; i < _frozen_offsets[encoded.prefix + 1]; ++i) {
+        encoded.suffix = _frozen_suffixes[i];
+        os << "- '" << (*_transformer)(encoded) << "'\n";
+      }
+    } else {
+      _subindexes[encoded.prefix]._rw_lock.requestReadAccess();
+      _subindexes[encoded.prefix].forEach([&](uint64_t e) {
+                                            encoded.suffix = e;
+                                            os << "- '" << (*_transformer)(encoded) << "'\n";
+                                          });
+      _subindexes[encoded.prefix]._rw_lock.releaseReadAccess();
     }
-    _subindexes[encoded.prefix]._rw_lock.releaseReadAccess();
   }
   _rw_lock.releaseReadAccess();
 }
@@ -52,10 +52,13 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <variant>
 #include <vector>
 
 #include <locker.hpp>
 #include <settings.hpp>
+#include <static_transformer.hpp>
+#include <suffix_hash_set.hpp>
 #include <transformer.hpp>
 
 namespace bijecthash {
@@ -66,6 +69,13 @@ namespace bijecthash {
    * thread-safety (and to forbid other methods for the sake of
    * simplicity).
    *
+   * The sets are either std::set or SuffixHashSet instances, depending
+   * on the index backend given in the settings.
+   *
+   * Once all the k-mers are inserted, the index can be frozen (see
+   * freeze()), then all the sets are replaced by a single compact
+   * array of sorted suffixes.
+   *
    * The k-mer index is currently represented by \f$4^{k_1}\f$ sets of
    * unsigned integers that belongs to \f$[k - k_1[\f$, with \f$1 \leq
    * k_1 < k\f$.
@@ -79,7 +89,24 @@ namespace bijecthash {
     /**
      * A k-mer index sub-index is simply a set of 64 bits integers.
      */
-    class Subindex: private std::set<uint64_t> {
+    class Subindex {
+
+    public:
+
+      /**
+       * The type of stored values.
+       */
+      typedef uint64_t value_type;
+
+      /**
+       * The ordered set type alias (Settings::ORDERED_SET backend).
+       */
+      typedef std::set<value_type> ordered_set_t;
+
+      /**
+       * The hash set type alias (Settings::HASH_SET backend).
+       */
+      typedef SuffixHashSet hash_set_t;
 
     private:
 
@@ -89,21 +116,56 @@ namespace bijecthash {
       mutable ReadWriteLock _rw_lock;
 
       /**
-       * The BhKmerIndex class needs to access the _rw_lock.
+       * The set of values (depending on the index backend).
        */
-      friend BhKmerIndex;
+      std::variant<ordered_set_t, hash_set_t> _values;
 
-    public:
+      /**
+       * Check whether the given value belongs to this sub-index
+       * without acquiring the reader-writer lock.
+       *
+       * \param value The value to look for.
+       *
+       * \return Returns true if the value is in this sub-index and
+       * false otherwise.
+       */
+      inline bool _contains(const value_type& value) const {
+        return (_values.index()
+                ? std::get<hash_set_t>(_values).contains(value)
+                : std::get<ordered_set_t>(_values).count(value));
+      }
 
       /**
-       * The base type alias.
+       * Inserts the given value in this sub-index if not already
+       * present without acquiring the reader-writer lock.
+       *
+       * \param value The value to insert.
+       *
+       * \return Returns true if the value was inserted and false if it
+       * was already present in this sub-index.
        */
-      typedef std::set<uint64_t> base_t;
+      inline bool _insert(const value_type& value) {
+        return (_values.index()
+                ? std::get<hash_set_t>(_values).insert(value)
+                : std::get<ordered_set_t>(_values).insert(value).second);
+      }
+
+      /**
+       * The BhKmerIndex class needs to access the _rw_lock.
+       */
+      friend BhKmerIndex;
+
+    public:
 
       /**
        * Builds an empty sub-index.
+       *
+       * \param backend The backend used to store the values.
        */
-      inline Subindex(): base_t(), _rw_lock() {
+      inline Subindex(Settings::IndexBackend backend = Settings::HASH_SET): _rw_lock(), _values() {
+        if (backend == Settings::HASH_SET) {
+          _values.emplace<hash_set_t>();
+        }
       }
 
       /**
@@ -114,7 +176,7 @@ namespace bijecthash {
        * \param subindex The sub-index to copy.
        */
       inline Subindex(const Subindex &subindex):
-        base_t(subindex), _rw_lock() {
+        _rw_lock(), _values(subindex._values) {
       }
 
       /**
@@ -153,6 +215,41 @@ namespace bijecthash {
        */
       bool insert(const value_type& value);
 
+      /**
+       * Check whether the given value belongs to this sub-index.
+       *
+       * \param value The value to look for.
+       *
+       * \return Returns true if the value is in this sub-index and
+       * false otherwise.
+       */
+      bool contains(const value_type& value) const;
+
+      /**
+       * Remove all the values of this sub-index (and release its
+       * memory).
+       */
+      void clear();
+
+      /**
+       * Apply the given function to each value of this sub-index
+       * (values are in increasing order only for the
+       * Settings::ORDERED_SET backend).
+       *
+       * Notice that the reader-writer lock of this sub-index is not
+       * acquired by this method.
+       *
+       * \param f The function to apply on each value.
+       */
+      template <typename Function>
+      inline void forEach(Function f) const {
+        std::visit([&f](const auto &values) {
+                     for (const value_type &v: values) {
+                       f(v);
+                     }
+                   }, _values);
+      }
+
     };
 
     /**
@@ -175,6 +272,136 @@ namespace bijecthash {
      */
     const std::shared_ptr<const Transformer> _transformer;
 
+    /**
+     * The statically dispatched encoder of the packed k-mers (using
+     * the transformer of this index).
+     */
+    StaticTransformer _static_transformer;
+
+    /**
+     * The offsets of the frozen sub-indexes (NULL unless this index
+     * is frozen).
+     *
+     * The suffixes of the sub-index associated to prefix \f$p\f$ are
+     * stored in increasing order in _frozen_suffixes from position
+     * _frozen_offsets[p] (included) to position _frozen_offsets[p + 1]
+     * (excluded).
+     *
+     * This points either to the _frozen_offsets_data vector or to the
+     * mapped index file.
+     */
+    const uint64_t *_frozen_offsets;
+
+    /**
+     * The suffixes of the frozen sub-indexes (see _frozen_offsets).
+     */
+    const uint64_t *_frozen_suffixes;
+
+    /**
+     * The storage of the frozen sub-indexes offsets (unless the index
+     * is mapped from some file).
+     */
+    std::vector<uint64_t> _frozen_offsets_data;
+
+    /**
+     * The storage of the frozen sub-indexes suffixes (unless the index
+     * is mapped from some file).
+     */
+    std::vector<uint64_t> _frozen_suffixes_data;
+
+    /**
+     * The address of the mapped index file (NULL if no file is
+     * mapped).
+     */
+    void *_mapping;
+
+    /**
+     * The size of the mapped index file.
+     */
+    size_t _mapping_size;
+
+    /**
+     * Get the number of sub-indexes.
+     *
+     * \return Returns \f$4^{k_1}\f$.
+     */
+    inline size_t _nbSubindexes() const {
+      return 1ul << (2 * _transformer->prefix_length);
+    }
+
+    /**
+     * Copy the frozen sub-indexes of the given index (which must be
+     * frozen) into the storage of this index.
+     *
+     * \param index The frozen index to copy.
+     */
+    void _copyFrozenData(const BhKmerIndex &index);
+
+    /**
+     * Release the frozen sub-indexes of this index (either stored or
+     * mapped).
+     */
+    void _releaseFrozenData();
+
+    /**
+     * Map the given index file and use it as the frozen sub-indexes.
+     *
+     * The given file must have been created by the save() method with
+     * the same \f$k\f$, \f$k_1\f$ and transformer description as this
+     * index, otherwise an Exception is thrown.
+     *
+     * \param filename The name of the index file to map.
+     */
+    void _mapFile(const std::string &filename);
+
+    /**
+     * Get the number of suffixes associated to some prefix.
+     *
+     * \param prefix The prefix of the sub-index.
+     *
+     * \return Returns the size of the sub-index associated to the
+     * given prefix (either frozen or not).
+     */
+    inline size_t _subindexSize(uint64_t prefix) const {
+      return (frozen()
+              ? _frozen_offsets[prefix + 1] - _frozen_offsets[prefix]
+              : _subindexes[prefix].size());
+    }
+
+    /**
+     * Inserts the given encoded k-mer in this index if not already
+     * present.
+     *
+     * \param encoded The encoded k-mer to insert.
+     *
+     * \return Returns true if the k-mer was inserted and false if it
+     * was already present in this index.
+     */
+    bool _insert(const Transformer::EncodedKmer &encoded);
+
+    /**
+     * Check whether the given encoded k-mer belongs to this index.
+     *
+     * \param encoded The encoded k-mer to look for.
+     *
+     * \return Returns true if the k-mer is in this index and false
+     * otherwise.
+     */
+    bool _contains(const Transformer::EncodedKmer &encoded) const;
+
+    /**
+     * Check whether each of the given encoded k-mers belongs to this
+     * index (see containsMany()).
+     *
+     * \param encoded The encoded k-mers to look for.
+     *
+     * \param results The vector to set such that results[i] is true
+     * if and only if the i-th k-mer is in this index.
+     *
+     * \return Returns the number of k-mers found in this index.
+     */
+    size_t _containsMany(const std::vector<Transformer::EncodedKmer> &encoded, std::vector<bool> &results) const;
+
   public:
 
     /**
@@ -189,6 +416,20 @@ namespace bijecthash {
      */
     BhKmerIndex(const Settings &s);
 
+    /**
+     * Loads a frozen index from the given file (see save()).
+     *
+     * The file is mapped in memory, thus loading is done in constant
+     * time and the k-mers are read from the file only when needed.
+     *
+     * \param s The settings to use for this index (see
+     * readSettings()), which must correspond to the ones used to build
+     * the saved index, otherwise an Exception is thrown.
+     *
+     * \param filename The name of the index file to load.
+     */
+    BhKmerIndex(const Settings &s, const std::string &filename);
+
     /**
      * Creates an index by copying the given index.
      *
@@ -207,6 +448,39 @@ namespace bijecthash {
      */
     BhKmerIndex &operator=(const BhKmerIndex &index);
 
+    /**
+     * Destructor (unmaps the loaded file if any).
+     */
+    ~BhKmerIndex();
+
+    /**
+     * The magic number starting the index files.
+     */
+    static const char file_magic[8];
+
+    /**
+     * The current version of the index file format.
+     */
+    static const uint32_t file_version;
+
+    /**
+     * Read the settings stored in the given index file (see save()).
+     *
+     * The transformer method stored in the file is loaded, thus the
+     * plugins providing it must be available. An Exception is thrown
+     * if the file is not a valid index file or if its transformer
+     * can't be built.
+     *
+     * \param filename The name of the index file.
+     *
+     * \param verbose The verbosity of the returned settings.
+     *
+     * \return Returns the settings of the saved index (which can be
+     * given to the BhKmerIndex(const Settings &, const std::string &)
+     * constructor).
+     */
+    static Settings readSettings(const std::string &filename, bool verbose = true);
+
     /**
      * Check if index is empty.
      *
@@ -226,9 +500,46 @@ namespace bijecthash {
       return _size.load();
     }
 
+    /**
+     * Check if this index is frozen.
+     *
+     * \return Returns true if this index is frozen (see freeze()) and
+     * false otherwise.
+     */
+    inline bool frozen() const {
+      return _frozen_offsets != NULL;
+    }
+
+    /**
+     * Check if this index is mapped from some file.
+     *
+     * \return Returns true if this index was loaded from some file
+     * (see BhKmerIndex(const Settings &, const std::string &)) and
+     * false otherwise.
+     */
+    inline bool mapped() const {
+      return _mapping != NULL;
+    }
+
+    /**
+     * Freeze this index.
+     *
+     * All the sub-indexes are converted into a compact array of sorted
+     * suffixes (8 bytes per k-mer plus 8 bytes per sub-index) and
+     * their previous representation is released. A frozen index can
+     * be queried (see contains()), iterated and its statistics
+     * computed, but no k-mer can be inserted anymore.
+     *
+     * This must not be called while some k-mers are being inserted.
+     * Freezing an already frozen index has no effect.
+     */
+    void freeze();
+
     /**
      * Inserts the given k-mer in this index if not already present.
      *
+     * Inserting some k-mer in a frozen index throws an Exception.
+     *
      * \param kmer The k-mer to insert.
      *
      * \return Returns true if the k-mer was inserted and false if it
@@ -236,6 +547,132 @@ namespace bijecthash {
      */
     bool insert(const std::string &kmer);
 
+    /**
+     * Inserts the given packed k-mer in this index if not already
+     * present.
+     *
+     * \param kmer The k-mer to insert, encoded using two bits per
+     * nucleotide (only available when \f$k \leq 32\f$, see
+     * Transformer::operator()(uint64_t) const).
+     *
+     * \return Returns true if the k-mer was inserted and false if it
+     * was already present in this index.
+     */
+    bool insert(uint64_t kmer);
+
+    /**
+     * Inserts the given encoded k-mers in this index if not already
+     * present.
+     *
+     * Inserting some k-mer in a frozen index throws an Exception.
+     *
+     * \param kmers The encoded k-mers to insert (see transformer() and
+     * Transformer::transformBatch()).
+     *
+     * \return Returns the number of k-mers that were not already
+     * present in this index.
+     */
+    size_t insert(const std::vector<Transformer::EncodedKmer> &kmers);
+
+    /**
+     * Inserts the given encoded k-mers in this index (if not already
+     * present) without any locking.
+     *
+     * This is only safe if the calling thread is the only one
+     * accessing the sub-indexes associated to the prefixes of the
+     * given encoded k-mers (each sub-index being owned by a single
+     * thread, see Settings::sharded_index).
+     *
+     * Inserting some k-mer in a frozen index throws an Exception.
+     *
+     * \param kmers The encoded k-mers to insert (see transformer()).
+     *
+     * \return Returns the number of k-mers that were not already
+     * present in this index.
+     */
+    size_t insertExclusive(const std::vector<Transformer::EncodedKmer> &kmers);
+
+    /**
+     * Check whether the given k-mer belongs to this index (either
+     * frozen or not).
+     *
+     * \param kmer The k-mer to look for.
+     *
+     * \return Returns true if the k-mer is in this index and false
+     * otherwise.
+     */
+    bool contains(const std::string &kmer) const;
+
+    /**
+     * Check whether the given packed k-mer belongs to this index
+     * (either frozen or not).
+     *
+     * \param kmer The k-mer to look for, encoded using two bits per
+     * nucleotide (only available when \f$k \leq 32\f$, see
+     * Transformer::operator()(uint64_t) const).
+     *
+     * \return Returns true if the k-mer is in this index and false
+     * otherwise.
+     */
+    bool contains(uint64_t kmer) const;
+
+    /**
+     * Check whether each of the given k-mers belongs to this index
+     * (either frozen or not).
+     *
+     * The queries are grouped by prefix and sorted by suffix, thus
+     * each sub-index is probed for all its queries at once (while it
+     * is hot in cache, under a single lock acquisition and, for a
+     * frozen index, with a shrinking search range).
+     *
+     * \param kmers The k-mers to look for.
+     *
+     * \param results The vector to set such that results[i] is true
+     * if and only if kmers[i] is in this index (it is resized if
+     * needed).
+     *
+     * \return Returns the number of k-mers found in this index.
+     */
+    size_t containsMany(const std::vector<std::string> &kmers, std::vector<bool> &results) const;
+
+    /**
+     * Check whether each of the given packed k-mers belongs to this
+     * index (either frozen or not).
+     *
+     * See containsMany(const std::vector<std::string> &, std::vector<bool> &) const.
+     *
+     * \param kmers The k-mers to look for, encoded using two bits per
+     * nucleotide (only available when \f$k \leq 32\f$, see
+     * Transformer::operator()(uint64_t) const).
+     *
+     * \param results The vector to set such that results[i] is true
+     * if and only if kmers[i] is in this index (it is resized if
+     * needed).
+     *
+     * \return Returns the number of k-mers found in this index.
+     */
+    size_t containsMany(const std::vector<uint64_t> &kmers, std::vector<bool> &results) const;
+
+    /**
+     * Save this index in the given file.
+     *
+     * The index must be frozen (see freeze()), otherwise an Exception
+     * is thrown.
+     *
+     * The index file (native byte order) is made of:
+     * - a 56 bytes header (magic number, format version, byte order
+     *   mark, \f$k\f$, \f$k_1\f$, the number of k-mers and the lengths
+     *   of the transformer method and description);
+     * - the transformer method (see Transformer::getMethod(), which
+     *   includes its random parameters if any) and description, padded
+     *   with null bytes to a multiple of 8 bytes;
+     * - the \f$4^{k_1} + 1\f$ sub-index offsets (64 bits each);
+     * - the sorted suffixes of each sub-index (64 bits each).
+     *
+     * \param filename The name of the file to create (or overwrite).
+     */
+    void save(const std::string &filename) const;
+
     /**
      * Print this index on the given stream.
      *
@@ -281,6 +718,17 @@ namespace bijecthash {
       return *_transformer;
     }
 
+    /**
+     * Return the statically dispatched encoder of the packed k-mers
+     * for the index transformer.
+     *
+     * \return Returns the encoder to use for the packed k-mers (which
+     * gives the same encodings as transformer()).
+     */
+    inline const StaticTransformer &staticTransformer() const {
+      return _static_transformer;
+    }
+
   };
 
   /**
@@ -49,10 +49,88 @@ using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
-BhKmerProcessor::BhKmerProcessor(BhKmerIndex &index, CircularQueue<string> &queue):
-  KmerProcessor(queue), _index(index) {}
+BhKmerProcessor::Shards::Shards(size_t nb_shards, size_t queue_size, size_t block_size):
+  _queues(),
+  _nb_waiting(0),
+  _wait_mutex(),
+  _changed(),
+  block_size(block_size),
+  routing(nb_shards)
+{
+  assert(nb_shards > 0);
+  assert(block_size > 0);
+  _queues.reserve(nb_shards);
+  for (size_t i = 0; i < nb_shards; ++i) {
+    _queues.emplace_back(new CircularQueue<Block>(queue_size));
+  }
+}
+
+BhKmerProcessor::BhKmerProcessor(BhKmerIndex &index, CircularQueue<KmerBlock> &queue,
+                                 Shards *shards, size_t shard):
+  KmerProcessor(queue), _index(index), _shards(shards), _shard(shard), _outgoing(), _incoming(), _encoded()
+{
+  if (_shards) {
+    assert(_shard < _shards->size());
+    _outgoing.resize(_shards->size());
+    for (auto &block: _outgoing) {
+      block.reserve(_shards->block_size);
+    }
+  }
+}
+
+void BhKmerProcessor::_route(const Transformer::EncodedKmer &encoded) {
+  const size_t shard = _shards->owner(encoded.prefix);
+  Shards::Block &block = _outgoing[shard];
+  block.push_back(encoded);
+  if (block.size() >= _shards->block_size) {
+    _send(shard);
+  }
+}
+
+void BhKmerProcessor::_send(size_t shard) {
+  Shards::Block &block = _outgoing[shard];
+  if (shard == _shard) {
+    _index.insertExclusive(block);
+    block.clear();
+    return;
+  }
+  CircularQueue<Shards::Block> &queue = _shards->queue(shard);
+  CircularQueue<Shards::Block> &own_queue = _shards->queue(_shard);
+  while (!queue.emplace(std::move(block))) {
+    DEBUG_MSG("BhKmerProcessor_" << id << ":"
+              << "Unable to route a block of " << block.size() << " k-mers to shard " << shard << ".");
+    // The owner of the destination shard may itself wait for this
+    // processor to drain its own routing queue.
+    if (!_drain()) {
+      _shards->wait([&queue, &own_queue]() { return !queue.full() || !own_queue.empty(); });
+    }
+  }
+  _shards->notify();
+  block.clear();
+  block.reserve(_shards->block_size);
+}
+
+size_t BhKmerProcessor::_drain() {
+  CircularQueue<Shards::Block> &queue = _shards->queue(_shard);
+  size_t nb = 0;
+  while (queue.pop(_incoming)) {
+    DEBUG_MSG("BhKmerProcessor_" << id << ":"
+              << "Inserting a routed block of " << _incoming.size() << " k-mers.");
+    _index.insertExclusive(_incoming);
+    ++nb;
+  }
+  if (nb) {
+    // Some processor may wait for room in this routing queue.
+    _shards->notify();
+  }
+  return nb;
+}
 
 void BhKmerProcessor::_process(string &kmer) {
+  if (_shards) {
+    _route(_index.transformer()(kmer));
+    return;
+  }
 #ifdef DEBUG
   DEBUG_MSG("Inserting '" << kmer << "' in k-mer index");
   bool res =
@@ -61,4 +139,74 @@ void BhKmerProcessor::_process(string &kmer) {
   DEBUG_MSG("Insertion of '" << kmer << "' returns " << res);
 }
 
+void BhKmerProcessor::_process(uint64_t &kmer) {
+  if (_shards) {
+    _route(_index.staticTransformer()(kmer));
+    return;
+  }
+#ifdef DEBUG
+  DEBUG_MSG("Inserting packed k-mer " << kmer << " in k-mer index");
+  bool res =
+#endif
+    _index.insert(kmer);
+  DEBUG_MSG("Insertion of packed k-mer " << kmer << " returns " << res);
+}
+
+void BhKmerProcessor::_process(const uint64_t *kmers, size_t n) {
+  _encoded.resize(n);
+  _index.staticTransformer().transformBatch(kmers, n, _encoded.data());
+#if defined(DEBUG) || not(defined(NDEBUG))
+  const Transformer &transformer = _index.transformer();
+  for (size_t i = 0; i < n; ++i) {
+    string original = Transformer::decode(kmers[i], transformer.kmer_length);
+    string decoded = transformer(_encoded[i]);
+    DEBUG_MSG("original kmer: '" << original << "'" << '\n'
+              << MSG_DBG_HEADER << "decoded kmer:  '" << decoded << "'");
+    assert(decoded == original);
+  }
+#endif
+  if (_shards) {
+    for (const Transformer::EncodedKmer &encoded: _encoded) {
+      _route(encoded);
+    }
+    return;
+  }
+#ifdef DEBUG
+  DEBUG_MSG("Inserting a batch of " << n << " packed k-mers in k-mer index");
+  size_t res =
+#endif
+    _index.insert(_encoded);
+  DEBUG_MSG("Insertion of the batch of " << n << " packed k-mers returns " << res);
+}
+
+void BhKmerProcessor::_idle() {
+  if (_shards) {
+    _drain();
+  }
+}
+
+void BhKmerProcessor::_end() {
+  if (!_shards) {
+    return;
+  }
+  for (size_t shard = 0; shard < _outgoing.size(); ++shard) {
+    if (!_outgoing[shard].empty()) {
+      _send(shard);
+    }
+  }
+  DEBUG_MSG("BhKmerProcessor_" << id << ":"
+            << "All k-mers are routed.");
+  --_shards->routing;
+  _shards->notify();
+  // All the blocks routed to this shard are enqueued once no more
+  // processor is routing k-mers.
+  CircularQueue<Shards::Block> &own_queue = _shards->queue(_shard);
+  while (_shards->routing > 0) {
+    if (!_drain()) {
+      _shards->wait([this, &own_queue]() { return (_shards->routing == 0) || !own_queue.empty(); });
+    }
+  }
+  _drain();
+}
+
 END_BIJECTHASH_NAMESPACE
@@ -44,10 +44,18 @@
 #ifndef __BH_KMER_PROCESSOR_HPP__
 #define __BH_KMER_PROCESSOR_HPP__
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include <circular_queue.hpp>
 #include <kmer_processor.hpp>
 #include <bh_kmer_index.hpp>
+#include <transformer.hpp>
 
 namespace bijecthash {
 
@@ -57,9 +65,151 @@ namespace bijecthash {
    *
    * This helper class allows to run the k-mer processor in a dedicated
    * thread.
+   *
+   * When some Shards are given, each sub-index of the k-mer index is
+   * owned by exactly one k-mer processor. The dequeued k-mers are
+   * then encoded and routed (by blocks) to the processor owning their
+   * prefix, which is the only one inserting them in the index, thus
+   * without any locking.
    */
   class BhKmerProcessor: public KmerProcessor {
 
+  public:
+
+    /**
+     * The routing queues shared by the k-mer processors of a sharded
+     * index (one queue per processor).
+     */
+    class Shards {
+
+    public:
+
+      /**
+       * A block of encoded k-mers routed to their owner.
+       */
+      typedef std::vector<Transformer::EncodedKmer> Block;
+
+    private:
+
+      /**
+       * The routing queue of each shard.
+       */
+      std::vector<std::unique_ptr<CircularQueue<Block>>> _queues;
+
+      /**
+       * The number of processors waiting for some routing event (see
+       * wait()).
+       */
+      std::atomic_size_t _nb_waiting;
+
+      /**
+       * The mutex protecting the routing event condition variable.
+       */
+      std::mutex _wait_mutex;
+
+      /**
+       * The condition variable notified on each routing event (some
+       * block was enqueued or dequeued or some processor ended its
+       * routing).
+       */
+      std::condition_variable _changed;
+
+    public:
+
+      /**
+       * The (maximal) number of encoded k-mers per routed block.
+       */
+      const size_t block_size;
+
+      /**
+       * The number of processors that may still route some k-mers.
+       */
+      std::atomic_size_t routing;
+
+      /**
+       * Builds the routing queues for the given number of shards.
+       *
+       * \param nb_shards The number of shards (which must be equal to
+       * the number of k-mer processors).
+       *
+       * \param queue_size The size of each routing queue.
+       *
+       * \param block_size The (maximal) number of encoded k-mers per
+       * routed block.
+       */
+      Shards(size_t nb_shards, size_t queue_size, size_t block_size);
+
+      /**
+       * Get the number of shards.
+       *
+       * \return Returns the number of shards.
+       */
+      inline size_t size() const {
+        return _queues.size();
+      }
+
+      /**
+       * Get the shard owning the sub-index of the given prefix.
+       *
+       * \param prefix The encoded k-mer prefix.
+       *
+       * \return Returns the shard owning the given prefix (prefixes
+       * are interleaved among shards to balance the load).
+       */
+      inline size_t owner(uint64_t prefix) const {
+        return prefix % _queues.size();
+      }
+
+      /**
+       * Get the routing queue of the given shard.
+       *
+       * \param shard The shard number.
+       *
+       * \return Returns the routing queue of the given shard.
+       */
+      inline CircularQueue<Block> &queue(size_t shard) {
+        return *_queues[shard];
+      }
+
+      /**
+       * Wake up the processors waiting for some routing event (if
+       * any).
+       *
+       * This must be called after each successful enqueuing or
+       * dequeuing of some routed block and each time the routing
+       * counter is decremented.
+       */
+      void notify() {
+        // Either the waiting processor has registered itself before
+        // this fence (and is notified) or it will see the update when
+        // checking its wake up condition.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_nb_waiting.load(std::memory_order_relaxed) > 0) {
+          { std::lock_guard<std::mutex> lock(_wait_mutex); }
+          _changed.notify_all();
+        }
+      }
+
+      /**
+       * Block the current processor until the given condition becomes
+       * true.
+       *
+       * The condition is checked again on each routing event (see
+       * notify()).
+       *
+       * \param condition The wake up condition.
+       */
+      template <typename Condition>
+      void wait(Condition condition) {
+        std::unique_lock<std::mutex> lock(_wait_mutex);
+        ++_nb_waiting;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        _changed.wait(lock, condition);
+        --_nb_waiting;
+      }
+
+    };
+
   private:
 
     /**
@@ -67,6 +217,59 @@ namespace bijecthash {
      */
     BhKmerIndex &_index;
 
+    /**
+     * The shared routing queues (NULL if the index is not sharded).
+     */
+    Shards *_shards;
+
+    /**
+     * The shard owned by this processor.
+     */
+    size_t _shard;
+
+    /**
+     * The blocks of encoded k-mers being filled for each shard.
+     */
+    std::vector<Shards::Block> _outgoing;
+
+    /**
+     * The last block of encoded k-mers dequeued from the routing
+     * queue of the owned shard.
+     */
+    Shards::Block _incoming;
+
+    /**
+     * The encodings of the last batch of packed k-mers.
+     */
+    std::vector<Transformer::EncodedKmer> _encoded;
+
+    /**
+     * Append the given encoded k-mer to the block of its owner (and
+     * send the block if full).
+     *
+     * \param encoded The encoded k-mer to route.
+     */
+    void _route(const Transformer::EncodedKmer &encoded);
+
+    /**
+     * Send the block of encoded k-mers of the given shard to its owner
+     * (or insert it in the index if this processor is the owner).
+     *
+     * While the routing queue of the given shard is full, the routing
+     * queue of the owned shard is drained.
+     *
+     * \param shard The destination shard.
+     */
+    void _send(size_t shard);
+
+    /**
+     * Insert all the encoded k-mers available in the routing queue of
+     * the owned shard.
+     *
+     * \return Returns the number of dequeued blocks.
+     */
+    size_t _drain();
+
     /**
      * Store the given k-mer in the k-mer index.
      *
@@ -74,6 +277,40 @@ namespace bijecthash {
      */
     virtual void _process(std::string &kmer) override;
 
+    /**
+     * Store the given packed k-mer in the k-mer index.
+     *
+     * \param kmer The packed k-mer to process after having been
+     * dequeued.
+     */
+    virtual void _process(uint64_t &kmer) override;
+
+    /**
+     * Store the given batch of packed k-mers in the k-mer index.
+     *
+     * The k-mers are encoded at once (see
+     * StaticTransformer::transformBatch()) before being inserted (or
+     * routed).
+     *
+     * \param kmers The packed k-mers to process after having been
+     * dequeued.
+     *
+     * \param n The number of k-mers to process.
+     */
+    virtual void _process(const uint64_t *kmers, size_t n) override;
+
+    /**
+     * Insert the encoded k-mers routed to this processor (if sharded).
+     */
+    virtual void _idle() override;
+
+    /**
+     * Send the remaining blocks of encoded k-mers to their owners then
+     * insert the encoded k-mers routed to this processor until no
+     * processor routes k-mers anymore (if sharded).
+     */
+    virtual void _end() override;
+
   public:
 
     /**
@@ -81,9 +318,16 @@ namespace bijecthash {
      *
      * \param index The (thread-safe) k-mer index.
      *
-     * \param queue The queue storing the k-mers to process.
+     * \param queue The queue storing the blocks of k-mers to process.
+     *
+     * \param shards The routing queues shared by all the processors
+     * if the index is sharded or NULL (default) otherwise.
+     *
+     * \param shard The shard owned by this processor (only relevant
+     * if the index is sharded).
      */
-    BhKmerProcessor(BhKmerIndex &index, CircularQueue<std::string> &queue);
+    BhKmerProcessor(BhKmerIndex &index, CircularQueue<KmerBlock> &queue,
+                    Shards *shards = NULL, size_t shard = 0);
 
   };
 
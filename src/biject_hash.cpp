@@ -48,10 +48,13 @@
 #  include "cache_statistics.hpp"
 #endif
 #include "common.hpp"
+#include "exception.hpp"
 #include "lcp_stats.hpp"
+#include "mapped_file_reader.hpp"
 #include "program_options.hpp"
 #include "queue_watcher.hpp"
 #include "settings.hpp"
+#include "thread_pool.hpp"
 #include "threaded_reader_writer.hpp"
 #include "transformer.hpp"
 
@@ -62,7 +65,9 @@
 #include <algorithm>
 #include <string>
 #include <chrono>
+#include <memory>
 #include <sys/resource.h>
+#include <sys/stat.h>
 #include <thread>
 
 using namespace std;
@@ -78,21 +83,64 @@ struct infos {
   LcpStats lcp_stats;
 };
 
-typedef ThreadedReaderWriter<BhKmerProcessor, BhKmerCollector, string> BijectHashBaseClass;
+typedef ThreadedReaderWriter<BhKmerProcessor, BhKmerCollector, KmerBlock> BijectHashBaseClass;
 class BijectHash: public BijectHashBaseClass {
 
 private:
 
   BhKmerIndex &_index;
+  unique_ptr<BhKmerProcessor::Shards> _shards;
+  unique_ptr<ThreadPool> _pool;
   infos _time_mem_stats;
+
 #ifdef WATCH_QUEUE
   thread _watcher;
 #endif
 
+  /*
+   * The files whose size is at least twice this value are parsed by
+   * several collectors (each one parsing some chunk of the file).
+   */
+  static const size_t min_chunk_size = 32 << 20;
+
+  /*
+   * Add the collectors of the given files, splitting the large ones
+   * into chunks (up to four chunks per worker in order to balance the
+   * load). Compressed files can't be split (but they are decompressed
+   * on their own thread). The BGZF members of the compressed files are
+   * inflated in parallel, using half of the workers (shared between
+   * the compressed files) since the other half processes the k-mers.
+   */
+  void _addCollectors(const Settings &s, const vector<string> &filenames, size_t nb_workers) {
+    const size_t max_nb_chunks = 4 * (nb_workers ? nb_workers : 1);
+    size_t nb_compressed = 0;
+    for (auto &filename: filenames) {
+      nb_compressed += (MappedFileReader::detectCodec(filename) != Decompressor::NONE);
+    }
+    const size_t nb_decompression_threads = nb_compressed ? max(nb_workers / (2 * nb_compressed), size_t(1)) : 1;
+    _writers.reserve(filenames.size());
+    for (auto &filename: filenames) {
+      struct stat st;
+      const size_t size = (stat(filename.c_str(), &st) == 0) ? st.st_size : 0;
+      const size_t nb_chunks = min(size / min_chunk_size, max_nb_chunks);
+      if (MappedFileReader::detectCodec(filename) != Decompressor::NONE) {
+        _writers.emplace_back(s, filename, _queue);
+        _writers.back().setNbDecompressionThreads(nb_decompression_threads);
+      } else if (nb_chunks < 2) {
+        _writers.emplace_back(s, filename, _queue);
+      } else {
+        DEBUG_MSG("Splitting file '" << filename << "' into " << nb_chunks << " chunks");
+        for (size_t i = 0; i < nb_chunks; ++i) {
+          _writers.emplace_back(s, filename, _queue, size * i / nb_chunks, size * (i + 1) / nb_chunks);
+        }
+      }
+    }
+  }
+
   virtual void _pre() override {
 
 #ifdef WATCH_QUEUE
-    _watcher = std::thread(queueWatcher<KmerProcessor, KmerCollector, string>, std::cref(_queue));
+    _watcher = std::thread(queueWatcher<KmerProcessor, KmerCollector, KmerBlock>, std::cref(_queue));
 #endif
     struct rusage rusage_start;
     getrusage(RUSAGE_SELF, &rusage_start);
@@ -112,7 +160,9 @@ private:
       _watcher.join();
 #endif
 
-      assert(_queue.empty());
+      if (!_queue.empty()) {
+        throw Exception("Error: some k-mer blocks were not processed.\n");
+      }
 
 #ifdef ENABLE_CACHE_STATISTICS
     _time_mem_stats.cache_stats.stop();
@@ -136,46 +186,153 @@ public:
 
   BijectHash(BhKmerIndex &index, const vector<string> &filenames):
     BijectHashBaseClass(index.settings.queue_size, 0, 0),
-    _index(index)
+    _index(index),
+    _shards(),
+    _pool()
   {
 
     const Settings &s = index.settings;
-    _writers.reserve(filenames.size());
-    for (auto &filename: filenames) {
-      _writers.emplace_back(s, filename, _queue);
+    if (!s.sharded_index) {
+      _pool.reset(new ThreadPool());
     }
-
-    size_t nb_threads = thread::hardware_concurrency();
-    if (nb_threads > 3 * filenames.size()) {
-      // Don't use more than 2 processor for 1 collector
-      nb_threads = 2 * filenames.size();
-    } else {
-      // If there is less than 2 processor for 1 collector...
-      if (nb_threads > 2 * filenames.size()) {
-        // If there is more than 1 processor for 1 collector, use all of available threads.
-        nb_threads -= filenames.size();
+    _addCollectors(s, filenames, _pool ? _pool->size() : thread::hardware_concurrency());
+
+    if (s.sharded_index) {
+      // Each processor owns some sub-indexes, thus each needs its own
+      // thread.
+      const size_t nb_collectors = _writers.size();
+      size_t nb_threads = thread::hardware_concurrency();
+      if (nb_threads > 3 * nb_collectors) {
+        // Don't use more than 2 processor for 1 collector
+        nb_threads = 2 * nb_collectors;
       } else {
-        // Use at least 1 collector for 1 processor.
-        nb_threads = filenames.size();
+        // If there is less than 2 processor for 1 collector...
+        if (nb_threads > 2 * nb_collectors) {
+          // If there is more than 1 processor for 1 collector, use all of available threads.
+          nb_threads -= nb_collectors;
+        } else {
+          // Use at least 1 collector for 1 processor.
+          nb_threads = nb_collectors;
+        }
+      }
+      // And always use one more thread.
+      ++nb_threads;
+      cerr << "Using " << nb_threads << " k-mer processor(s) [heuristic]"
+           << " for " << nb_collectors << " k-mer collector(s) [one per file chunk]." << '\n'
+           << endl;
+      _readers.reserve(nb_threads);
+      // The k-mers are routed by blocks which are smaller than the
+      // collected ones (since each processor fills one block per shard).
+      const size_t routed_block_size = max(s.block_size / nb_threads, size_t(256));
+      _shards.reset(new BhKmerProcessor::Shards(nb_threads, s.queue_size, routed_block_size));
+      for (size_t i = 0; i < nb_threads; ++i) {
+        _readers.emplace_back(_index, _queue, _shards.get(), i);
+      }
+    } else {
+      // Each file chunk is collected by some task of the pool and each
+      // block of k-mers is processed by another task, thus each worker
+      // needs its own processor.
+      cerr << "Using " << _pool->size() << " worker thread(s) [one per hardware thread]"
+           << " for " << _writers.size() << " k-mer collector(s) [one per file chunk]." << '\n'
+           << endl;
+      _readers.reserve(_pool->size());
+      for (size_t i = 0; i < _pool->size(); ++i) {
+        _readers.emplace_back(_index, _queue);
       }
-    }
-    // And always use one more thread.
-    ++nb_threads;
-    cerr << "Using " << nb_threads << " k-mer processor(s) [heuristic]"
-         << " for " << filenames.size() << " k-mer collector(s) [one per file]." << '\n'
-         << endl;
-    while (nb_threads--) {
-      _readers.emplace_back(_index, _queue);
     }
 
   }
 
+  void run() {
+    if (_pool) {
+      BijectHashBaseClass::run(*_pool);
+    } else {
+      BijectHashBaseClass::run();
+    }
+  }
+
   const infos &getTimeMemStats() {
     return _time_mem_stats;
   }
 
 };
 
+/*
+ * Query the k-mers of the given files against the saved index
+ * given by the settings and print, for each read, the number of its
+ * k-mers and the number of them belonging to the index.
+ *
+ * The k-mers of each read are checked by batches of (at most)
+ * settings.block_size k-mers using BhKmerIndex::containsMany().
+ */
+void queryIndex(const Settings &settings, const vector<string> &filenames) {
+
+  BhKmerIndex index(settings, settings.index_filename);
+  const bool packed = (settings.kmer_length <= 32);
+  vector<uint64_t> packed_kmers;
+  vector<string> kmers;
+  vector<bool> results;
+  if (packed) {
+    packed_kmers.reserve(settings.block_size);
+  } else {
+    kmers.reserve(settings.block_size);
+  }
+
+  cout << "#File\tRead\tNbKmers\tNbHits\tHitRatio" << endl;
+  for (auto &filename: filenames) {
+    MappedFileReader reader(settings.kmer_length, filename, settings.verbose);
+    string read;
+    size_t read_offset = size_t(-1);
+    size_t nb_kmers = 0, nb_hits = 0;
+
+    auto check = [&]() {
+      if (packed) {
+        nb_hits += index.containsMany(packed_kmers, results);
+        packed_kmers.clear();
+      } else {
+        nb_hits += index.containsMany(kmers, results);
+        kmers.clear();
+      }
+    };
+
+    auto report = [&]() {
+      check();
+      if (nb_kmers) {
+        cout << filename
+             << '\t' << read
+             << '\t' << nb_kmers
+             << '\t' << nb_hits
+             << '\t' << (double(nb_hits) / nb_kmers)
+             << '\n';
+      }
+      nb_kmers = nb_hits = 0;
+    };
+
+    while (reader.nextKmer()) {
+      // The first k-mer of a read may not have the relative ID 1 (when
+      // the read starts with degenerated symbols), but the difference
+      // between the absolute and the relative IDs changes for each read.
+      const size_t offset = reader.getCurrentKmerID() - reader.getCurrentKmerID(false);
+      if (offset != read_offset) {
+        // A new read starts
+        report();
+        read = reader.getCurrentSequenceDescription();
+        read_offset = offset;
+      }
+      if (packed) {
+        packed_kmers.push_back(reader.getCurrentKmerPacked());
+      } else {
+        kmers.emplace_back(reader.getCurrentKmerView());
+      }
+      if (++nb_kmers % settings.block_size == 0) {
+        check();
+      }
+    }
+    report();
+  }
+  cout << flush;
+
+}
 
 int main(int argc, char* argv[]) {
 
@@ -194,9 +351,31 @@ int main(int argc, char* argv[]) {
   }
   cerr << endl;
 
+  if (opts.mode() == ProgramOptions::QUERY) {
+    try {
+      queryIndex(settings, filenames);
+    } catch (const Exception &e) {
+      cerr << e.what() << endl;
+      return 1;
+    }
+    cerr << "That's All, Folks!!!" << endl;
+    return 0;
+  }
+
   BhKmerIndex index(settings);
   BijectHash bh(index, filenames);
-  bh.run();
+  try {
+    bh.run();
+  } catch (const Exception &e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+  if (settings.freeze_index) {
+    index.freeze();
+  }
+  if (!settings.index_filename.empty()) {
+    index.save(settings.index_filename);
+  }
   const infos &time_mem_stats = bh.getTimeMemStats();
   map<string, double> stats = index.statistics();
 
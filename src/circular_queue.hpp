@@ -44,21 +44,40 @@
 #ifndef __CIRCULAR_QUEUE_HPP__
 #define __CIRCULAR_QUEUE_HPP__
 
-#include <algorithm>
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 #include <locker.hpp>
 
 namespace bijecthash {
 
   /**
-   * A template basic implementation of a thread safe circular queue (of
-   * some given fixed capacity).
+   * A template lock-free implementation of a thread safe circular
+   * queue (of some given fixed capacity).
    *
-   * Notice that even if it uses atomic variables, the current
-   * implementation is not lock free at all.
+   * This is a bounded Multiple Producers/Multiple Consumers (MPMC)
+   * queue based on the algorithm of Dmitry Vyukov (see
+   * https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue).
+   *
+   * Each cell of the queue holds a sequence number which tells
+   * whether the cell is ready to be written (its sequence equals the
+   * enqueuing position) or to be read (its sequence equals the
+   * dequeuing position plus one). Producers (resp. consumers) only
+   * compete on the enqueuing (resp. dequeuing) position, which are
+   * stored on distinct cache lines, and never on some global lock.
+   *
+   * Besides the non blocking push(), emplace() and pop() methods, the
+   * waitPush(), waitEmplace() and waitPop() methods block the calling
+   * thread (without consuming any CPU) until the operation succeeds
+   * or the queue is closed (see close()). The mutex and condition
+   * variables used for that purpose are only involved when some
+   * thread is actually waiting.
    */
   template <typename T>
   class CircularQueue {
@@ -73,9 +92,17 @@ namespace bijecthash {
   private:
 
     /**
-     * Multithread mutex locker
+     * The (assumed) size of a cache line.
+     */
+    static constexpr size_t _cache_line_size = 64;
+
+    /**
+     * A queue cell.
      */
-    mutable SpinlockMutex _mutex;
+    struct _Cell {
+      std::atomic_size_t sequence; /**< The cell sequence number. */
+      T data;                      /**< The stored data. */
+    };
 
     /**
      * Mask to compute modulo more efficiently
@@ -83,24 +110,53 @@ namespace bijecthash {
     const size_t _mask;
 
     /**
-     * The data to store in this queue.
+     * The cells of this queue.
      */
-    T *_data;
+    _Cell *_cells;
 
     /**
-     * The current number of elements in this queue.
+     * The position of the next element to enqueue (padded in order
+     * to avoid false sharing with the dequeuing position).
      */
-    std::atomic_size_t _size;
+    alignas(_cache_line_size) std::atomic_size_t _enqueue_pos;
 
     /**
-     * The index of the first queued element.
+     * The position of the next element to dequeue (padded in order
+     * to avoid false sharing with the enqueuing position).
      */
-    std::atomic_size_t _first;
+    alignas(_cache_line_size) std::atomic_size_t _dequeue_pos;
 
     /**
-     * The index of the after-the-last queued element.
+     * Whether this queue is closed (no more element will be enqueued).
      */
-    std::atomic_size_t _last;
+    alignas(_cache_line_size) std::atomic_bool _closed;
+
+    /**
+     * The number of consumers waiting for this queue to be non empty.
+     */
+    std::atomic_size_t _nb_waiting_consumers;
+
+    /**
+     * The number of producers waiting for this queue to be non full.
+     */
+    std::atomic_size_t _nb_waiting_producers;
+
+    /**
+     * The mutex associated to the condition variables.
+     */
+    std::mutex _wait_mutex;
+
+    /**
+     * Condition variable notified when some element is enqueued (or
+     * when the queue is closed).
+     */
+    std::condition_variable _not_empty;
+
+    /**
+     * Condition variable notified when some element is dequeued (or
+     * when the queue is closed).
+     */
+    std::condition_variable _not_full;
 
     /**
      * For thread safety, move assignment operator is removed.
@@ -122,9 +178,12 @@ namespace bijecthash {
      *
      * \param n The value to ceil.
      *
-     * \return Returns the ceiling power of two of the given value.
+     * \return Returns the ceiling power of two of the given value
+     * (this is at least 2 since the algorithm needs two cells to
+     * distinguish the full queue from the empty one).
      */
     inline static size_t _nextPowerOfTwo(size_t n) {
+      if (n < 2) return 2;
       n--;
       n |= n >> 1;
       n |= n >> 2;
@@ -136,6 +195,74 @@ namespace bijecthash {
       return n;
     }
 
+    /**
+     * Try to reserve the cell where to enqueue some element.
+     *
+     * \param pos The reserved position (only relevant on success).
+     *
+     * \return Returns the reserved cell on success or NULL if the
+     * queue is full.
+     */
+    _Cell *_reserveEnqueueCell(size_t &pos) {
+      pos = _enqueue_pos.load(std::memory_order_relaxed);
+      for (;;) {
+        _Cell *cell = &_cells[pos & _mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+        if (diff == 0) {
+          if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            return cell;
+          }
+        } else if (diff < 0) {
+          return NULL;
+        } else {
+          pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    /**
+     * Wake up one of the threads waiting on the given condition
+     * variable (if any).
+     *
+     * \param nb_waiting The number of threads waiting on the
+     * condition variable.
+     *
+     * \param cv The condition variable to notify.
+     */
+    void _notify(std::atomic_size_t &nb_waiting, std::condition_variable &cv) {
+      // Either the waiting thread has registered itself before this
+      // fence (and is notified) or it will see the queue update when
+      // checking its wake up condition.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (nb_waiting.load(std::memory_order_relaxed) > 0) {
+        // Ensure the waiting thread is either sleeping or has not yet
+        // checked its wake up condition.
+        { std::lock_guard<std::mutex> lock(_wait_mutex); }
+        cv.notify_one();
+      }
+    }
+
+    /**
+     * Block the current thread until the given condition becomes
+     * true.
+     *
+     * \param nb_waiting The number of threads waiting on the
+     * condition variable.
+     *
+     * \param cv The condition variable to wait on.
+     *
+     * \param condition The wake up condition.
+     */
+    template <typename Condition>
+    void _wait(std::atomic_size_t &nb_waiting, std::condition_variable &cv, Condition condition) {
+      std::unique_lock<std::mutex> lock(_wait_mutex);
+      ++nb_waiting;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      cv.wait(lock, condition);
+      --nb_waiting;
+    }
+
   public:
 
     /**
@@ -148,10 +275,15 @@ namespace bijecthash {
     CircularQueue(size_t capacity):
       capacity(_nextPowerOfTwo(capacity)),
       _mask(this->capacity - 1),
-      _data(new T[this->capacity]),
-      _size(0),
-      _first(0),
-      _last(0)
+      _cells(new _Cell[this->capacity]),
+      _enqueue_pos(0),
+      _dequeue_pos(0),
+      _closed(false),
+      _nb_waiting_consumers(0),
+      _nb_waiting_producers(0),
+      _wait_mutex(),
+      _not_empty(),
+      _not_full()
     {
 #ifdef DEBUG
       io_mutex.lock();
@@ -162,15 +294,16 @@ namespace bijecthash {
                 << std::endl;
       io_mutex.unlock();
 #endif
+      for (size_t i = 0; i < this->capacity; ++i) {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+      }
     }
 
     /**
      * Destructor
      */
     ~CircularQueue() {
-      if (capacity) {
-        delete [] _data;
-      }
+      delete [] _cells;
     }
 
     /**
@@ -182,72 +315,31 @@ namespace bijecthash {
      * queue is full).
      */
     bool push(const T &t) {
-      LockerGuardian<> g(_mutex);
-#ifdef DEBUG
-      io_mutex.lock();
-      std::cerr << "[DEBUG] "
-                << "[Thread " << this_thread::get_id()  << "] "
-                << __FILE__ << ":" << __LINE__ << ":" << __FUNCTION__ << ": "
-                << "Try to enqueue some element on queue of size " << _size.load()
-                << " which is [" << _first.load() << ", " << _last.load() << "["
-                << std::endl;
-      io_mutex.unlock();
-#endif
-      if (full()) return false;
-#ifdef DEBUG
-      io_mutex.lock();
-      std::cerr << "[DEBUG] "
-                << "[Thread " << this_thread::get_id()  << "] "
-                << __FILE__ << ":" << __LINE__ << ":" << __FUNCTION__ << ": "
-                << "Ok, let's go..."
-                << std::endl;
-      io_mutex.unlock();
-#endif
-      size_t p = _last.load();
-#ifdef DEBUG
-      size_t p_copy = p;
-      io_mutex.lock();
-      std::cerr << "[DEBUG] "
-                << "[Thread " << this_thread::get_id()  << "] "
-                << __FILE__ << ":" << __LINE__ << ":" << __FUNCTION__ << ": "
-                << "Adding element at position " << p_copy << '\n';
-                << std::endl;
-      io_mutex.unlock();
-#endif
-      _data[p++] = t;
-      p = p & _mask;
-      ++_size;
-      _last.store(p);
-#ifdef DEBUG
-      io_mutex.lock();
-      std::cerr << "[DEBUG] "
-                << "[Thread " << this_thread::get_id()  << "] "
-                << __FILE__ << ":" << __LINE__ << ":" << __FUNCTION__ << ": "
-                << "Element added at position " << p_copy
-                << ", now size is " << _size.load()
-                << " which is [" << _first.load() << ", " << _last.load() << "["
-                << std::endl;
-      io_mutex.unlock();
-#endif
+      size_t pos;
+      _Cell *cell = _reserveEnqueueCell(pos);
+      if (!cell) return false;
+      cell->data = t;
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      _notify(_nb_waiting_consumers, _not_empty);
       return true;
     }
 
     /**
      * Try to enqueue the given element in this queue.
      *
-     * \param t The element to enqueue.
+     * \param t The element to enqueue (it is moved into the queue
+     * only on success).
      *
      * \return This return true on success and false otherwise (when the
      * queue is full).
      */
-    bool emplace(const T &&t) {
-      LockerGuardian<> g(_mutex);
-      if (full()) return false;
-      size_t p = _last.load();
-      _data[p++] = std::move(t);
-      p = p & _mask;
-      ++_size;
-      _last.store(p);
+    bool emplace(T &&t) {
+      size_t pos;
+      _Cell *cell = _reserveEnqueueCell(pos);
+      if (!cell) return false;
+      cell->data = std::move(t);
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      _notify(_nb_waiting_consumers, _not_empty);
       return true;
     }
 
@@ -260,63 +352,125 @@ namespace bijecthash {
      * queue is empty).
      */
     bool pop(T &t) {
-      LockerGuardian<> g(_mutex);
-#ifdef DEBUG
-      io_mutex.lock();
-      std::cerr << "[DEBUG] "
-                << "[Thread " << this_thread::get_id()  << "] "
-                << __FILE__ << ":" << __LINE__ << ":" << __FUNCTION__ << ": "
-                << "Try to dequeue some element on queue of size " << _size.load()
-                << " which is [" << _first.load() << ", " << _last.load() << "["
-                << std::endl;
-      io_mutex.unlock();
-#endif
-      if (empty()) return false;
-#ifdef DEBUG
-      io_mutex.lock();
-      std::cerr << "[DEBUG] "
-                << "[Thread " << this_thread::get_id()  << "] "
-                << __FILE__ << ":" << __LINE__ << ":" << __FUNCTION__ << ": "
-                << "Ok, let's go..."
-                << std::endl;
-      io_mutex.unlock();
-#endif
-      size_t p = _first.load();
-#ifdef DEBUG
-      size_t p_copy = p;
-      io_mutex.lock();
-      std::cerr << "[DEBUG] "
-                << "[Thread " << this_thread::get_id()  << "] "
-                << __FILE__ << ":" << __LINE__ << ":" << __FUNCTION__ << ": "
-                << "Removing element at position " << p_copy
-                << std::endl;
-      io_mutex.unlock();
-#endif
-      t = std::move(_data[p++]);
-      p = p & _mask;
-      --_size;
-      _first.store(p);
-#ifdef DEBUG
-      io_mutex.lock();
-      std::cerr << "[DEBUG] "
-                << "[Thread " << this_thread::get_id()  << "] "
-                << __FILE__ << ":" << __LINE__ << ":" << __FUNCTION__ << ": "
-                << "Element removed from position " << p_copy
-                << ", now size is " << _size.load()
-                << " which is [" << _first.load() << ", " << _last.load() << "["
-                << std::endl;
-      io_mutex.unlock();
-#endif
+      size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+      _Cell *cell;
+      for (;;) {
+        cell = &_cells[pos & _mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+        if (diff == 0) {
+          if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            break;
+          }
+        } else if (diff < 0) {
+          return false;
+        } else {
+          pos = _dequeue_pos.load(std::memory_order_relaxed);
+        }
+      }
+      t = std::move(cell->data);
+      cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+      _notify(_nb_waiting_producers, _not_full);
+      return true;
+    }
+
+    /**
+     * Enqueue a copy of the given element in this queue, waiting for
+     * some available room if needed.
+     *
+     * \param t The element to enqueue.
+     *
+     * \return This return true on success and false if the queue is
+     * closed.
+     */
+    bool waitPush(const T &t) {
+      while (!push(t)) {
+        if (closed()) return false;
+        _wait(_nb_waiting_producers, _not_full, [this]() { return !full() || closed(); });
+      }
       return true;
     }
 
+    /**
+     * Enqueue the given element in this queue, waiting for some
+     * available room if needed.
+     *
+     * \param t The element to enqueue (it is moved into the queue
+     * only on success).
+     *
+     * \return This return true on success and false if the queue is
+     * closed.
+     */
+    bool waitEmplace(T &&t) {
+      while (!emplace(std::move(t))) {
+        if (closed()) return false;
+        _wait(_nb_waiting_producers, _not_full, [this]() { return !full() || closed(); });
+      }
+      return true;
+    }
+
+    /**
+     * Dequeue the oldest element in this queue, waiting for some
+     * element to be enqueued if needed.
+     *
+     * \param t A variable where to store the dequeued element.
+     *
+     * \return This return true on success and false once the queue is
+     * both closed and empty (end of stream).
+     */
+    bool waitPop(T &t) {
+      while (!pop(t)) {
+        if (closed()) {
+          if (empty()) return false;
+          // Some element is still being enqueued.
+          std::this_thread::yield();
+        } else {
+          _wait(_nb_waiting_consumers, _not_empty, [this]() { return !empty() || closed(); });
+        }
+      }
+      return true;
+    }
+
+    /**
+     * Close this queue (end of stream).
+     *
+     * No element must be enqueued once the queue is closed. The
+     * waiting producers give up and the consumers get the remaining
+     * elements before their waitPop() calls return false.
+     */
+    void close() {
+      {
+        std::lock_guard<std::mutex> lock(_wait_mutex);
+        _closed.store(true);
+      }
+      _not_empty.notify_all();
+      _not_full.notify_all();
+    }
+
+    /**
+     * Check whether this queue is closed.
+     *
+     * \return Returns true if this queue is closed and false
+     * otherwise.
+     */
+    bool closed() const {
+      return _closed.load(std::memory_order_acquire);
+    }
+
     /**
      * Get the size of this queue.
      *
+     * Since producers and consumers run concurrently, this is only a
+     * snapshot (elements being enqueued are counted as soon as their
+     * cell is reserved).
+     *
      * \return Returns the number of enqueued elements.
      */
     size_t size() const {
-      return _size.load();
+      size_t first = _dequeue_pos.load(std::memory_order_acquire);
+      size_t last = _enqueue_pos.load(std::memory_order_acquire);
+      size_t s = (last > first) ? (last - first) : 0;
+      return (s < capacity) ? s : capacity;
     }
 
     /**
@@ -342,15 +496,18 @@ namespace bijecthash {
     /**
      * Print this queue to the given stream.
      *
+     * Notice that the printed content is meaningful only if no
+     * producer nor consumer is running concurrently.
+     *
      * \param os The output stream on which to print this queue.
      */
     void toStream(std::ostream &os) const {
-      LockerGuardian<> g1(_mutex);
-      LockerGuardian<> g2(io_mutex);
+      LockerGuardian<> g(io_mutex);
       os << "CircularQueue:\n";
-      size_t n = _size.load();
+      size_t first = _dequeue_pos.load();
+      size_t n = size();
       for (size_t i = 0; i < n; ++i) {
-        os << "- '" << _data[(_first + i) & _mask] << "'\n";
+        os << "- '" << _cells[(first + i) & _mask].data << "'\n";
       }
     }
 
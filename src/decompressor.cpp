@@ -0,0 +1,534 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#include "decompressor.hpp"
+
+#include "common.hpp"
+#include "exception.hpp"
+#include "mapped_file_reader.hpp"
+#include "thread_pool.hpp"
+
+#include <climits>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
+#ifdef HAVE_ZLIB
+#  include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#  include <zstd.h>
+#endif
+
+using namespace std;
+
+BEGIN_BIJECTHASH_NAMESPACE
+
+const size_t Decompressor::block_size = 4 << 20;
+
+/**
+ * The number of decompressed blocks which can wait for being parsed.
+ */
+static const size_t queued_blocks = 4;
+
+/**
+ * The number of BGZF members decompressed by a single task (each
+ * member being at most 64KiB when decompressed).
+ */
+static const size_t bgzf_members_per_task = 64;
+
+/**
+ * The maximal decompressed size of a BGZF member.
+ */
+static const size_t bgzf_max_member_isize = 1 << 16;
+
+/**
+ * Read some little endian unsigned integer.
+ *
+ * \param p The position of the integer.
+ *
+ * \param n The number of bytes of the integer.
+ *
+ * \return Returns the integer value.
+ */
+static size_t _readLE(const char *p, size_t n) {
+  size_t v = 0;
+  while (n--) {
+    v = (v << 8) | (unsigned char) p[n];
+  }
+  return v;
+}
+
+/**
+ * Get the size of the BGZF member at the given position from its
+ * header.
+ *
+ * \param p The position of the member.
+ *
+ * \param end The end of the available content (which must contain at
+ * least the member header).
+ *
+ * \return Returns the size of the member (including its header and
+ * trailer) or 0 if there is no BGZF member header at the given
+ * position.
+ */
+static size_t _bgzfHeaderMemberSize(const char *p, const char *end) {
+  if ((end - p < 18)
+      || ((unsigned char) p[0] != 0x1f) || ((unsigned char) p[1] != 0x8b)
+      || (p[2] != 8) || !(p[3] & 4)) {
+    return 0;
+  }
+  const size_t xlen = _readLE(p + 10, 2);
+  const char *extra = p + 12;
+  const char *extra_end = extra + xlen;
+  if (extra_end > end) {
+    return 0;
+  }
+  while (extra + 4 <= extra_end) {
+    const size_t slen = _readLE(extra + 2, 2);
+    if ((extra[0] == 'B') && (extra[1] == 'C') && (slen == 2) && (extra + 6 <= extra_end)) {
+      const size_t size = _readLE(extra + 4, 2) + 1;
+      return (size >= 12 + xlen + 8) ? size : 0;
+    }
+    extra += 4 + slen;
+  }
+  return 0;
+}
+
+/**
+ * Get the size of the BGZF member at the given position.
+ *
+ * \param p The position of the member.
+ *
+ * \param end The end of the compressed content.
+ *
+ * \return Returns the size of the member (including its header and
+ * trailer) or 0 if there is no valid BGZF member at the given
+ * position.
+ */
+static size_t _bgzfMemberSize(const char *p, const char *end) {
+  const size_t size = _bgzfHeaderMemberSize(p, end);
+  return (size <= size_t(end - p)) ? size : 0;
+}
+
+/**
+ * Throw an exception about some corrupted compressed content.
+ *
+ * \param codec The compression format.
+ *
+ * \param reason The error description.
+ */
+[[noreturn]] static void _corrupted(Decompressor::Codec codec, const string &reason) {
+  Exception e;
+  e << "Error: Unable to decompress the " << Decompressor::codec2string(codec) << " content"
+    << " (" << reason << ").\n";
+  throw e;
+}
+
+#ifdef HAVE_ZLIB
+/**
+ * Inflate stream wrapper (which releases the stream on destruction).
+ */
+struct _ZStream: public z_stream {
+  _ZStream(int window_bits): z_stream() {
+    if (inflateInit2(this, window_bits) != Z_OK) {
+      _corrupted(Decompressor::GZIP, "unable to initialize zlib");
+    }
+  }
+  ~_ZStream() {
+    inflateEnd(this);
+  }
+};
+
+/**
+ * Decompress the given BGZF members.
+ *
+ * \param begin The beginning of the first member.
+ *
+ * \param end The end of the last member.
+ *
+ * \return Returns the decompressed content of the members.
+ */
+static Decompressor::Block _inflateBgzfMembers(const char *begin, const char *end) {
+  Decompressor::Block block;
+  _ZStream zs(-MAX_WBITS);
+  for (const char *member = begin; member < end;) {
+    const size_t size = _bgzfMemberSize(member, end);
+    assert(size);
+    const size_t header_size = 12 + _readLE(member + 10, 2);
+    const uint32_t crc = _readLE(member + size - 8, 4);
+    const size_t isize = _readLE(member + size - 4, 4);
+    const size_t offset = block.size();
+    if (isize > bgzf_max_member_isize) {
+      _corrupted(Decompressor::BGZF, "member size mismatch");
+    }
+    if (isize) {
+      block.resize(offset + isize);
+      inflateReset(&zs);
+      zs.next_in = (Bytef *) member + header_size;
+      zs.avail_in = size - header_size - 8;
+      zs.next_out = (Bytef *) block.data() + offset;
+      zs.avail_out = isize;
+      const int ret = inflate(&zs, Z_FINISH);
+      if ((ret != Z_STREAM_END) && zs.avail_out) {
+        _corrupted(Decompressor::BGZF, "invalid member");
+      }
+      // The inflated content must fill exactly the announced size.
+      if ((ret != Z_STREAM_END) || zs.avail_out) {
+        _corrupted(Decompressor::BGZF, "member size mismatch");
+      }
+    }
+    // Otherwise, this is an empty member (typically the end of file
+    // marker), whose CRC is 0.
+    if (crc32(0, (const Bytef *) block.data() + offset, isize) != crc) {
+      _corrupted(Decompressor::BGZF, "member CRC mismatch");
+    }
+    member += size;
+  }
+  return block;
+}
+#endif
+
+Decompressor::Codec Decompressor::detect(const char *begin, const char *end) {
+  const size_t size = end - begin;
+  if ((size >= 18) && ((unsigned char) begin[0] == 0x1f) && ((unsigned char) begin[1] == 0x8b)) {
+    return _bgzfHeaderMemberSize(begin, end) ? BGZF : GZIP;
+  }
+  if ((size >= 4) && (_readLE(begin, 4) == 0xFD2FB528)) {
+    return ZSTD;
+  }
+  return NONE;
+}
+
+bool Decompressor::isSupported(Codec codec) {
+  switch (codec) {
+  case NONE: return true;
+#ifdef HAVE_ZLIB
+  case GZIP:
+  case BGZF: return true;
+#endif
+#ifdef HAVE_ZSTD
+  case ZSTD: return true;
+#endif
+  default: return false;
+  }
+}
+
+string Decompressor::codec2string(Codec codec) {
+  switch (codec) {
+  case NONE: return "uncompressed";
+  case GZIP: return "gzip";
+  case BGZF: return "BGZF";
+  case ZSTD: return "zstd";
+  }
+  return "";
+}
+
+Decompressor::Decompressor(const char *begin, const char *end, Codec codec, size_t nb_threads):
+  _begin(begin), _end(end), _codec(codec),
+  _nb_threads(nb_threads ? nb_threads : thread::hardware_concurrency()),
+  _blocks(queued_blocks), _thread(), _error(),
+  _pending(), _scan_from(0), _format(FileReader::UNDEFINED)
+{
+  assert(codec != NONE);
+  assert(isSupported(codec));
+}
+
+void Decompressor::setNbThreads(size_t nb_threads) {
+  _nb_threads = nb_threads ? nb_threads : thread::hardware_concurrency();
+}
+
+Decompressor::~Decompressor() {
+  _blocks.close();
+  if (_thread.joinable()) {
+    _thread.join();
+  }
+}
+
+string Decompressor::head(size_t size) const {
+  string s(size, '\0');
+  size_t n = 0;
+  switch (_codec) {
+#ifdef HAVE_ZLIB
+  case GZIP:
+  case BGZF: {
+    _ZStream zs(MAX_WBITS + 16);
+    zs.next_in = (Bytef *) _begin;
+    zs.avail_in = (_end - _begin < INT_MAX) ? _end - _begin : INT_MAX;
+    zs.next_out = (Bytef *) &s[0];
+    zs.avail_out = size;
+    int ret;
+    do {
+      ret = inflate(&zs, Z_NO_FLUSH);
+    } while ((ret == Z_OK) && zs.avail_out && zs.avail_in);
+    n = size - zs.avail_out;
+    break;
+  }
+#endif
+#ifdef HAVE_ZSTD
+  case ZSTD: {
+    ZSTD_DStream *ds = ZSTD_createDStream();
+    ZSTD_initDStream(ds);
+    ZSTD_inBuffer in = { _begin, size_t(_end - _begin), 0 };
+    ZSTD_outBuffer out = { &s[0], size, 0 };
+    size_t ret;
+    do {
+      ret = ZSTD_decompressStream(ds, &out, &in);
+    } while (!ZSTD_isError(ret) && (out.pos < out.size) && (in.pos < in.size));
+    ZSTD_freeDStream(ds);
+    n = out.pos;
+    break;
+  }
+#endif
+  default:
+    break;
+  }
+  s.resize(n);
+  return s;
+}
+
+bool Decompressor::nextBlock(Block &block) {
+  if (!_thread.joinable()) {
+    _thread = thread(&Decompressor::_run, this);
+  }
+  if (_blocks.waitPop(block)) {
+    return true;
+  }
+  if (_error) {
+    rethrow_exception(_error);
+  }
+  return false;
+}
+
+void Decompressor::_run() {
+  DEBUG_MSG("Starting the " << codec2string(_codec) << " decompression");
+  try {
+    switch (_codec) {
+    case GZIP: _gunzip(); break;
+    case BGZF: _bgunzip(); break;
+    case ZSTD: _unzstd(); break;
+    default: assert(false);
+    }
+    _flush(true);
+  } catch (...) {
+    _error = current_exception();
+  }
+  _blocks.close();
+  DEBUG_MSG("End of the " << codec2string(_codec) << " decompression");
+}
+
+void Decompressor::_gunzip() {
+#ifdef HAVE_ZLIB
+  _ZStream zs(MAX_WBITS + 16);
+  vector<char> buffer(256 << 10);
+  const char *in = _begin;
+  bool stream_end = false;
+  for (;;) {
+    if (!zs.avail_in && (in < _end)) {
+      // The input size is fed by (large) pieces since zlib uses 32 bits sizes.
+      const size_t n = (size_t(_end - in) < (1u << 30)) ? _end - in : (1u << 30);
+      zs.next_in = (Bytef *) in;
+      zs.avail_in = n;
+      in += n;
+    }
+    if (stream_end) {
+      if (!zs.avail_in) {
+        break;
+      }
+      // Concatenated gzip members.
+      inflateReset(&zs);
+      stream_end = false;
+    }
+    zs.next_out = (Bytef *) buffer.data();
+    zs.avail_out = buffer.size();
+    const int ret = inflate(&zs, Z_NO_FLUSH);
+    if (ret == Z_STREAM_END) {
+      stream_end = true;
+    } else if ((ret != Z_OK) && !((ret == Z_BUF_ERROR) && (zs.avail_in || (in < _end)))) {
+      _corrupted(_codec, ((ret == Z_BUF_ERROR) ? "unexpected end of data" : (zs.msg ? zs.msg : "invalid data")));
+    }
+    if (!_emit(buffer.data(), buffer.size() - zs.avail_out)) {
+      return;
+    }
+  }
+#endif
+}
+
+void Decompressor::_bgunzip() {
+#ifdef HAVE_ZLIB
+  // Batches of members are decompressed in parallel, but their
+  // content is emitted in order.
+  ThreadPool pool(_nb_threads);
+  deque<future<Block>> batches;
+  const char *p = _begin;
+  bool stop = false;
+  while (!stop && ((p < _end) || !batches.empty())) {
+    if ((p < _end) && (batches.size() < 2 * pool.size())) {
+      const char *batch_begin = p;
+      for (size_t i = 0; (i < bgzf_members_per_task) && (p < _end); ++i) {
+        const size_t size = _bgzfMemberSize(p, _end);
+        if (!size) {
+          _corrupted(_codec, "invalid member header");
+        }
+        p += size;
+      }
+      const char *batch_end = p;
+      auto task = make_shared<packaged_task<Block()>>([batch_begin, batch_end]() {
+        return _inflateBgzfMembers(batch_begin, batch_end);
+      });
+      batches.push_back(task->get_future());
+      pool.submit([task]() { (*task)(); });
+    } else {
+      Block block = batches.front().get();
+      batches.pop_front();
+      stop = !_emit(block.data(), block.size());
+    }
+  }
+#endif
+}
+
+void Decompressor::_unzstd() {
+#ifdef HAVE_ZSTD
+  struct _DStream {
+    ZSTD_DStream *ds;
+    _DStream(): ds(ZSTD_createDStream()) {
+      ZSTD_initDStream(ds);
+    }
+    ~_DStream() {
+      ZSTD_freeDStream(ds);
+    }
+  } stream;
+  vector<char> buffer(ZSTD_DStreamOutSize());
+  ZSTD_inBuffer in = { _begin, size_t(_end - _begin), 0 };
+  size_t ret = 0;
+  bool full;
+  do {
+    ZSTD_outBuffer out = { buffer.data(), buffer.size(), 0 };
+    ret = ZSTD_decompressStream(stream.ds, &out, &in);
+    if (ZSTD_isError(ret)) {
+      _corrupted(_codec, ZSTD_getErrorName(ret));
+    }
+    if (!_emit(buffer.data(), out.pos)) {
+      return;
+    }
+    full = (out.pos == out.size);
+  } while ((in.pos < in.size) || full);
+  if (ret) {
+    _corrupted(_codec, "unexpected end of data");
+  }
+#endif
+}
+
+bool Decompressor::_emit(const char *data, size_t size) {
+  if (!size) {
+    return true;
+  }
+  if (_format == FileReader::UNDEFINED) {
+    switch (*data) {
+    case ';':
+    case '>': _format = FileReader::FASTA; break;
+    case '@': _format = FileReader::FASTQ; break;
+    default: break;
+    }
+  }
+  _pending.insert(_pending.end(), data, data + size);
+  return _flush(false);
+}
+
+size_t Decompressor::_lastRecordStart() {
+  if (_format == FileReader::UNDEFINED) {
+    return 0;
+  }
+  const char *data = _pending.data();
+  const char *end = data + _pending.size();
+  const char *from = data + _scan_from;
+  const char *p = end;
+  size_t cut = 0;
+  while (!cut && (p > from)) {
+    const char *nl = static_cast<const char *>(memrchr(from, '\n', p - from));
+    if (!nl) {
+      break;
+    }
+    if ((nl + 1 < end) && MappedFileReader::isRecordStart(nl + 1, end, _format)) {
+      cut = nl + 1 - data;
+    }
+    p = nl;
+  }
+  if (!cut) {
+    // The last lines may become record boundaries once more content
+    // is available (for the fastq format, this requires two more
+    // lines), but not the previous ones.
+    p = end;
+    for (size_t i = 0; (i < 4) && (p > from); ++i) {
+      const char *nl = static_cast<const char *>(memrchr(from, '\n', p - from));
+      p = nl ? nl : from;
+    }
+    _scan_from = p - data;
+  }
+  return cut;
+}
+
+bool Decompressor::_flush(bool all) {
+  while ((_pending.size() >= block_size) || (all && !_pending.empty())) {
+    size_t cut = _lastRecordStart();
+    if (!cut) {
+      if (!all) {
+        // Some record is larger than the block size.
+        return true;
+      }
+      cut = _pending.size();
+    }
+    Block block;
+    block.reserve(block_size + (block_size >> 2));
+    block.assign(_pending.begin() + cut, _pending.end());
+    swap(block, _pending);
+    block.resize(cut);
+    _scan_from = 0;
+    if (!_blocks.waitEmplace(std::move(block))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+END_BIJECTHASH_NAMESPACE
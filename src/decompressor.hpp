@@ -0,0 +1,332 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifndef __DECOMPRESSOR_HPP__
+#define __DECOMPRESSOR_HPP__
+
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <circular_queue.hpp>
+#include <file_reader.hpp>
+
+namespace bijecthash {
+
+  /**
+   * Streaming decompression of some compressed fasta/fastq file
+   * content.
+   *
+   * The decompression runs on its own thread (started on the first
+   * call to nextBlock()) and produces blocks of decompressed content
+   * which always end on some record boundary (see
+   * MappedFileReader::isRecordStart()), thus each block can be
+   * parsed on its own.
+   *
+   * The gzip format (including multi-member files) is decompressed
+   * sequentially. The BGZF format (the blocked gzip format used by
+   * samtools/htslib, which is a valid gzip format too) is
+   * decompressed in parallel since its members are independent and
+   * their size is stored in their header. The zstd format is also
+   * supported if available.
+   */
+  class Decompressor {
+
+  public:
+
+    /**
+     * The supported compression formats.
+     */
+    enum Codec {
+      NONE, /**< Not compressed */
+      GZIP, /**< gzip format */
+      BGZF, /**< blocked gzip format */
+      ZSTD  /**< Zstandard format */
+    };
+
+    /**
+     * The type of decompressed blocks.
+     */
+    typedef std::vector<char> Block;
+
+    /**
+     * The targeted size of decompressed blocks (blocks are larger if
+     * some record is larger).
+     */
+    static const size_t block_size;
+
+  private:
+
+    /**
+     * The beginning of the compressed content.
+     */
+    const char *_begin;
+
+    /**
+     * The end of the compressed content.
+     */
+    const char *_end;
+
+    /**
+     * The compression format of the content.
+     */
+    Codec _codec;
+
+    /**
+     * The number of threads used to decompress BGZF members in
+     * parallel.
+     */
+    size_t _nb_threads;
+
+    /**
+     * The decompressed blocks which are not consumed yet.
+     */
+    CircularQueue<Block> _blocks;
+
+    /**
+     * The decompression thread.
+     */
+    std::thread _thread;
+
+    /**
+     * The exception thrown by the decompression thread (if any).
+     */
+    std::exception_ptr _error;
+
+    /**
+     * The decompressed content which is not yet split into blocks.
+     */
+    Block _pending;
+
+    /**
+     * The position in the pending content before which no more record
+     * boundary can be found.
+     */
+    size_t _scan_from;
+
+    /**
+     * The format of the decompressed content (detected from its first
+     * character).
+     */
+    FileReader::Format _format;
+
+    /**
+     * The decompression thread main function.
+     */
+    void _run();
+
+    /**
+     * Decompress a gzip content sequentially.
+     */
+    void _gunzip();
+
+    /**
+     * Decompress a BGZF content in parallel.
+     */
+    void _bgunzip();
+
+    /**
+     * Decompress a Zstandard content.
+     */
+    void _unzstd();
+
+    /**
+     * Append some decompressed content to the pending one and push as
+     * many blocks as possible.
+     *
+     * \param data The decompressed content.
+     *
+     * \param size The size of the decompressed content.
+     *
+     * \return Returns false if the decompression must stop (since
+     * the queue of blocks is closed).
+     */
+    bool _emit(const char *data, size_t size);
+
+    /**
+     * Push the pending content as blocks of the queue.
+     *
+     * \param all When true, the whole pending content is pushed,
+     * otherwise only complete blocks are pushed.
+     *
+     * \return Returns false if the decompression must stop (since
+     * the queue of blocks is closed).
+     */
+    bool _flush(bool all);
+
+    /**
+     * Find the last record boundary of the pending content.
+     *
+     * \return Returns the offset of the last record starting in the
+     * pending content or 0 if there is no (detectable) record
+     * boundary.
+     */
+    size_t _lastRecordStart();
+
+    /**
+     * For safety, copy constructor is removed.
+     */
+    Decompressor(const Decompressor &) = delete;
+
+    /**
+     * For safety, assignment operator is removed.
+     */
+    Decompressor &operator=(const Decompressor &) = delete;
+
+  public:
+
+    /**
+     * Detect the compression format of the given content.
+     *
+     * \param begin The beginning of the content.
+     *
+     * \param end The end of the content.
+     *
+     * \return Returns the compression format of the content (NONE if
+     * it is not recognized).
+     */
+    static Codec detect(const char *begin, const char *end);
+
+    /**
+     * Check whether the given compression format is supported by this
+     * build.
+     *
+     * \param codec The compression format.
+     *
+     * \return Returns true if the given format can be decompressed.
+     */
+    static bool isSupported(Codec codec);
+
+    /**
+     * Get the name of the given compression format.
+     *
+     * \param codec The compression format.
+     *
+     * \return Returns the name of the given compression format.
+     */
+    static std::string codec2string(Codec codec);
+
+    /**
+     * Prepare the decompression of the given compressed content.
+     *
+     * \param begin The beginning of the compressed content.
+     *
+     * \param end The end of the compressed content.
+     *
+     * \param codec The compression format of the content (which must
+     * be supported).
+     *
+     * \param nb_threads The number of threads used to decompress BGZF
+     * content (if 0 [default], then the number of hardware threads is
+     * used).
+     */
+    Decompressor(const char *begin, const char *end, Codec codec, size_t nb_threads = 0);
+
+    /**
+     * Stop the decompression thread (if running).
+     */
+    ~Decompressor();
+
+    /**
+     * Get the compression format of the content.
+     *
+     * \return Returns the compression format of the content.
+     */
+    inline Codec codec() const {
+      return _codec;
+    }
+
+    /**
+     * Get the number of threads used to decompress BGZF content.
+     *
+     * \return Returns the number of threads used to decompress BGZF
+     * content.
+     */
+    inline size_t getNbThreads() const {
+      return _nb_threads;
+    }
+
+    /**
+     * Set the number of threads used to decompress BGZF content.
+     *
+     * This has no effect once the decompression is started (see
+     * nextBlock()).
+     *
+     * \param nb_threads The number of threads (if 0, then the number
+     * of hardware threads is used).
+     */
+    void setNbThreads(size_t nb_threads);
+
+    /**
+     * Decompress the beginning of the content (without using the
+     * decompression thread).
+     *
+     * This is useful to detect the file format.
+     *
+     * \param size The number of bytes to decompress.
+     *
+     * \return Returns the first (at most) size bytes of the
+     * decompressed content.
+     */
+    std::string head(size_t size) const;
+
+    /**
+     * Get the next block of decompressed content, waiting for it to be
+     * available if needed.
+     *
+     * \param block The block to set.
+     *
+     * \return Returns false once the whole content is decompressed
+     * (the given block is then unchanged). If the decompression has
+     * failed, then the exception thrown by the decompression thread
+     * is rethrown.
+     */
+    bool nextBlock(Block &block);
+
+  };
+
+}
+
+#endif
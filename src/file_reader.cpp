@@ -55,7 +55,9 @@ using namespace std;
 BEGIN_BIJECTHASH_NAMESPACE
 
 FileReader::FileReader(size_t kmer_length, const string &filename, bool verbose):
-  _k(kmer_length), _filename(), verbose(verbose)
+  _k(kmer_length), _filename(),
+  _current_kmer_packed(0),
+  verbose(verbose)
 {
   open(filename);
 }
@@ -153,6 +155,7 @@ bool FileReader::_nextKmerFromFasta() {
       case 'u':
       case 'U':
         _current_kmer += toupper(c);
+        _updatePackedKmer(c);
         ++k;
         if (++_current_sequence_length >= _k) {
           ++_current_kmer_id;
@@ -312,6 +315,7 @@ bool FileReader::_nextKmerFromFastq() {
       case 'u':
       case 'U':
         _current_kmer += toupper(c);
+        _updatePackedKmer(c);
         ++k;
         if (++_current_sequence_length >= _k) {
           ++_current_kmer_id;
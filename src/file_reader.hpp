@@ -44,7 +44,9 @@
 #ifndef __FILE_READER_HPP__
 #define __FILE_READER_HPP__
 
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <string>
 
@@ -128,6 +130,28 @@ namespace bijecthash {
      */
     size_t _current_kmer_id;
 
+    /**
+     * The current k-mer encoded using two bits per nucleotide (only
+     * relevant when \f$k \leq 32\f$).
+     *
+     * This word is updated in constant time for each nucleotide.
+     */
+    uint64_t _current_kmer_packed;
+
+    /**
+     * Append the given nucleotide to the packed current k-mer.
+     *
+     * \param c The nucleotide symbol.
+     */
+    inline void _updatePackedKmer(char c) {
+      const uint64_t code = encodeNucleotide(c);
+      const size_t l = (_k < 32 ? _k : 32);
+      _current_kmer_packed = (_current_kmer_packed << 2) | code;
+      if (l < 32) {
+        _current_kmer_packed &= (1ull << (2 * l)) - 1;
+      }
+    }
+
     /**
      * Load the next available k-mer from the current file assuming it
      * is Fasta formatted.
@@ -165,6 +189,20 @@ namespace bijecthash {
      * attribute).
      */
     FileReader(const size_t kmer_length, const std::string &filename = "", bool verbose = true);
+
+    /**
+     * Get the 2-bit encoding of the given nucleotide.
+     *
+     * \param c The nucleotide symbol (either A, C, G, T or U, in upper
+     * or lower case).
+     *
+     * \return Returns 0 for A, 1 for C, 2 for G and 3 for T (or U). The
+     * result is not relevant for any other symbol.
+     */
+    static inline uint64_t encodeNucleotide(char c) {
+      return ((c >> 1) ^ (c >> 2)) & 3;
+    }
+
     /**
      * The verbosity status of the reader.
      */
@@ -260,10 +298,28 @@ namespace bijecthash {
      * \return Returns the current k-mer of the currently processed
      * sequence or the empty string if no sequence is being processed.
      */
-    inline std::string getCurrentKmer() const {
+    inline const std::string &getCurrentKmer() const {
       return _current_kmer;
     }
 
+    /**
+     * Get the current k-mer encoded using two bits per nucleotide.
+     *
+     * The nucleotides are encoded such that A <=> 00, C <=> 01, G <=>
+     * 10 and T (or U) <=> 11, the first nucleotide of the k-mer being
+     * encoded by the most significant (used) bits (which is the
+     * encoding used by the transformers).
+     *
+     * This is only available when \f$k \leq 32\f$.
+     *
+     * \return Returns the packed current k-mer (the value is not
+     * relevant if no k-mer is available).
+     */
+    inline uint64_t getCurrentKmerPacked() const {
+      assert(_k <= 32);
+      return _current_kmer_packed;
+    }
+
     /**
      * Get the current k-mer ID.
      *
@@ -0,0 +1,111 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#include "kmer_block.hpp"
+
+#include "common.hpp"
+
+using namespace std;
+
+BEGIN_BIJECTHASH_NAMESPACE
+
+const size_t KmerBlock::default_capacity = 4096;
+
+/**
+ * The 2-bit code of each (upper case) nucleotide symbol.
+ */
+static const struct _NucleotideCodes {
+  uint8_t code[256];
+  _NucleotideCodes(): code() {
+    code['C'] = 1;
+    code['G'] = 2;
+    code['T'] = code['U'] = 3;
+  }
+} _nucleotide_codes;
+
+KmerBlock::KmerBlock(size_t k, size_t capacity):
+  _k(k), _nb_words((k + 31) / 32), _capacity(capacity), _size(0),
+  _words(_nb_words * capacity)
+{}
+
+void KmerBlock::clear() {
+  _size = 0;
+  _words.resize(_nb_words * _capacity);
+}
+
+void KmerBlock::add(string_view kmer) {
+  assert(!full());
+  assert(kmer.length() == _k);
+  uint64_t *w = &_words[_size * _nb_words];
+  const char *s = kmer.data();
+  size_t n = _k;
+  while (n) {
+    size_t l = (n < 32 ? n : 32);
+    uint64_t v = 0;
+    for (size_t i = 0; i < l; ++i) {
+      assert((s[i] == 'A') || (s[i] == 'C') || (s[i] == 'G') || (s[i] == 'T') || (s[i] == 'U'));
+      v = (v << 2) | _nucleotide_codes.code[(unsigned char) s[i]];
+    }
+    *w++ = v;
+    s += l;
+    n -= l;
+  }
+  ++_size;
+}
+
+void KmerBlock::get(size_t i, string &kmer) const {
+  assert(i < _size);
+  kmer.resize(_k);
+  const uint64_t *w = &_words[i * _nb_words];
+  size_t start = 0;
+  while (start < _k) {
+    size_t l = (_k - start < 32 ? _k - start : 32);
+    uint64_t v = *w++;
+    for (size_t j = l; j--; v >>= 2) {
+      kmer[start + j] = "ACGT"[v & 3];
+    }
+    start += l;
+  }
+}
+
+END_BIJECTHASH_NAMESPACE
@@ -0,0 +1,238 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifndef __KMER_BLOCK_HPP__
+#define __KMER_BLOCK_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bijecthash {
+
+  /**
+   * A block of 2-bit encoded k-mers.
+   *
+   * The k-mer collectors and processors exchange such blocks instead
+   * of single k-mers in order to amortize the cost of the queue
+   * operations (and of the memory allocations) over many k-mers.
+   *
+   * Each nucleotide is encoded using two bits with A <=> 00, C <=> 01,
+   * G <=> 10 and T (or U) <=> 11. A k-mer is stored on
+   * \f$\lceil k / 32 \rceil\f$ consecutive 64 bits words, each word
+   * encoding (right aligned) up to 32 consecutive nucleotides of the
+   * k-mer.
+   */
+  class KmerBlock {
+
+  private:
+
+    /**
+     * The k-mer length.
+     */
+    size_t _k;
+
+    /**
+     * The number of 64 bits words needed to encode one k-mer.
+     */
+    size_t _nb_words;
+
+    /**
+     * The maximal number of k-mers this block can store.
+     */
+    size_t _capacity;
+
+    /**
+     * The number of k-mers stored in this block.
+     */
+    size_t _size;
+
+    /**
+     * The encoded k-mers.
+     */
+    std::vector<uint64_t> _words;
+
+  public:
+
+    /**
+     * The default number of k-mers per block.
+     */
+    static const size_t default_capacity;
+
+    /**
+     * Builds an empty block of k-mers.
+     *
+     * \param k The length of the k-mers to store (*i.e.*, the value
+     * of \f$k\f$).
+     *
+     * \param capacity The maximal number of k-mers this block can
+     * store.
+     */
+    KmerBlock(size_t k = 0, size_t capacity = 0);
+
+    /**
+     * Get the k-mer length.
+     *
+     * \return Returns the length of the k-mers stored in this block.
+     */
+    inline size_t k() const {
+      return _k;
+    }
+
+    /**
+     * Get the number of k-mers stored in this block.
+     *
+     * \return Returns the number of k-mers stored in this block.
+     */
+    inline size_t size() const {
+      return _size;
+    }
+
+    /**
+     * Get the maximal number of k-mers this block can store.
+     *
+     * \return Returns the maximal number of k-mers this block can
+     * store.
+     */
+    inline size_t capacity() const {
+      return _capacity;
+    }
+
+    /**
+     * Check if this block is empty.
+     *
+     * \return Returns true if this block stores no k-mer.
+     */
+    inline bool empty() const {
+      return _size == 0;
+    }
+
+    /**
+     * Check if this block is full.
+     *
+     * \return Returns true if no more k-mer can be added to this block.
+     */
+    inline bool full() const {
+      return _size == _capacity;
+    }
+
+    /**
+     * Remove all the k-mers of this block (and ensure the storage is
+     * available for capacity() k-mers).
+     */
+    void clear();
+
+    /**
+     * Add the given k-mer at the end of this block.
+     *
+     * The block must not be full.
+     *
+     * \param kmer The k-mer to add (its length must be k() and it
+     * must only contain A, C, G, T or U symbols).
+     */
+    void add(std::string_view kmer);
+
+    /**
+     * Add the given packed k-mer at the end of this block.
+     *
+     * The block must not be full and k() must not exceed 32.
+     *
+     * \param kmer The k-mer encoded using two bits per nucleotide
+     * (see MappedFileReader::getCurrentKmerPacked()).
+     */
+    inline void add(uint64_t kmer) {
+      assert(!full());
+      assert(_nb_words == 1);
+      _words[_size++] = kmer;
+    }
+
+    /**
+     * Get the k-mer at the given position of this block.
+     *
+     * \param i The position of the k-mer in this block (must be less
+     * than size()).
+     *
+     * \param kmer The string where to store the decoded k-mer (it is
+     * resized to k(), thus if its capacity is enough, no allocation
+     * is performed).
+     */
+    void get(size_t i, std::string &kmer) const;
+
+    /**
+     * Get the i-th 64 bits word encoding the k-mer at the given position
+     * of this block.
+     *
+     * \param i The position of the k-mer in this block (must be less
+     * than size()).
+     *
+     * \param w The word to get (must be less than \f$\lceil k / 32
+     * \rceil\f$).
+     *
+     * \return Returns the w-th word encoding the i-th k-mer.
+     */
+    inline uint64_t word(size_t i, size_t w = 0) const {
+      assert(i < _size);
+      assert(w < _nb_words);
+      return _words[i * _nb_words + w];
+    }
+
+    /**
+     * Get the 64 bits words encoding the k-mers of this block.
+     *
+     * \return Returns the \f$\lceil k / 32 \rceil \times size()\f$
+     * consecutive words encoding the k-mers of this block (the words
+     * of the i-th k-mer start at index \f$i \times \lceil k / 32
+     * \rceil\f$).
+     */
+    inline const uint64_t *words() const {
+      return _words.data();
+    }
+
+  };
+
+}
+
+#endif
@@ -53,58 +53,89 @@ using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
-KmerCollector::KmerCollector(size_t k, const string &filename, CircularQueue<string> &queue, bool verbose):
-  ThreadedProcessorHelper<KmerCollector, string>(queue),
-  _reader(k, filename, verbose)
+KmerCollector::KmerCollector(size_t k, const string &filename, CircularQueue<KmerBlock> &queue, bool verbose, size_t block_size,
+                             size_t first_byte, size_t last_byte):
+  ThreadedProcessorHelper<KmerCollector, KmerBlock>(queue),
+  _kmer(),
+  _reader(k, "", verbose),
+  block_size(block_size)
 {
-  if (!_reader.isOpen()) {
+  assert(block_size > 0);
+  if (!_reader.open(filename, first_byte, last_byte)) {
     Exception e;
     e << "Error: Unable to open fasta/fastq file '" << filename << "'\n";
     throw e;
   }
+  _kmer.reserve(k);
 }
 
 void KmerCollector::_run() {
   DEBUG_MSG("KmerCollector_" << id << ":"
             << "Starting file = '" << _reader.getFilename() << "' processing.");
 
-  while (_reader.nextKmer()) {
-    string kmer = _reader.getCurrentKmer();
+  KmerBlock block(_reader.k(), block_size);
+  while (nextBlock(block)) {
+    _flush(block);
+  }
+  DEBUG_MSG("KmerCollector_" << id << ":"
+            << "running: " << running() << ":"
+            << "file '" << _reader.getFilename() << "' processed.");
+}
+
+bool KmerCollector::nextBlock(KmerBlock &block) {
+  if ((block.k() != _reader.k()) || (block.capacity() != block_size)) {
+    block = KmerBlock(_reader.k(), block_size);
+  } else {
+    block.clear();
+  }
+  const bool packed = (_reader.k() <= 32);
+  while (!block.full() && _reader.nextKmer()) {
     if (_reader.getCurrentKmerID(false) == 1) {
       DEBUG_MSG("KmerCollector " << id << ":"
                 << "New sequence: '" << _reader.getCurrentSequenceDescription() << "'");
     }
     DEBUG_MSG("KmerCollector_" << id << ":"
-              << "k-mer '" << _reader.getCurrentKmer()
+              << "k-mer '" << _reader.getCurrentKmerView()
               << " (abs_ID: " << _reader.getCurrentKmerID()
               << ",  rel_ID: " << _reader.getCurrentKmerID(false)
               << ")");
 
-    _process(kmer);
-    while (!_queue.push(kmer)) {
-      DEBUG_MSG("KmerCollector_" << id << ":"
-                << "Unable to push k-mer '" << kmer << "." << '\n'
-                << MSG_DBG_HEADER
-                << "KmerCollector_" << id << ":"
-                << "queue size: " << _queue.size()
-                << " (" << (_queue.empty() ? "empty" : "not empty")
-                << ", " << (_queue.full() ? "full" : "not full") << ").");
-      this_thread::yield();
-      this_thread::sleep_for(10ns);
+    if (packed) {
+      uint64_t kmer = _reader.getCurrentKmerPacked();
+      _process(kmer);
+      block.add(kmer);
+    } else {
+      _kmer = _reader.getCurrentKmerView();
+      _process(_kmer);
+      block.add(_kmer);
     }
-    DEBUG_MSG("KmerCollector_" << id << ":"
-              << "k-mer '" << kmer << " pushed successfully." << '\n'
-              << MSG_DBG_HEADER
-              << "KmerCollector_" << id << ":"
-              << "queue size: " << _queue.size()
-              << " (" << (_queue.empty() ? "empty" : "not empty")
-              << ", " << (_queue.full() ? "full" : "not full") << ").");
   }
+  return !block.empty();
+}
+
+void KmerCollector::_flush(KmerBlock &block) {
+#ifdef DEBUG
+  size_t n = block.size();
+#endif
   DEBUG_MSG("KmerCollector_" << id << ":"
-            << "running: " << running() << ":"
-            << "file '" << _reader.getFilename() << "' processed.");
+            << "Pushing a block of " << n << " k-mers." << '\n'
+            << MSG_DBG_HEADER
+            << "KmerCollector_" << id << ":"
+            << "queue size: " << _queue.size()
+            << " (" << (_queue.empty() ? "empty" : "not empty")
+            << ", " << (_queue.full() ? "full" : "not full") << ").");
+  if (!_queue.waitEmplace(std::move(block))) {
+    Exception e;
+    e << "Error: Unable to push a block of k-mers from file '" << _reader.getFilename() << "' (the queue is closed).\n";
+    throw e;
+  }
+  DEBUG_MSG("KmerCollector_" << id << ":"
+            << "Block of " << n << " k-mers pushed successfully.");
+  block.clear();
 }
 
 void KmerCollector::_process(string &__UNUSED__(kmer)) {}
 
+void KmerCollector::_process(uint64_t &__UNUSED__(kmer)) {}
+
 END_BIJECTHASH_NAMESPACE
@@ -45,26 +45,29 @@
 #define __KMER_COLLECTOR_HPP__
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <threaded_processor_helper.hpp>
-#include <file_reader.hpp>
+#include <kmer_block.hpp>
+#include <mapped_file_reader.hpp>
 
 namespace bijecthash {
 
   /**
-   * A k-mer collector helper that stores k-mers in a circular queue.
+   * A k-mer collector helper that stores blocks of k-mers in a
+   * circular queue.
    *
    * This helper class allows to run the k-mer collector in a dedicated
    * thread.
    */
-  class KmerCollector: public ThreadedProcessorHelper<KmerCollector, std::string> {
+  class KmerCollector: public ThreadedProcessorHelper<KmerCollector, KmerBlock> {
 
   private:
 
     /**
      * Read the k-mers from the associated file and store them into the
-     * queue.
+     * queue (by blocks of block_size k-mers).
      *
      * This method will exit only when the file will be entirely
      * parsed. When the queue is full, it waits until some other thread
@@ -75,6 +78,9 @@ namespace bijecthash {
     /**
      * Perform some processing on the given k-mer before enqueuing it.
      *
+     * This method is only called when \f$k > 32\f$ (otherwise, the
+     * k-mers are processed in their packed form).
+     *
      * By default, this does nothing but any derived class can
      * override this method.
      *
@@ -82,15 +88,49 @@ namespace bijecthash {
      */
     virtual void _process(std::string &kmer);
 
+    /**
+     * Perform some processing on the given packed k-mer before
+     * enqueuing it.
+     *
+     * This method is only called when \f$k \leq 32\f$ (see
+     * MappedFileReader::getCurrentKmerPacked() for the encoding).
+     *
+     * By default, this does nothing but any derived class can
+     * override this method.
+     *
+     * \param kmer The packed k-mer to process before enqueuing it.
+     */
+    virtual void _process(uint64_t &kmer);
+
+    /**
+     * Enqueue the given block of k-mers (waiting for some room in the
+     * queue if needed).
+     *
+     * \param block The block of k-mers to enqueue (it is cleared
+     * afterward).
+     */
+    void _flush(KmerBlock &block);
+
+    /**
+     * The current k-mer when \f$k > 32\f$ (reusing the same string
+     * avoids some allocations).
+     */
+    std::string _kmer;
+
   protected:
 
     /**
      * The reader handled by this k-mer collector.
      */
-    FileReader _reader;
+    MappedFileReader _reader;
 
   public:
 
+    /**
+     * The number of k-mers per enqueued block.
+     */
+    const size_t block_size;
+
     /**
      * Builds a k-mer collector.
      *
@@ -99,12 +139,53 @@ namespace bijecthash {
      *
      * \param filename The name of the file to parse (see open() method).
      *
-     * \param queue The queue to feed with k-mers.
+     * \param queue The queue to feed with blocks of k-mers.
      *
      * \param verbose Don't emit warnings when is set to \c
      * false.
+     *
+     * \param block_size The number of k-mers per enqueued block.
+     *
+     * \param first_byte The offset of the first byte of the range of
+     * the file to parse (see MappedFileReader::open()).
+     *
+     * \param last_byte The offset of the byte after the range of the
+     * file to parse (see MappedFileReader::open()).
+     */
+    KmerCollector(size_t k, const std::string &filename, CircularQueue<KmerBlock> &queue, bool verbose = true,
+                  size_t block_size = KmerBlock::default_capacity,
+                  size_t first_byte = 0, size_t last_byte = size_t(-1));
+
+    /**
+     * Set the number of threads used to decompress the associated
+     * file if it is BGZF compressed (see
+     * MappedFileReader::setNbDecompressionThreads()).
+     *
+     * This must be called before the collection starts.
+     *
+     * \param nb_threads The number of threads (if 0, then the number
+     * of hardware threads is used).
+     */
+    inline void setNbDecompressionThreads(size_t nb_threads) {
+      _reader.setNbDecompressionThreads(nb_threads);
+    }
+
+    /**
+     * Read the next k-mers of the associated file into the given
+     * block (until either the block is full or the file is entirely
+     * parsed).
+     *
+     * This allows to use the collector without its own thread (see
+     * ThreadedReaderWriter::run(ThreadPool &)).
+     *
+     * \param block The block to fill. It is cleared first (and
+     * reshaped if its k-mer length or its capacity doesn't match this
+     * collector settings).
+     *
+     * \return Returns true if at least one k-mer was read and false
+     * if the file is entirely parsed.
      */
-    KmerCollector(size_t k, const std::string &filename, CircularQueue<std::string> &queue, bool verbose = true);
+    bool nextBlock(KmerBlock &block);
 
   };
 
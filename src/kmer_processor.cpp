@@ -44,45 +44,58 @@
 #include "kmer_processor.hpp"
 
 #include "common.hpp"
-#include "kmer_collector.hpp"
 #include "locker.hpp"
 
 using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
-KmerProcessor::KmerProcessor(CircularQueue<string> &queue):
-  ThreadedProcessorHelper<KmerProcessor, string>(queue) {}
+KmerProcessor::KmerProcessor(CircularQueue<KmerBlock> &queue):
+  ThreadedProcessorHelper<KmerProcessor, KmerBlock>(queue) {}
 
 void KmerProcessor::_run() {
-  while ((KmerCollector::running() > 0) || !_queue.empty()) {
-    string kmer;
+  KmerBlock block;
+  DEBUG_MSG("KmerProcessor_" << id << ":"
+            << "Running KmerProcessor: " << running() << "/" << counter());
+  while (_queue.waitPop(block)) {
     DEBUG_MSG("KmerProcessor_" << id << ":"
-              << "Running KmerProcessor: " << running() << "/" << counter() << '\n'
+              << "Block of " << block.size() << " k-mers successfully popped." << '\n'
               << MSG_DBG_HEADER << "KmerProcessor_" << id << ":"
               << "queue size: " << _queue.size());
-    bool ok = _queue.pop(kmer);
-    while (!_queue.empty() && !ok) {
-      ok = _queue.pop(kmer);
-      DEBUG_MSG("KmerProcessor_" << id << ":"
-                << "Unable to pop any kmer (queue size: " << _queue.size() << ").");
-      this_thread::yield();
-      this_thread::sleep_for(1ns);
-    }
-    if (ok) {
-      DEBUG_MSG("KmerProcessor_" << id << ":"
-                << "k-mer '" << kmer << "' successfully popped.");
-      _process(kmer);
-    } else {
-      this_thread::yield();
-      this_thread::sleep_for(1ns);
-    }
+    process(block);
   }
+  _end();
   DEBUG_MSG("KmerProcessor_" << id << ":"
             << "running: " << running() << ":"
             << "KmerProcessor_" << id << " has finished.");
 }
 
+void KmerProcessor::process(KmerBlock &block) {
+  if (block.k() <= 32) {
+    _process(block.words(), block.size());
+  } else {
+    string kmer;
+    for (size_t i = 0; i < block.size(); ++i) {
+      block.get(i, kmer);
+      _process(kmer);
+    }
+  }
+  _idle();
+}
+
 void KmerProcessor::_process(string &__UNUSED__(kmer)) {}
 
+void KmerProcessor::_process(uint64_t &__UNUSED__(kmer)) {}
+
+void KmerProcessor::_process(const uint64_t *kmers, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t packed = kmers[i];
+    _process(packed);
+  }
+}
+
+void KmerProcessor::_idle() {}
+
+void KmerProcessor::_end() {}
+
 END_BIJECTHASH_NAMESPACE
@@ -44,28 +44,32 @@
 #ifndef __KMER_PROCESSOR_HPP__
 #define __KMER_PROCESSOR_HPP__
 
+#include <cstdint>
 #include <string>
 
+#include <kmer_block.hpp>
 #include <threaded_processor_helper.hpp>
 
 namespace bijecthash {
 
   /**
-   * A k-mer processor helper that load k-mers from a circular queue.
+   * A k-mer processor helper that load blocks of k-mers from a
+   * circular queue.
    *
    * This helper class allows to run the k-mer processor in a dedicated
    * thread.
    */
-  class KmerProcessor: public ThreadedProcessorHelper<KmerProcessor, std::string> {
+  class KmerProcessor: public ThreadedProcessorHelper<KmerProcessor, KmerBlock> {
 
   private:
 
     /**
-     * Load the k-mers from the queue and process them.
+     * Load the blocks of k-mers from the queue and process each of
+     * their k-mers.
      *
-     * This method will exit only when there is no more running k-mer
-     * collector (see KmerCollector class) AND if the queue is empty. If
-     * one of these two condition is not met, it waits.
+     * This method will exit only when the queue is closed (once all
+     * the k-mer collectors have completed) AND empty. Otherwise, it
+     * sleeps until some block is available.
      */
     void _run() override final;
 
@@ -73,6 +77,9 @@ namespace bijecthash {
      * Perform some processing on the given k-mer after having been
      * dequeued.
      *
+     * This method is only called when \f$k > 32\f$ (otherwise, the
+     * k-mers are processed in their packed form).
+     *
      * By default, this does nothing but any derived class should
      * override this method.
      *
@@ -80,14 +87,74 @@ namespace bijecthash {
      */
     virtual void _process(std::string &kmer);
 
+    /**
+     * Perform some processing on the given packed k-mer after having
+     * been dequeued.
+     *
+     * This method is only called when \f$k \leq 32\f$ (see
+     * KmerBlock for the encoding).
+     *
+     * By default, this does nothing but any derived class should
+     * override this method.
+     *
+     * \param kmer The packed k-mer to process after having been
+     * dequeued.
+     */
+    virtual void _process(uint64_t &kmer);
+
+    /**
+     * Perform some processing on the given batch of packed k-mers
+     * after having been dequeued.
+     *
+     * This method is only called when \f$k \leq 32\f$ (see
+     * KmerBlock for the encoding).
+     *
+     * By default, this calls _process(uint64_t &) on each k-mer, but
+     * derived classes may override this method to amortize the
+     * per-k-mer costs over the whole batch.
+     *
+     * \param kmers The packed k-mers to process after having been
+     * dequeued.
+     *
+     * \param n The number of k-mers to process.
+     */
+    virtual void _process(const uint64_t *kmers, size_t n);
+
+    /**
+     * Perform some processing once a block of k-mers has been
+     * completely processed.
+     *
+     * By default, this does nothing.
+     */
+    virtual void _idle();
+
+    /**
+     * Perform some processing once the queue is closed and empty
+     * (just before the k-mer processor thread ends).
+     *
+     * By default, this does nothing.
+     */
+    virtual void _end();
+
   public:
 
     /**
      * Builds a k-mer processor.
      *
-     * \param queue The queue storing the k-mers to process.
+     * \param queue The queue storing the blocks of k-mers to process.
+     */
+    KmerProcessor(CircularQueue<KmerBlock> &queue);
+
+    /**
+     * Process each k-mer of the given block.
+     *
+     * This allows to use the processor without its own thread (see
+     * ThreadedReaderWriter::run(ThreadPool &)), in which case the
+     * end of processing hook is never called.
+     *
+     * \param block The block of k-mers to process.
      */
-    KmerProcessor(CircularQueue<std::string> &queue);
+    void process(KmerBlock &block);
 
   };
 
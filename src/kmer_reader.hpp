@@ -51,10 +51,16 @@
  */
 
 #include <BijectHash/../../src/circular_queue.hpp>
+#include <BijectHash/../../src/decompressor.hpp>
 #include <BijectHash/../../src/file_reader.hpp>
+#include <BijectHash/../../src/kmer_block.hpp>
 #include <BijectHash/../../src/kmer_collector.hpp>
 #include <BijectHash/../../src/kmer_processor.hpp>
 #include <BijectHash/../../src/locker.hpp>
+#include <BijectHash/../../src/mapped_file_reader.hpp>
+#include <BijectHash/../../src/nucleotide_kernel.hpp>
+#include <BijectHash/../../src/spinlock_circular_queue.hpp>
+#include <BijectHash/../../src/thread_pool.hpp>
 #include <BijectHash/../../src/threaded_processor_helper.hpp>
 
 #endif
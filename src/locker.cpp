@@ -45,20 +45,89 @@
 
 #include "common.hpp"
 
+#include <chrono>
+#include <climits>
+#include <thread>
+#ifdef __linux__
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
 using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
 SpinlockMutex io_mutex;
 
+/*
+ * Hint the processor that the current thread is spinning.
+ */
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+/*
+ * Park the current thread while the given word is equal to the
+ * expected value (spurious wake ups may occur).
+ */
+static void parkOn(atomic<uint32_t> &word, uint32_t expected) {
+#ifdef __linux__
+  static_assert(sizeof(atomic<uint32_t>) == sizeof(uint32_t), "Futexes require plain 32 bits atomic words");
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#else
+  if (word.load() == expected) {
+    this_thread::sleep_for(chrono::microseconds(50));
+  }
+#endif
+}
+
+/*
+ * Wake up all the threads parked on the given word.
+ */
+static void unparkAllOn(atomic<uint32_t> &word) {
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#else
+  (void) word;
+#endif
+}
+
+bool Backoff::spin() {
+  if (_round < spin_rounds) {
+    for (unsigned int i = (1u << _round); i > 0; --i) {
+      cpuRelax();
+    }
+  } else if (_round < spin_rounds + yield_rounds) {
+    this_thread::yield();
+  } else {
+    return false;
+  }
+  ++_round;
+  return true;
+}
+
 void SpinlockMutex::lock() {
   // From https://en.cppreference.com/w/cpp/atomic/atomic_flag
+  Backoff backoff;
   while (_flag.test_and_set(memory_order_acquire)) {
     // Since C++20, it is possible to update atomic_flag's
     // value only when there is a chance to acquire the lock.
     // See also: https://stackoverflow.com/questions/62318642
 #if defined(__cpp_lib_atomic_flag_test)
-    while (lock.test(memory_order_relaxed)); // test lock
+    while (_flag.test(memory_order_relaxed)) { // test lock
+      if (!backoff.spin()) {
+        this_thread::yield();
+      }
+    }
+#else
+    if (!backoff.spin()) {
+      this_thread::yield();
+    }
 #endif
   }
 }
@@ -67,91 +136,163 @@ void SpinlockMutex::unlock() {
   _flag.clear(memory_order_release);
 }
 
+void ReadWriteLock::_park(uint32_t state) {
+  ++_nb_parked;
+  parkOn(_state, state);
+  --_nb_parked;
+}
+
+void ReadWriteLock::_unparkAll() {
+  // Any thread parking after this check has incremented _nb_parked
+  // after the lock state update, thus it won't sleep.
+  if (_nb_parked.load() > 0) {
+    unparkAllOn(_state);
+  }
+}
+
 void ReadWriteLock::requestReadAccess() {
   DEBUG_MSG("Request a read access for " << this);
-  ++_nb_pending_readers;
-  DEBUG_MSG("There is " << (_writer.load()  ? "one" : "no") << " writer process, "
-            << _nb_pending_writers.load() << " pending writers"
-            << ", " << _nb_pending_readers.load() << " pending readers"
-            << " including " << this
-            << " and " << _nb_readers.load() << " readers");
-  // Give priority to pending writers (while they are the most abundant)
-  while (_nb_pending_writers.load() > _nb_pending_readers.load());
-  DEBUG_MSG("Request a locking access for " << this);
-  _mutex.lock(); // Read & write requests are locked
-  DEBUG_MSG("Got the locking access for " << this);
-  while (_writer.load()); // wait until no more writer is working
-  ++_nb_readers;
-  assert(_nb_pending_readers.load() > 0); // this thread is a pending reader...
-  --_nb_pending_readers;
-  DEBUG_MSG("There is " << (_writer.load()  ? "one" : "no") << " writer process, "
-            << _nb_pending_writers.load() << " pending writers"
-            << ", " << _nb_pending_readers.load() << " pending readers"
-            << " and " << _nb_readers.load() << " readers"
-            << " including " << this);
-  DEBUG_MSG("Release the locking access from " << this);
-  _mutex.unlock(); // Read & write requests are unlocked
+  Backoff backoff;
+  uint32_t state = _state.load(memory_order_relaxed);
+  for (;;) {
+    if (!(state & (_writer | _pending_writers_mask))) {
+      assert((state & _readers_mask) != _readers_mask);
+      if (_state.compare_exchange_weak(state, state + _reader, memory_order_acquire, memory_order_relaxed)) {
+        break;
+      }
+    } else {
+      if (!backoff.spin()) {
+        _park(state);
+      }
+      state = _state.load(memory_order_relaxed);
+    }
+  }
   DEBUG_MSG("Read access granted for " << this);
 }
 
 void ReadWriteLock::releaseReadAccess() {
   DEBUG_MSG("Releasing the read access for this (" << this << ") reader");
-  assert(_nb_readers > 0); // This thread must have read grants.
-  --_nb_readers;
+  const uint32_t state = _state.fetch_sub(_reader) - _reader;
+  assert((state & _writer) == 0); // There can't be any writer while reading.
+  if (!(state & _readers_mask)) {
+    // This thread was the last reader.
+    _unparkAll();
+  }
   DEBUG_MSG("Read access released for this (" << this << ") reader.");
-  DEBUG_MSG("There is " << (_writer.load()  ? "one" : "no") << " writer process, "
-            << _nb_pending_writers.load() << " pending writers"
-            << ", " << _nb_pending_readers.load() << " pending readers"
-            << " and " << _nb_readers.load() << " readers"
-            << " not including " << this << " anymore.");
 }
 
 void ReadWriteLock::requestWriteAccess() {
   DEBUG_MSG("Request a write access for this (" << this << ") writer");
-  ++_nb_pending_writers;
-  DEBUG_MSG("There is " << (_writer.load()  ? "one" : "no") << " writer process, "
-            << _nb_pending_writers.load() << " pending writers"
-            << " including " << this
-            << ", " << _nb_pending_readers.load() << " pending readers"
-            << " and " << _nb_readers.load() << " readers"
-            );
-  // Give priority to pending readers (while they are the most abundant)
-  while (_nb_pending_readers.load() > _nb_pending_writers.load());
-  DEBUG_MSG("Request a locking access for " << this);
-  _mutex.lock();
-  DEBUG_MSG("Got the locking access for " << this);
-  // wait for readers to end their tasks
-  while (_nb_readers.load() > 0);
-  DEBUG_MSG("There is " << (_writer.load()  ? "one" : "no") << " writer process, "
-            << _nb_pending_writers.load() << " pending writers"
-            << " including " << this
-            << ", " << _nb_pending_readers.load() << " pending readers"
-            << " and " << _nb_readers.load() << " readers");
-  // wait for writers to end their tasks
-  while (_writer.exchange(true, memory_order_acquire));
-  assert(_nb_readers.load() == 0); // there must not have any new reader...
-  assert(_nb_pending_writers.load() > 0); // this thread is a pending writer...
-  --_nb_pending_writers;
-  DEBUG_MSG("There is " << (_writer.load()  ? "one" : "no") << " writer process, "
-            << " (" << this << "), "
-            << _nb_pending_writers.load() << " pending writers"
-            << ", " << _nb_pending_readers.load() << " pending readers"
-            << " and " << _nb_readers.load() << " readers");
-  DEBUG_MSG("Release the locking access from " << this);
-  _mutex.unlock(); // Read & write requests are unlocked
+  Backoff backoff;
+  uint32_t state = _state.fetch_add(_pending_writer) + _pending_writer;
+  assert(state & _pending_writers_mask); // The pending writers counter must not overflow.
+  for (;;) {
+    if (!(state & (_writer | _readers_mask))) {
+      if (_state.compare_exchange_weak(state, state - _pending_writer + _writer, memory_order_acquire, memory_order_relaxed)) {
+        break;
+      }
+    } else {
+      if (!backoff.spin()) {
+        _park(state);
+      }
+      state = _state.load(memory_order_relaxed);
+    }
+  }
   DEBUG_MSG("Writer access granted for " << this);
 }
 
 void ReadWriteLock::releaseWriteAccess() {
   DEBUG_MSG("Releasing the write access for this (" << this << ") writer");
-  assert(_writer.load() > 0); // This thread must have write grants.
-  _writer.store(false, memory_order_release);
+#ifndef NDEBUG
+  const uint32_t state =
+#endif
+    _state.fetch_sub(_writer);
+  assert(state & _writer); // This thread must have write grants.
+  _unparkAll();
+  DEBUG_MSG("Write access released for this (" << this << ") writer.");
+}
+
+DistributedReadWriteLock::DistributedReadWriteLock():
+  _writer(0), _nb_parked(0)
+{
+  for (auto &slot: _slots) {
+    slot.nb_readers.store(0, memory_order_relaxed);
+  }
+}
+
+atomic_size_t &DistributedReadWriteLock::_threadSlot() {
+  // Each thread is associated to the next slot (in a round-robin
+  // fashion) the first time it uses some distributed lock.
+  static atomic_size_t next_slot(0);
+  static thread_local size_t slot = (next_slot++ % slots_count);
+  return _slots[slot].nb_readers;
+}
+
+void DistributedReadWriteLock::_park() {
+  ++_nb_parked;
+  parkOn(_writer, 1);
+  --_nb_parked;
+}
+
+void DistributedReadWriteLock::requestReadAccess() {
+  DEBUG_MSG("Request a read access for " << this);
+  atomic_size_t &nb_readers = _threadSlot();
+  Backoff backoff;
+  for (;;) {
+    ++nb_readers;
+    // Both the increment above and the check below are sequentially
+    // consistent, thus either the writer sees this reader or this
+    // reader sees the writer.
+    if (!_writer.load()) {
+      break;
+    }
+    --nb_readers;
+    while (_writer.load()) {
+      if (!backoff.spin()) {
+        _park();
+      }
+    }
+  }
+  DEBUG_MSG("Read access granted for " << this);
+}
+
+void DistributedReadWriteLock::releaseReadAccess() {
+  DEBUG_MSG("Releasing the read access for this (" << this << ") reader");
+  assert(_threadSlot() > 0); // This thread must have read grants.
+  _threadSlot().fetch_sub(1, memory_order_release);
+  DEBUG_MSG("Read access released for this (" << this << ") reader.");
+}
+
+void DistributedReadWriteLock::requestWriteAccess() {
+  DEBUG_MSG("Request a write access for this (" << this << ") writer");
+  Backoff backoff;
+  uint32_t expected = 0;
+  while (!_writer.compare_exchange_weak(expected, 1)) {
+    if (!backoff.spin()) {
+      _park();
+    }
+    expected = 0;
+  }
+  // Readers never park, thus the writer doesn't neither.
+  for (auto &slot: _slots) {
+    backoff.reset();
+    while (slot.nb_readers.load() > 0) {
+      if (!backoff.spin()) {
+        this_thread::yield();
+      }
+    }
+  }
+  DEBUG_MSG("Writer access granted for " << this);
+}
+
+void DistributedReadWriteLock::releaseWriteAccess() {
+  DEBUG_MSG("Releasing the write access for this (" << this << ") writer");
+  assert(_writer.load() == 1); // This thread must have write grants.
+  _writer.store(0);
+  if (_nb_parked.load() > 0) {
+    unparkAllOn(_writer);
+  }
   DEBUG_MSG("Write access released for this (" << this << ") writer.");
-  DEBUG_MSG("There is " << (_writer.load()  ? "one" : "no") << " writer process, "
-            << " not including " << this << " anymore."
-            << _nb_pending_writers.load() << " pending writers"
-            << ", " << _nb_pending_readers.load() << " pending readers"
-            << " and " << _nb_readers.load() << " readers");
 }
 
 END_BIJECTHASH_NAMESPACE
@@ -46,6 +46,7 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 
 namespace bijecthash {
 
@@ -155,43 +156,132 @@ namespace bijecthash {
   };
 
 
+  /**
+   * Exponential backoff helper for spinning threads.
+   *
+   * The first calls to spin() busy-wait for an exponentially growing
+   * number of CPU relax instructions, the next ones yield the
+   * processor and finally spin() tells the caller to park the thread
+   * (or to keep on yielding if parking is not possible).
+   */
+  class Backoff {
+
+  private:
+
+    /**
+     * The number of calls to spin() since the last reset.
+     */
+    unsigned int _round;
+
+  public:
+
+    /**
+     * The number of busy-waiting rounds (the last one waits for
+     * \f$2^{\text{spin_rounds} - 1}\f$ CPU relax instructions).
+     */
+    static const unsigned int spin_rounds = 10;
+
+    /**
+     * The number of rounds yielding the processor (after the
+     * busy-waiting ones).
+     */
+    static const unsigned int yield_rounds = 8;
+
+    /**
+     * Creates a new backoff helper.
+     */
+    inline Backoff(): _round(0) {}
+
+    /**
+     * Restart the backoff from its first round.
+     */
+    inline void reset() {
+      _round = 0;
+    }
+
+    /**
+     * Wait a bit (according to the number of previous calls).
+     *
+     * \return Returns true if the calling thread has waited and false
+     * if it has waited long enough to be parked instead (in such case,
+     * it doesn't wait at all).
+     */
+    bool spin();
+
+  };
+
+
   /**
    * A Mutliple Reader - Single Writer (MRSW) mutex.
    *
-   * This mutex is not lock-free since while readers must wait some
-   * writer to end its writing andvice-versa.
+   * The whole lock state is stored in a single 32 bits word (the
+   * writer flag, the number of pending writers and the number of
+   * readers), thus acquiring or releasing the lock is a single atomic
+   * operation when there is no contention.
    *
-   * This MRSW mutex tries to equilibrate the pending readers and
-   * pending writers load.
+   * Waiting threads first spin using an exponential backoff (see the
+   * Backoff class) then are parked (using a futex on Linux) until the
+   * lock state changes.
+   *
+   * Pending writers have priority over new readers (readers can't
+   * starve writers), thus a thread must not request a read access if
+   * it already owns one.
    */
   class ReadWriteLock {
 
   private:
 
     /**
-     * The mutex on the ReadWriteLock instance to add a new reader or writer.
+     * The lock state.
+     *
+     * The bit 0 is the writer flag, the bits 1 to 15 store the number
+     * of pending writers and the bits 16 to 31 store the number of
+     * current readers.
+     */
+    std::atomic<uint32_t> _state;
+
+    /**
+     * The number of parked threads.
+     */
+    std::atomic<uint32_t> _nb_parked;
+
+    /**
+     * The writer flag in the lock state.
      */
-    SpinlockMutex _mutex;
+    static const uint32_t _writer = 1;
 
     /**
-     * The writer flag (true means a writer is writing).
+     * The unit of the pending writers counter in the lock state.
      */
-    std::atomic_bool _writer;
+    static const uint32_t _pending_writer = 1u << 1;
 
     /**
-     * The number of current readers
+     * The mask of the pending writers counter in the lock state.
      */
-    std::atomic_size_t _nb_readers;
+    static const uint32_t _pending_writers_mask = 0x0000FFFEu;
 
     /**
-     * The number of pending readers.
+     * The unit of the readers counter in the lock state.
+     */
+    static const uint32_t _reader = 1u << 16;
+
+    /**
+     * The mask of the readers counter in the lock state.
+     */
+    static const uint32_t _readers_mask = 0xFFFF0000u;
+
+    /**
+     * Park the current thread until the lock state differs from the
+     * given one (or some spurious wake up occurs).
+     *
+     * \param state The expected current lock state.
      */
-    std::atomic_size_t _nb_pending_readers;
+    void _park(uint32_t state);
 
     /**
-     * The number of pending writers.
+     * Wake up all the parked threads (if any).
      */
-    std::atomic_size_t _nb_pending_writers;
+    void _unparkAll();
 
   public:
 
@@ -208,21 +298,138 @@ namespace bijecthash {
     /**
      * Create a MRSW lock.
      */
-    inline ReadWriteLock():
-      _mutex(),
-      _writer(false), _nb_readers(0),
-      _nb_pending_readers(0), _nb_pending_writers(0)
-    {}
+    inline ReadWriteLock(): _state(0), _nb_parked(0) {}
+
+    /**
+     * Request a reader access.
+     *
+     * The current thread waits until there is neither a writer nor a
+     * pending writer, then it is added to the current (multiple)
+     * readers and starts to read.
+     *
+     * Once reading is achieved, the current thread must call the
+     * releaseReadAccess() method.
+     */
+    void requestReadAccess();
+
+    /**
+     * Remove this thread from the current (multiple) readers (and wake
+     * up the parked threads if it was the last reader).
+     */
+    void releaseReadAccess();
+
+    /**
+     * Request a writer access.
+     *
+     * The current thread is added to the pending writers (preventing
+     * new readers to enter) and waits until there is neither a writer
+     * nor a reader, then it moves from the pending writers to the
+     * current (single) writer and starts to write.
+     *
+     * Once writing is achieved, the current thread must call the
+     * releaseWriteAccess() method.
+     */
+    void requestWriteAccess();
+
+    /**
+     * Remove this thread from the current (single) writer (and wake
+     * up the parked threads).
+     */
+    void releaseWriteAccess();
+
+  };
+
+
+  /**
+   * A Mutliple Reader - Single Writer (MRSW) mutex suited to read
+   * mostly phases.
+   *
+   * The readers are counted using one counter per slot, each thread
+   * being associated to some slot and each slot lying on its own
+   * cache line. Thus readers running on distinct cores don't share
+   * any cache line as long as there is no writer. In counterpart,
+   * writers are expensive (they have to check every slot) and such a
+   * lock uses (slightly more than) slots_count cache lines, which
+   * prevents to use it for each sub-index of a k-mer index.
+   *
+   * Pending writers have priority over new readers and a thread must
+   * not request a read access if it already owns one.
+   */
+  class DistributedReadWriteLock {
+
+  public:
+
+    /**
+     * The number of reader counters.
+     */
+    static const size_t slots_count = 64;
+
+  private:
+
+    /**
+     * A reader counter on its own cache line.
+     */
+    struct alignas(64) _Slot {
+
+      /**
+       * The number of readers of the threads associated to this slot.
+       */
+      std::atomic_size_t nb_readers;
+
+    };
+
+    /**
+     * The reader counters.
+     */
+    _Slot _slots[slots_count];
+
+    /**
+     * The writer flag (1 when a writer either owns or is waiting for
+     * the lock and 0 otherwise).
+     */
+    std::atomic<uint32_t> _writer;
+
+    /**
+     * The number of parked threads.
+     */
+    std::atomic<uint32_t> _nb_parked;
+
+    /**
+     * Get the reader counter of the current thread.
+     *
+     * \return Returns the reader counter of the current thread.
+     */
+    std::atomic_size_t &_threadSlot();
+
+    /**
+     * Park the current thread until the writer flag is released (or
+     * some spurious wake up occurs).
+     */
+    void _park();
+
+  public:
+
+    /**
+     * Deleted copy constructor.
+     */
+    DistributedReadWriteLock(const DistributedReadWriteLock &rwl) = delete;
+
+    /**
+     * Deleted assignment operator.
+     */
+    DistributedReadWriteLock &operator=(const DistributedReadWriteLock &) = delete;
+
+    /**
+     * Create a MRSW lock.
+     */
+    DistributedReadWriteLock();
 
     /**
      * Request a reader access.
      *
-     * The current thread is added to the pending readers. If there is
-     * more pending readers than pending writers, then it requests an
-     * exlusive access to the _mutex attribute. The current thread waits
-     * for some eventual writer to end its task then it moves from the
-     * pending readers to the current (multiple) readers, release its
-     * exclusive access and starts to read.
+     * The reader counter of the current thread is incremented, then if
+     * there is some writer, it is decremented back and the current
+     * thread waits for the writer to complete before retrying.
      *
      * Once reading is achieved, the current thread must call the
      * releaseReadAccess() method.
@@ -230,19 +437,15 @@ namespace bijecthash {
     void requestReadAccess();
 
     /**
-     * Simply remove this thread from the current (multiple) readers.
+     * Simply decrement the reader counter of the current thread.
      */
     void releaseReadAccess();
 
     /**
      * Request a writer access.
      *
-     * The current thread is added to the pending writers. If there is
-     * more pending writers than pending readers, then it requests an
-     * exlusive access to the _mutex attribute. The current thread waits
-     * for any eventual readers to end their tasks then it moves from the
-     * pending readers to the current (single) writer, release its exclusive
-     * access and starts to write.
+     * The current thread waits to own the writer flag, then it waits
+     * for every reader counter to be zero before starting to write.
      *
      * Once writing is achieved, the current thread must call the
      * releaseWriteAccess() method.
@@ -250,7 +453,7 @@ namespace bijecthash {
     void requestWriteAccess();
 
     /**
-     * Simply removes this thread from the current (single) writer.
+     * Release the writer flag (and wake up the parked threads).
      */
     void releaseWriteAccess();
 
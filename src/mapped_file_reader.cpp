@@ -0,0 +1,791 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#include "mapped_file_reader.hpp"
+
+#include "common.hpp"
+#include "exception.hpp"
+#include "locker.hpp"
+#include "nucleotide_kernel.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+BEGIN_BIJECTHASH_NAMESPACE
+
+/**
+ * The upper case nucleotide symbols (the k-mers made of such symbols
+ * can be viewed directly in the mapped file content).
+ */
+static const struct _UpperCaseNucleotides {
+  bool is[256];
+  _UpperCaseNucleotides(): is() {
+    is['A'] = is['C'] = is['G'] = is['T'] = is['U'] = true;
+  }
+} _upper_case_nucleotides;
+
+MappedFileReader::MappedFileReader(size_t kmer_length, const string &filename, bool verbose):
+  _k(kmer_length), _filename(),
+  _map_begin(NULL), _map_end(NULL),
+  _decompressor(), _nb_decompression_threads(1), _block(),
+  _chunk_begin(0), _chunk_end(0),
+  _begin(NULL), _cur(NULL), _end(NULL),
+  _current_kmer_packed(0),
+  verbose(verbose)
+{
+  _buffer.reserve(2 * _k);
+  open(filename);
+}
+
+MappedFileReader::MappedFileReader(MappedFileReader &&reader):
+  _k(reader._k), _filename(std::move(reader._filename)),
+  _map_begin(reader._map_begin), _map_end(reader._map_end),
+  _decompressor(std::move(reader._decompressor)),
+  _nb_decompression_threads(reader._nb_decompression_threads),
+  _block(std::move(reader._block)),
+  _chunk_begin(reader._chunk_begin), _chunk_end(reader._chunk_end),
+  _begin(reader._begin), _cur(reader._cur), _end(reader._end),
+  _eof(reader._eof),
+  _line(reader._line), _first_line(reader._first_line), _column(reader._column),
+  _format(reader._format),
+  _current_sequence_description(std::move(reader._current_sequence_description)),
+  _current_sequence_length(reader._current_sequence_length),
+  _current_kmer_length(reader._current_kmer_length),
+  _in_mapping(reader._in_mapping),
+  _contiguous(reader._contiguous),
+  _buffer(std::move(reader._buffer)),
+  _buffer_start(reader._buffer_start),
+  _kmer_id_offset(reader._kmer_id_offset),
+  _current_kmer_id(reader._current_kmer_id),
+  _nb_kmer_ids(reader._nb_kmer_ids),
+  _current_kmer_packed(reader._current_kmer_packed),
+  verbose(reader.verbose)
+{
+  reader._map_begin = reader._map_end = NULL;
+  reader._begin = reader._cur = reader._end = NULL;
+  reader.close();
+}
+
+MappedFileReader::~MappedFileReader() {
+  close();
+}
+
+bool MappedFileReader::open(const string &filename, size_t first_byte, size_t last_byte) {
+  close();
+  if (!filename.empty()) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd != -1) {
+      struct stat st;
+      if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)) {
+        void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+          madvise(p, st.st_size, MADV_SEQUENTIAL);
+          _map_begin = _begin = _cur = static_cast<const char *>(p);
+          _map_end = _end = _map_begin + st.st_size;
+        }
+      }
+      ::close(fd);
+    }
+    if (isOpen()) {
+      _filename = filename;
+      _line = 1;
+      _first_line = 1;
+      _chunk_end = _map_end - _map_begin;
+      const Decompressor::Codec codec = Decompressor::detect(_map_begin, _map_end);
+      char first_char = _peek();
+      if (codec != Decompressor::NONE) {
+        if (Decompressor::isSupported(codec)) {
+          _decompressor.reset(new Decompressor(_map_begin, _map_end, codec, _nb_decompression_threads));
+          const string head = _decompressor->head(1);
+          first_char = head.empty() ? '\0' : head[0];
+        } else {
+          if (verbose) {
+            cerr << "Warning: File '" << filename << "' is " << Decompressor::codec2string(codec)
+                 << " compressed, but this format is not supported." << endl;
+          }
+          first_char = '\0';
+        }
+      }
+      switch (first_char) {
+      case ';':
+      case '>': _format = FileReader::FASTA; break;
+      case '@': _format = FileReader::FASTQ; break;
+      default: close();
+      }
+    }
+    if (isOpen() && _decompressor) {
+      // The decompressed content is parsed block by block (the first
+      // one being loaded by the first call to nextKmer()).
+      _begin = _cur = _end = NULL;
+      _eof = true;
+      if (first_byte > 0) {
+        // Compressed files can't be split.
+        _decompressor.reset();
+        _chunk_begin = _chunk_end;
+      }
+    } else if (isOpen() && ((first_byte > 0) || (last_byte < size_t(_map_end - _map_begin)))) {
+      const size_t size = _map_end - _map_begin;
+      _begin = _cur = _nextRecord(_map_begin + (first_byte < size ? first_byte : size));
+      _end = _nextRecord(_map_begin + (last_byte < size ? last_byte : size));
+      if (_end < _begin) {
+        _end = _begin;
+      }
+      _eof = (_begin == _end);
+      _first_line = (_begin == _map_begin) ? 1 : 0;
+      _chunk_begin = _begin - _map_begin;
+      _chunk_end = _end - _map_begin;
+      DEBUG_MSG("Parsing bytes [" << getChunkBegin() << ", " << getChunkEnd() << ")"
+                << " of file '" << filename << "'");
+    }
+    if (!isOpen()) {
+      close();
+    }
+  }
+  return (_format != FileReader::UNDEFINED);
+}
+
+void MappedFileReader::close() {
+  _filename.clear();
+  if (_map_begin) {
+    munmap(const_cast<char *>(_map_begin), _map_end - _map_begin);
+  }
+  _map_begin = _map_end = NULL;
+  _decompressor.reset();
+  Decompressor::Block().swap(_block);
+  _chunk_begin = _chunk_end = 0;
+  _begin = _cur = _end = NULL;
+  _eof = false;
+  _line = 0;
+  _first_line = 0;
+  _column = 0;
+  _format = FileReader::UNDEFINED;
+  _current_sequence_description.clear();
+  _current_sequence_length = 0;
+  _resetKmer();
+  _kmer_id_offset = 0;
+  _current_kmer_id = 0;
+  _nb_kmer_ids = 0;
+}
+
+size_t MappedFileReader::getLineNumber() const {
+  if (!_first_line && _map_begin) {
+    _first_line = 1 + count(_map_begin, _begin, '\n');
+  }
+  return _line ? _first_line + _line - 1 : 0;
+}
+
+/**
+ * Get the beginning of the line following the given position.
+ *
+ * \param pos Some position of the mapped file content.
+ *
+ * \param end The end of the mapped file content.
+ *
+ * \return Returns the beginning of the line following the one of
+ * the given position or the end of the mapped file content if there
+ * is no such line.
+ */
+static const char *_nextLine(const char *pos, const char *end) {
+  const char *nl = static_cast<const char *>(memchr(pos, '\n', end - pos));
+  return nl ? nl + 1 : end;
+}
+
+void MappedFileReader::setNbDecompressionThreads(size_t nb_threads) {
+  _nb_decompression_threads = nb_threads;
+  if (_decompressor) {
+    _decompressor->setNbThreads(nb_threads);
+  }
+}
+
+Decompressor::Codec MappedFileReader::detectCodec(const string &filename) {
+  char magic[18];
+  ssize_t n = 0;
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd != -1) {
+    n = ::read(fd, magic, sizeof(magic));
+    ::close(fd);
+  }
+  return (n > 0) ? Decompressor::detect(magic, magic + n) : Decompressor::NONE;
+}
+
+bool MappedFileReader::isRecordStart(const char *line, const char *end, Format format) {
+  assert(line < end);
+  if (format == FileReader::FASTA) {
+    return (*line == '>') || (*line == ';');
+  }
+  assert(format == FileReader::FASTQ);
+  if (*line != '@') {
+    return false;
+  }
+  const char *separator = _nextLine(_nextLine(line, end), end);
+  return (separator < end) && (*separator == '+');
+}
+
+const char *MappedFileReader::_nextRecord(const char *pos) const {
+  assert(pos >= _map_begin);
+  assert(pos <= _map_end);
+  if ((pos > _map_begin) && (pos < _map_end) && (pos[-1] != '\n')) {
+    pos = _nextLine(pos, _map_end);
+  }
+  while ((pos < _map_end) && !_isRecordStart(pos)) {
+    pos = _nextLine(pos, _map_end);
+  }
+  return pos;
+}
+
+bool MappedFileReader::_nextBlock() {
+  if (!_decompressor || !_decompressor->nextBlock(_block)) {
+    return false;
+  }
+  // Blocks always start with some record, thus the parsing state is
+  // the one of the end of file, except for the lines and the k-mer IDs.
+  _first_line = getLineNumber();
+  _line = 1;
+  _column = 0;
+  _begin = _cur = _block.data();
+  _end = _begin + _block.size();
+  _eof = (_begin == _end);
+  _current_kmer_id = _nb_kmer_ids;
+  return true;
+}
+
+string_view MappedFileReader::_getline() {
+  if (_cur >= _end) {
+    _eof = true;
+    return string_view();
+  }
+  const char *nl = static_cast<const char *>(memchr(_cur, '\n', _end - _cur));
+  string_view line(_cur, (nl ? nl : _end) - _cur);
+  _cur = (nl ? nl + 1 : _end);
+  return line;
+}
+
+void MappedFileReader::_addNucleotide(const char *pos) {
+  const char c = *pos;
+  _updatePackedKmer(c);
+  const bool upper = _upper_case_nucleotides.is[(unsigned char) c];
+  if (_in_mapping) {
+    if (upper) {
+      ++_current_kmer_length;
+      ++_contiguous;
+      return;
+    }
+    _buffer.assign(pos - _current_kmer_length, _current_kmer_length);
+    _buffer_start = 0;
+    _in_mapping = false;
+  }
+  ++_current_kmer_length;
+  if (upper) {
+    _buffer += c;
+    if (++_contiguous == _current_kmer_length) {
+      // The whole k-mer is now contiguous in the mapped file content.
+      _in_mapping = true;
+      _buffer.clear();
+      _buffer_start = 0;
+    }
+  } else {
+    _buffer += toupper(c);
+    _contiguous = 0;
+  }
+}
+
+void MappedFileReader::_breakContiguity(const char *pos) {
+  if (_in_mapping && _current_kmer_length) {
+    _buffer.assign(pos - _current_kmer_length, _current_kmer_length);
+    _buffer_start = 0;
+    _in_mapping = false;
+  }
+  _contiguous = 0;
+}
+
+void MappedFileReader::_shiftKmer() {
+  if (_current_kmer_length >= _k) {
+    assert(_current_kmer_length == _k);
+    --_current_kmer_length;
+    if (_contiguous > _current_kmer_length) {
+      _contiguous = _current_kmer_length;
+    }
+    if (!_in_mapping) {
+      if (_contiguous == _current_kmer_length) {
+        _in_mapping = true;
+        _buffer.clear();
+        _buffer_start = 0;
+      } else if (++_buffer_start == _k) {
+        _buffer.erase(0, _buffer_start);
+        _buffer_start = 0;
+      }
+    }
+  }
+}
+
+void MappedFileReader::_resetKmer() {
+  _current_kmer_length = 0;
+  _in_mapping = true;
+  _contiguous = 0;
+  _buffer.clear();
+  _buffer_start = 0;
+}
+
+bool MappedFileReader::_loadKmer() {
+  assert(_current_kmer_length == 0);
+  assert(_in_mapping);
+  if ((size_t(_end - _cur) < _k)
+      || (NucleotideKernel::findInvalid(_cur, _k, NucleotideKernel::UPPER_ACGTU) != _k)) {
+    return false;
+  }
+  const size_t l = (_k < 32 ? _k : 32);
+  _current_kmer_packed = NucleotideKernel::pack(_cur + _k - l, l);
+  _current_kmer_length = _contiguous = _k;
+  // Among the k new sequence lengths, only the ones greater than or
+  // equal to k define some k-mer ID.
+  _current_kmer_id += (_current_sequence_length + 1 < _k) ? _current_sequence_length + 1 : _k;
+  _current_sequence_length += _k;
+  _column += _k;
+  _cur += _k;
+  return true;
+}
+
+bool MappedFileReader::_nextKmerFromFasta() {
+
+  assert(_format == FileReader::FASTA);
+  assert(isOpen());
+
+  _shiftKmer();
+
+  // Most of the time, the next k-mer simply ends with the next symbol.
+  if ((_current_kmer_length + 1 == _k)
+      && (_cur < _end) && _upper_case_nucleotides.is[(unsigned char) *_cur]) {
+    assert(!_current_sequence_description.empty());
+    _addNucleotide(_cur++);
+    ++_column;
+    ++_current_sequence_length;
+    ++_current_kmer_id;
+    return true;
+  }
+
+  while (!_eof && (_current_kmer_length < _k)) {
+
+    if (!_current_kmer_length && !_current_sequence_description.empty() && _loadKmer()) {
+      break;
+    }
+
+    const char *pos = _cur;
+    char c = _get();
+    bool warn = verbose;
+    DEBUG_MSG("Processing char '" << c << "'");
+    _column += !_eof;
+    if (_current_sequence_description.empty()) {
+      // Expects a new sequence description header
+      assert((c == '>') || (c == ';'));
+      assert(_column == 1);
+      _current_sequence_description = _getline();
+      _kmer_id_offset = _current_kmer_id;
+      _resetKmer();
+      _current_sequence_length = 0;
+      ++_line;
+      _column = 0;
+    } else {
+      switch (c) {
+      case '\n':
+        ++_line;
+        _column = 0;
+        if ((_peek() == '>') || (_peek() == ';')) {
+          _current_sequence_description.clear();
+        }
+        /* FALLTHROUGH */
+      case ' ':
+      case '.':
+      case '-':
+      case -1:
+        _breakContiguity(pos);
+        warn = false;
+        break;
+      case 'a':
+      case 'A':
+      case 'c':
+      case 'C':
+      case 'g':
+      case 'G':
+      case 't':
+      case 'T':
+      case 'u':
+      case 'U':
+        _addNucleotide(pos);
+        if (++_current_sequence_length >= _k) {
+          ++_current_kmer_id;
+        }
+        break;
+      case 'w':
+      case 'W':
+      case 's':
+      case 'S':
+      case 'p':
+      case 'P':
+      case 'y':
+      case 'Y':
+      case 'k':
+      case 'K':
+      case 'm':
+      case 'M':
+      case 'b':
+      case 'B':
+      case 'd':
+      case 'D':
+      case 'h':
+      case 'H':
+      case 'v':
+      case 'V':
+      case 'n':
+      case 'N':
+        _resetKmer();
+        if (verbose) {
+          io_mutex.lock();
+          cerr << "Warning: "
+               << "file '" << _filename
+               << "' (line " << getLineNumber() << ", column " << _column << "):"
+               << " degeneracy symbol '" << c << "'"
+               << " found in sequence '" << _current_sequence_description << "'."
+               << endl;
+          io_mutex.unlock();
+        }
+        if (++_current_sequence_length >= _k) {
+          ++_current_kmer_id;
+        }
+        break;
+      case ';':
+        // Comment until the end of line
+        _breakContiguity(pos);
+        _getline();
+        ++_line;
+        _column = 0;
+        break;
+      default:
+        _breakContiguity(pos);
+        if (verbose) {
+          io_mutex.lock();
+          cerr << "Warning: "
+               << "file '" << _filename
+               << "' (line " << getLineNumber() << ", column " << _column << "):"
+               << " unexpected symbol '" << c << "'"
+               << " for sequence '" << _current_sequence_description << "'."
+               << endl;
+          io_mutex.unlock();
+        }
+        warn = false;
+      }
+    }
+    warn &= (_current_kmer_length < _k);
+    warn &= (_current_sequence_length >= _k);
+    if (warn) {
+      io_mutex.lock();
+      cerr << "The k-mer with absolute ID " << getCurrentKmerID()
+           << " and relative ID " << getCurrentKmerID(false)
+           << " is ignored since it contains some degeneracy symbols."
+           << endl;
+      io_mutex.unlock();
+    }
+  }
+
+  if (_current_kmer_length != _k) {
+    _current_sequence_description.clear();
+    _current_sequence_length = 0;
+    _resetKmer();
+    _kmer_id_offset = 0;
+    _nb_kmer_ids = getNbKmerIDs();
+    _current_kmer_id = 0;
+  } else {
+    DEBUG_MSG("current sequence description: " << getCurrentSequenceDescription());
+    DEBUG_MSG("current kmer: " << getCurrentKmerView() << " (abs. ID: " << getCurrentKmerID() << ", rel. ID: " << getCurrentKmerID(false) << ")");
+  }
+
+  return (_current_kmer_length == _k);
+
+}
+
+bool MappedFileReader::_nextKmerFromFastq() {
+
+  assert(_format == FileReader::FASTQ);
+  assert(isOpen());
+
+  _shiftKmer();
+
+  // Most of the time, the next k-mer simply ends with the next symbol.
+  if ((_current_kmer_length + 1 == _k)
+      && (_cur < _end) && _upper_case_nucleotides.is[(unsigned char) *_cur]) {
+    assert(!_current_sequence_description.empty());
+    _addNucleotide(_cur++);
+    ++_column;
+    ++_current_sequence_length;
+    ++_current_kmer_id;
+    return true;
+  }
+
+  int state = !_current_sequence_description.empty();
+
+  size_t nb = 0;
+
+  while (!_eof && (_current_kmer_length < _k)) {
+
+    if ((state == 1) && !_current_kmer_length && _loadKmer()) {
+      break;
+    }
+
+    const char *pos = _cur;
+    char c = _get();
+    bool warn = verbose;
+
+    DEBUG_MSG("Processing char '" << c << "'");
+    _column += !_eof;
+    switch (state) {
+
+    case 0: {
+      DEBUG_MSG("State 0 (expecting sequence header)");
+      assert(_current_sequence_description.empty());
+      // Expects a new sequence description header
+      assert(c == '@');
+      assert(_column == 1);
+      _current_sequence_description = _getline();
+      _kmer_id_offset = _current_kmer_id;
+      _resetKmer();
+      _current_sequence_length = 0;
+      ++_line;
+      _column = 0;
+      state = 1;
+      break;
+    }
+
+    case 1: {
+      DEBUG_MSG("State 1 (processing nucl. sequence)");
+      switch (c) {
+      case '\n':
+        ++_line;
+        _column = 0;
+        if (_peek() == '+') {
+          nb = _current_sequence_length;
+          state = 2;
+        }
+        /* FALLTHROUGH */
+      case ' ':
+      case '.':
+      case '-':
+        _breakContiguity(pos);
+        warn = false;
+        break;
+      case 'a':
+      case 'A':
+      case 'c':
+      case 'C':
+      case 'g':
+      case 'G':
+      case 't':
+      case 'T':
+      case 'u':
+      case 'U':
+        _addNucleotide(pos);
+        if (++_current_sequence_length >= _k) {
+          ++_current_kmer_id;
+        }
+        break;
+      case 'w':
+      case 'W':
+      case 's':
+      case 'S':
+      case 'p':
+      case 'P':
+      case 'y':
+      case 'Y':
+      case 'k':
+      case 'K':
+      case 'm':
+      case 'M':
+      case 'b':
+      case 'B':
+      case 'd':
+      case 'D':
+      case 'h':
+      case 'H':
+      case 'v':
+      case 'V':
+      case 'n':
+      case 'N':
+        _resetKmer();
+        if (verbose) {
+          io_mutex.lock();
+          cerr << "Warning: "
+               << "file '" << _filename
+               << "' (line " << getLineNumber() << ", column " << _column << "):"
+               << " degeneracy symbol '" << c << "'"
+               << " found in sequence '" << _current_sequence_description << "'."
+               << endl;
+          io_mutex.unlock();
+        }
+        if (++_current_sequence_length >= _k) {
+          ++_current_kmer_id;
+        }
+        break;
+      default:
+        _breakContiguity(pos);
+        if (verbose) {
+          io_mutex.lock();
+          cerr << "Warning: "
+               << "file '" << _filename
+               << "' (line " << getLineNumber() << ", column " << _column << "):"
+               << " unexpected symbol '" << c << "'"
+               << " for sequence '" << _current_sequence_description << "'."
+               << endl;
+          io_mutex.unlock();
+        }
+        warn = false;
+      }
+      break;
+    }
+
+    case 2: {
+      DEBUG_MSG("State 2 (sequence separator)");
+      assert(c == '+');
+      assert(_column == 1);
+      string_view desc = _getline();
+      _column += desc.length();
+      if (verbose && !(desc.empty() || (desc == _current_sequence_description))) {
+        io_mutex.lock();
+        cerr << "Warning: "
+             << "file '" << _filename
+             << "' (line " << getLineNumber() << ", column " << _column << "):"
+             << " repeated sequence description '" << desc << "'"
+             << " doesn't match with '" << _current_sequence_description << "'."
+             << endl;
+        io_mutex.unlock();
+      }
+      ++_line;
+      _column = 0;
+      state = 3;
+      break;
+    }
+
+    case 3: {
+      DEBUG_MSG("State 3 (processing quality for the remaining " << nb << "symbols)");
+      if (c == '\n') {
+        ++_line;
+        _column = 0;
+        if ((nb == 0) && (_peek() == '@')) {
+          state = 0;
+          _current_sequence_description.clear();
+        }
+        break;
+      }
+      if (_eof) {
+        break;
+      }
+      // Process the whole quality line at once.
+      const char *eol = static_cast<const char *>(memchr(_cur, '\n', _end - _cur));
+      if (!eol) {
+        eol = _end;
+      }
+      _column += eol - _cur;
+      for (--_cur; _cur < eol; ++_cur) {
+        c = *_cur;
+        if (c > ' ') {
+          assert(nb);
+          --nb;
+        } else if (verbose && (c != ' ') && (c != -1)) {
+          io_mutex.lock();
+          cerr << "Warning: "
+               << "file '" << _filename
+               << "' (line " << getLineNumber() << ", column " << (_column - (eol - _cur) + 1) << "):"
+               << " unexpected symbol with ASCII code " << hex << (int) c << dec
+               << " for sequence '" << _current_sequence_description << "'."
+               << endl;
+          io_mutex.unlock();
+        }
+      }
+      break;
+    }
+
+    default:
+      Exception e;
+      e << "BUG: this situation should never occur!!! "
+        << "     "
+        << "file '" << _filename
+        << "' (line " << getLineNumber() << ", column " << _column << "):"
+        << " character '" << c << "'"
+        << " for sequence '" << _current_sequence_description << "'.\n";
+      throw e;
+    }
+
+    warn &= (state == 1);
+    warn &= (_current_kmer_length < _k);
+    warn &= (_current_sequence_length >= _k);
+    if (warn) {
+      io_mutex.lock();
+      cerr << "The k-mer with absolute ID " << getCurrentKmerID()
+           << " and relative ID " << getCurrentKmerID(false)
+           << " is ignored since it contains some degeneracy symbols."
+           << endl;
+      io_mutex.unlock();
+    }
+  }
+
+  if (_current_kmer_length != _k) {
+    _current_sequence_description.clear();
+    _current_sequence_length = 0;
+    _resetKmer();
+    _kmer_id_offset = 0;
+    _nb_kmer_ids = getNbKmerIDs();
+    _current_kmer_id = 0;
+  } else {
+    DEBUG_MSG("current sequence description: " << getCurrentSequenceDescription());
+    DEBUG_MSG("current kmer: " << getCurrentKmerView() << " (abs. ID: " << getCurrentKmerID() << ", rel. ID: " << getCurrentKmerID(false) << ")");
+  }
+
+  return (_current_kmer_length == _k);
+}
+
+END_BIJECTHASH_NAMESPACE
@@ -0,0 +1,756 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifndef __MAPPED_FILE_READER_HPP__
+#define __MAPPED_FILE_READER_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <decompressor.hpp>
+#include <file_reader.hpp>
+
+namespace bijecthash {
+
+  /**
+   * File reader to extract k-mers from fasta/fastq files using a
+   * memory mapping of the file.
+   *
+   * This reader has exactly the same behavior than the FileReader
+   * (same k-mers, same absolute and relative k-mer IDs, same line and
+   * column numbers and same warnings), but instead of extracting the
+   * file content one character at a time from a stream, it scans the
+   * mapped file content directly (using memchr() to skip the header,
+   * comment, separator and quality lines).
+   *
+   * Whenever possible, the current k-mer is a view on the mapped file
+   * content (thus no copy is performed). This is not possible when
+   * the k-mer spans several lines or contains either lower case
+   * nucleotides or ignored symbols. In such case, the k-mer is
+   * rebuilt into an internal buffer until the k-mer becomes
+   * contiguous in the mapped file again.
+   *
+   * The reader can also be restricted to some chunk of the file (see
+   * open()), which allows to parse a single file using several
+   * readers in parallel. In such case, the absolute k-mer IDs and
+   * the line numbers are the same as if the whole file was parsed,
+   * except that the absolute k-mer IDs are shifted by the number of
+   * k-mer IDs of the preceding chunks (see getNbKmerIDs()).
+   */
+  class MappedFileReader {
+
+  public:
+
+    /**
+     * The file format (same as the FileReader one).
+     */
+    typedef FileReader::Format Format;
+
+  private:
+
+    /**
+     * The length of k-mers to extract from the file (*i.e.*, the value of \f$k\f$).
+     */
+    size_t _k;
+
+    /**
+     * The currently associated filename.
+     */
+    std::string _filename;
+
+    /**
+     * The beginning of the mapped file content (NULL if no file is
+     * mapped).
+     */
+    const char *_map_begin;
+
+    /**
+     * The end of the mapped file content.
+     */
+    const char *_map_end;
+
+    /**
+     * The decompressor of the mapped file content (NULL if the file
+     * is not compressed).
+     */
+    std::unique_ptr<Decompressor> _decompressor;
+
+    /**
+     * The number of threads used to decompress BGZF files (see
+     * setNbDecompressionThreads()).
+     */
+    size_t _nb_decompression_threads;
+
+    /**
+     * The current block of decompressed content (only relevant for
+     * compressed files).
+     */
+    Decompressor::Block _block;
+
+    /**
+     * The offset in the file of the parsed chunk.
+     */
+    size_t _chunk_begin;
+
+    /**
+     * The offset in the file of the end of the parsed chunk.
+     */
+    size_t _chunk_end;
+
+    /**
+     * The beginning of the parsed chunk of the mapped file content
+     * (or of the current block of decompressed content).
+     */
+    const char *_begin;
+
+    /**
+     * The position of the next character to process in the mapped
+     * file content.
+     */
+    const char *_cur;
+
+    /**
+     * The end of the parsed chunk of the mapped file content (or of
+     * the current block of decompressed content).
+     */
+    const char *_end;
+
+    /**
+     * This is set to true when an attempt to read past the end of
+     * the mapped file content is done (this mimics the failbit of
+     * the input streams).
+     */
+    bool _eof;
+
+    /**
+     * The number of the current line in the parsed chunk (starting at
+     * 1, if no file is open then 0).
+     */
+    size_t _line;
+
+    /**
+     * The number in the file of the first line of the parsed chunk (0
+     * until it is needed, since this requires to scan the file from
+     * its beginning up to the chunk).
+     */
+    mutable size_t _first_line;
+
+    /**
+     * The number of the current column in the file (starting at 1, if
+     * no file is open then 0).
+     */
+    size_t _column;
+
+    /**
+     * The file format.
+     */
+    Format _format;
+
+    /**
+     * The current sequence description (empty if no k-mer is
+     * available).
+     */
+    std::string _current_sequence_description;
+
+    /**
+     * The current sequence length (until the end of the current k-mer)
+     */
+    size_t _current_sequence_length;
+
+    /**
+     * The number of nucleotides of the current (possibly partial)
+     * k-mer.
+     */
+    size_t _current_kmer_length;
+
+    /**
+     * When true, the current (possibly partial) k-mer is the
+     * _current_kmer_length characters before the _cur position,
+     * otherwise it is stored in the _buffer.
+     */
+    bool _in_mapping;
+
+    /**
+     * The number of trailing nucleotides of the current (possibly
+     * partial) k-mer which are also contiguous upper case
+     * nucleotides in the mapped file content (before the _cur
+     * position).
+     */
+    size_t _contiguous;
+
+    /**
+     * The buffer storing the current (possibly partial) k-mer (from
+     * position _buffer_start) when it is not contiguous in the mapped
+     * file content.
+     */
+    std::string _buffer;
+
+    /**
+     * The position of the current (possibly partial) k-mer in the
+     * _buffer (shifting the k-mer only moves this position, the
+     * buffer being compacted only once in a while).
+     */
+    size_t _buffer_start;
+
+    /**
+     * The offset needed to compute the relative ID of the current k-mer
+     * using its absolute ID (this is the absolute ID of the last k-mer
+     * of the previous sequence).
+     */
+    size_t _kmer_id_offset;
+
+    /**
+     * The absolute ID of the current k-mer.
+     */
+    size_t _current_kmer_id;
+
+    /**
+     * The number of k-mer IDs of the parsed chunk, which is set once
+     * its end is reached (since the _current_kmer_id is then reset).
+     */
+    size_t _nb_kmer_ids;
+
+    /**
+     * The current k-mer encoded using two bits per nucleotide (only
+     * relevant when \f$k \leq 32\f$).
+     *
+     * This word is updated in constant time for each nucleotide.
+     */
+    uint64_t _current_kmer_packed;
+
+    /**
+     * Append the given nucleotide to the packed current k-mer.
+     *
+     * \param c The nucleotide symbol.
+     */
+    inline void _updatePackedKmer(char c) {
+      const uint64_t code = FileReader::encodeNucleotide(c);
+      const size_t l = (_k < 32 ? _k : 32);
+      _current_kmer_packed = (_current_kmer_packed << 2) | code;
+      if (l < 32) {
+        _current_kmer_packed &= (1ull << (2 * l)) - 1;
+      }
+    }
+
+    /**
+     * Extract the next character of the mapped file content.
+     *
+     * \return Returns the next character or -1 (and set the _eof
+     * flag) if the end of the mapped file content is reached.
+     */
+    inline char _get() {
+      if (_cur < _end) {
+        return *_cur++;
+      }
+      _eof = true;
+      return -1;
+    }
+
+    /**
+     * Get the next character of the mapped file content without
+     * extracting it.
+     *
+     * \return Returns the next character or -1 if the end of the
+     * mapped file content is reached.
+     */
+    inline char _peek() const {
+      return (_cur < _end) ? *_cur : -1;
+    }
+
+    /**
+     * Extract the characters until the end of the current line (the
+     * newline symbol is extracted too).
+     *
+     * If there is no character to extract, the _eof flag is set.
+     *
+     * \return Returns a view on the extracted characters (without
+     * the newline symbol).
+     */
+    std::string_view _getline();
+
+    /**
+     * Check whether some record (*i.e.*, some sequence) starts at the
+     * given line beginning of the mapped file content (see
+     * isRecordStart()).
+     *
+     * \param line The line beginning.
+     *
+     * \return Returns true if a record starts at the given line.
+     */
+    inline bool _isRecordStart(const char *line) const {
+      return isRecordStart(line, _map_end, _format);
+    }
+
+    /**
+     * Find the first record starting at or after the given position of
+     * the mapped file content.
+     *
+     * \param pos Some position of the mapped file content.
+     *
+     * \return Returns the beginning of the first record starting at
+     * or after the given position or the end of the mapped file
+     * content if there is no such record.
+     */
+    const char *_nextRecord(const char *pos) const;
+
+    /**
+     * Append the given nucleotide to the current (possibly partial)
+     * k-mer.
+     *
+     * \param pos The position of the nucleotide symbol in the mapped
+     * file content (it must immediately follow the already extracted
+     * characters).
+     */
+    void _addNucleotide(const char *pos);
+
+    /**
+     * Load a whole k-mer at once from the current position if its
+     * symbols are upper case nucleotides (this avoids processing them
+     * one by one when a new k-mer starts).
+     *
+     * The current k-mer must be empty (see _resetKmer()).
+     *
+     * \return Returns true if the k-mer has been loaded and false
+     * otherwise (then the state is unchanged).
+     */
+    bool _loadKmer();
+
+    /**
+     * Load the next block of decompressed content (only relevant for
+     * compressed files).
+     *
+     * \return Returns true if some block has been loaded and false
+     * if the whole file content has been decompressed (or if the file
+     * is not compressed).
+     */
+    bool _nextBlock();
+
+    /**
+     * Notify that the current (possibly partial) k-mer is no more
+     * contiguous in the mapped file content (since some symbol which
+     * is not part of the k-mer has been extracted).
+     *
+     * \param pos The position of the first extracted symbol which is
+     * not part of the k-mer.
+     */
+    void _breakContiguity(const char *pos);
+
+    /**
+     * Prepare the search of the next k-mer by removing the first
+     * nucleotide of the current k-mer (if any).
+     */
+    void _shiftKmer();
+
+    /**
+     * Discard the current (possibly partial) k-mer.
+     */
+    void _resetKmer();
+
+    /**
+     * Load the next available k-mer from the current file assuming it
+     * is Fasta formatted.
+     *
+     * \return Returns true if a k-mer has been loaded (if the file is
+     * opened and has a k-mer) and false otherwise (if no file is
+     * opened, if the file is opened but is not fasta formatted or if
+     * the file is opened, fasta formatted but contains no more k-mer).
+     */
+    bool _nextKmerFromFasta();
+
+    /**
+     * Load the next available k-mer from the current file assuming it
+     * is Fastq formatted.
+     *
+     * \return Returns true if a k-mer has been loaded (if the file is
+     * opened and has a k-mer) and false otherwise (if no file is
+     * opened, if the file is opened but is not fastq formatted or if
+     * the file is opened, fastq formatted but contains no more k-mer).
+     */
+    bool _nextKmerFromFastq();
+
+    /**
+     * For safety, copy constructor is removed (the mapping can't be
+     * shared).
+     */
+    MappedFileReader(const MappedFileReader &) = delete;
+
+    /**
+     * For safety, assignment operator is removed (the mapping can't
+     * be shared).
+     */
+    MappedFileReader &operator=(const MappedFileReader &) = delete;
+
+  public:
+
+    /**
+     * Constructs a new MappedFileReader instance (and internally call
+     * the open() method)
+     *
+     * \param kmer_length The length of k-mer to extract (*i.e.*, the
+     * value of \f$k\f$).
+     *
+     * \param filename The name of the file to parse (see open() method).
+     *
+     * \param verbose Don't emit warnings when is set to \c
+     * false. This can be changed at any time (see verbose
+     * attribute).
+     */
+    MappedFileReader(const size_t kmer_length, const std::string &filename = "", bool verbose = true);
+
+    /**
+     * Move constructor (the mapping is transferred to the new reader
+     * and the given reader is closed).
+     *
+     * \param reader The reader to move.
+     */
+    MappedFileReader(MappedFileReader &&reader);
+
+    /**
+     * Destructor (unmap the file if needed).
+     */
+    ~MappedFileReader();
+
+    /**
+     * The verbosity status of the reader.
+     */
+    bool verbose;
+
+    /**
+     * Open (and map) the given filename.
+     *
+     * This method closes the opened file if any.
+     *
+     * The parsing can be restricted to some chunk of the file, given
+     * by a byte range. Since such range generally doesn't fit the
+     * record boundaries, the parsed chunk starts at the first record
+     * starting at or after the first byte of the range and ends at
+     * the first record starting at or after the last byte of the
+     * range. Thus, splitting the file size into consecutive byte
+     * ranges gives a partition of its records.
+     *
+     * Compressed files (see Decompressor) are transparently
+     * decompressed while parsed. Since they can't be split, the whole
+     * content is parsed by the chunk starting at the beginning of the
+     * file and the other chunks are empty.
+     *
+     * \param filename The name of the file to parse.
+     *
+     * \param first_byte The offset of the first byte of the range of
+     * the file to parse (by default, from the beginning of the file).
+     *
+     * \param last_byte The offset of the byte after the range of the
+     * file to parse (by default, up to the end of the file).
+     *
+     * \return This returns true if and only if the file exists and is
+     * correctly opened (format is correctly detected and compression
+     * format, if any, is supported).
+     */
+    bool open(const std::string &filename, size_t first_byte = 0, size_t last_byte = size_t(-1));
+
+    /**
+     * Close (and unmap) the currently opened file.
+     */
+    void close();
+
+    /**
+     * Check whether a file is associated to this reader and open.
+     *
+     * \return Returns true if the reader is associated to some file.
+     */
+    inline bool isOpen() const {
+      return _map_begin != NULL;
+    }
+
+    /**
+     * Get the compression format of the currently opened file.
+     *
+     * \return Returns the compression format of the currently opened
+     * file (Decompressor::NONE if it is not compressed).
+     */
+    inline Decompressor::Codec getCodec() const {
+      return _decompressor ? _decompressor->codec() : Decompressor::NONE;
+    }
+
+    /**
+     * Get the number of threads used to decompress BGZF files.
+     *
+     * \return Returns the number of threads used to decompress BGZF
+     * files.
+     */
+    inline size_t getNbDecompressionThreads() const {
+      return _nb_decompression_threads;
+    }
+
+    /**
+     * Set the number of threads used to decompress BGZF files.
+     *
+     * By default, a single thread inflates the BGZF members (in
+     * addition to the decompression thread) since the reader doesn't
+     * know how many threads are already used by the caller.
+     *
+     * This applies to the currently opened file (unless its parsing
+     * is started) and to the next opened ones.
+     *
+     * \param nb_threads The number of threads (if 0, then the number
+     * of hardware threads is used).
+     */
+    void setNbDecompressionThreads(size_t nb_threads);
+
+    /**
+     * Detect the compression format of the given file.
+     *
+     * \param filename The name of the file.
+     *
+     * \return Returns the compression format of the given file
+     * (Decompressor::NONE if it is not compressed or can't be read).
+     */
+    static Decompressor::Codec detectCodec(const std::string &filename);
+
+    /**
+     * Check whether some record (*i.e.*, some sequence) starts at the
+     * given line beginning.
+     *
+     * For the fasta format, this is the case if the line is a header
+     * (starting with either '>' or ';'). For the fastq format, this is
+     * the case if the line starts with '@' and the line after the next
+     * one starts with '+' (a quality line may also start with '@', but
+     * then the line after the next one is a nucleotide sequence).
+     *
+     * \param line The line beginning.
+     *
+     * \param end The end of the content.
+     *
+     * \param format The format of the content.
+     *
+     * \return Returns true if a record starts at the given line.
+     */
+    static bool isRecordStart(const char *line, const char *end, Format format);
+
+    /**
+     * Retrieve the name of the currently opened file.
+     *
+     * \return Returns the name of the currently opened file or an empty
+     * string if no file is opened.
+     */
+    inline std::string getFilename() const {
+      return _filename;
+    }
+
+    /**
+     * Get the offset in the file of the parsed chunk.
+     *
+     * \return Returns the offset of the first byte of the parsed
+     * chunk (see open()).
+     */
+    inline size_t getChunkBegin() const {
+      return _chunk_begin;
+    }
+
+    /**
+     * Get the offset in the file of the end of the parsed chunk.
+     *
+     * \return Returns the offset of the byte after the parsed chunk
+     * (see open()).
+     */
+    inline size_t getChunkEnd() const {
+      return _chunk_end;
+    }
+
+    /**
+     * Get the currently processed line number.
+     *
+     * When only some chunk of the file is parsed, the first call
+     * requires to count the lines preceding the chunk.
+     *
+     * \return Returns the current line number or 0 if no file is
+     * opened.
+     */
+    size_t getLineNumber() const;
+
+    /**
+     * Get the currently processed column number.
+     *
+     * \return Returns the current column number or 0 if no file is
+     * opened.
+     */
+    inline size_t getColumnNumber() const {
+      return _column;
+    }
+
+    /**
+     * Get the length of extracted k-mers.
+     *
+     * \return Returns the length of the extracted k-mers for this reader.
+     */
+    inline size_t k() const {
+      return _k;
+    }
+
+    /**
+     * Get the file format.
+     *
+     * \return This returns the detected file format. If file is not open, then UNDEFINED is returned
+     */
+    inline Format getFormat() const {
+      return _format;
+    }
+
+    /**
+     * Get the description header of the currently processed sequence.
+     *
+     * \return Returns the header description of the currently processed
+     * sequence or the empty string if no sequence is being processed.
+     */
+    inline std::string getCurrentSequenceDescription() const {
+      return _current_sequence_description;
+    }
+
+    /**
+     * Get a view on the current k-mer of the currently processed
+     * sequence.
+     *
+     * The view is valid until the next call to nextKmer() (or to
+     * open() or close()).
+     *
+     * \return Returns the current k-mer of the currently processed
+     * sequence or an empty view if no sequence is being processed.
+     */
+    inline std::string_view getCurrentKmerView() const {
+      if (_current_kmer_length != _k) {
+        return std::string_view();
+      }
+      return (_in_mapping
+              ? std::string_view(_cur - _k, _k)
+              : std::string_view(_buffer.data() + _buffer_start, _k));
+    }
+
+    /**
+     * Get the current k-mer of the currently processed sequence.
+     *
+     * Notice that this method returns a copy of the current k-mer (see
+     * getCurrentKmerView()).
+     *
+     * \return Returns the current k-mer of the currently processed
+     * sequence or the empty string if no sequence is being processed.
+     */
+    inline std::string getCurrentKmer() const {
+      return std::string(getCurrentKmerView());
+    }
+
+    /**
+     * Get the current k-mer encoded using two bits per nucleotide.
+     *
+     * The nucleotides are encoded such that A <=> 00, C <=> 01, G <=>
+     * 10 and T (or U) <=> 11, the first nucleotide of the k-mer being
+     * encoded by the most significant (used) bits (which is the
+     * encoding used by the transformers).
+     *
+     * This is only available when \f$k \leq 32\f$.
+     *
+     * \return Returns the packed current k-mer (the value is not
+     * relevant if no k-mer is available).
+     */
+    inline uint64_t getCurrentKmerPacked() const {
+      assert(_k <= 32);
+      return _current_kmer_packed;
+    }
+
+    /**
+     * Get the current k-mer ID.
+     *
+     * \param absolute If true, returns the absolute ID (among all
+     * sequences of the parsed chunk of the file [default]). If false,
+     * returns the relative ID of the k-mer (the first k-mer of some
+     * sequence has relative ID 1).
+     *
+     * \return Returns the current k-mer ID starting from 1 or 0 if no file is
+     * opened (or no k-mer has been read yet).
+     */
+    inline size_t getCurrentKmerID(bool absolute = true) const {
+      return (absolute
+              ? _current_kmer_id
+              : _current_kmer_id - _kmer_id_offset);
+    }
+
+    /**
+     * Get the number of k-mer IDs used so far.
+     *
+     * Once the parsed chunk is entirely processed, adding this value
+     * to the absolute k-mer IDs of the next chunk gives their absolute
+     * IDs in the whole file.
+     *
+     * \return Returns the number of k-mer IDs used so far (including
+     * the ones of the k-mers ignored because of degeneracy symbols).
+     */
+    inline size_t getNbKmerIDs() const {
+      return (_current_kmer_id > _nb_kmer_ids) ? _current_kmer_id : _nb_kmer_ids;
+    }
+
+    /**
+     * Compute the next available k-mer.
+     *
+     * \return Returns true if some k-mer is available and false
+     * otherwise.
+     */
+    inline bool nextKmer() {
+      bool ok;
+      do {
+        switch (_format) {
+        case FileReader::FASTA: ok = _nextKmerFromFasta(); break;
+        case FileReader::FASTQ: ok = _nextKmerFromFastq(); break;
+        default: return false;
+        }
+      } while (!ok && _nextBlock());
+      return ok;
+    }
+
+  };
+
+}
+
+#endif
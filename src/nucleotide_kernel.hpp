@@ -0,0 +1,550 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifndef __NUCLEOTIDE_KERNEL_HPP__
+#define __NUCLEOTIDE_KERNEL_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#  define NUCLEOTIDE_KERNEL_X86
+#  include <immintrin.h>
+#endif
+
+namespace bijecthash {
+
+  /**
+   * Validation and 2 bits encoding of blocks of nucleotides.
+   *
+   * Each nucleotide is encoded as 0 for A, 1 for C, 2 for G and 3
+   * for T or U (see FileReader::encodeNucleotide()) and the first
+   * nucleotide of a block is the most significant one of its packed
+   * encoding.
+   *
+   * The symbols are classified using two 16 entries tables (indexed
+   * by the low and the high nibbles of the symbols), which is done by
+   * byte shuffles on 16 or 32 symbols at once when the processor
+   * supports SSE4 or AVX2 instructions. The implementation is chosen
+   * at runtime (see bestLevel()), but any supported level can be
+   * explicitly required (which is useful for testing and
+   * benchmarking).
+   *
+   * All methods are defined in this header since this kernel is
+   * shared by the kmer-reader and the kmer-transformers libraries.
+   */
+  class NucleotideKernel {
+
+  public:
+
+    /**
+     * The available implementations (ordered by increasing
+     * requirements).
+     */
+    enum Level {
+      SCALAR, /**< Portable implementation */
+      SSE4,   /**< 16 symbols at once */
+      AVX2    /**< 32 symbols at once */
+    };
+
+    /**
+     * The symbols considered as valid nucleotides (each value is the
+     * union of the classes of symbols given in the tables).
+     */
+    enum Alphabet {
+      UPPER_ACGT = 0x03,  /**< Upper case A, C, G and T */
+      UPPER_ACGTU = 0x07, /**< Upper case A, C, G, T and U */
+      ACGTU = 0x3F        /**< Upper and lower case A, C, G, T and U */
+    };
+
+  private:
+
+    /**
+     * The symbol classes according to their low nibble (A, C and G
+     * end with 1, 3 and 7, T ends with 4 and U ends with 5, whatever
+     * their case).
+     */
+    static constexpr uint8_t _low_nibble_classes[16] = {
+      0x00, 0x09, 0x00, 0x09, 0x12, 0x24, 0x00, 0x09,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+
+    /**
+     * The symbol classes according to their high nibble (0x01 for
+     * upper case A, C and G, 0x02 for T, 0x04 for U, then 0x08, 0x10
+     * and 0x20 for their lower case counterparts).
+     */
+    static constexpr uint8_t _high_nibble_classes[16] = {
+      0x00, 0x00, 0x00, 0x00, 0x01, 0x06, 0x08, 0x30,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+
+    /**
+     * Copy the beginning of some block into a buffer padded with
+     * valid nucleotides (A) of code 0.
+     *
+     * \param buffer The buffer of 64 symbols to fill.
+     *
+     * \param bases The nucleotide symbols.
+     *
+     * \param n The number of symbols to copy (at most 64).
+     */
+    static inline void _pad(char *buffer, const char *bases, size_t n) {
+      assert(n <= 64);
+      memset(buffer + n, 'A', 64 - n);
+      memcpy(buffer, bases, n);
+    }
+
+    /**
+     * Locate the invalid symbols among 32 ones (portable version).
+     *
+     * \param bases The 32 symbols to check.
+     *
+     * \param alphabet The classes of valid symbols.
+     *
+     * \return Returns the mask of invalid symbols.
+     */
+    static inline uint32_t _invalidMask32Scalar(const char *bases, uint8_t alphabet) {
+      uint32_t mask = 0;
+      for (size_t i = 0; i < 32; ++i) {
+        const unsigned char c = bases[i];
+        mask |= uint32_t(!(_low_nibble_classes[c & 15] & _high_nibble_classes[c >> 4] & alphabet)) << i;
+      }
+      return mask;
+    }
+
+    /**
+     * Encode 32 valid nucleotides (portable version).
+     *
+     * \param bases The 32 nucleotides to encode.
+     *
+     * \return Returns the packed encoding of the nucleotides.
+     */
+    static inline uint64_t _pack32Scalar(const char *bases) {
+      uint64_t packed = 0;
+      for (size_t i = 0; i < 32; ++i) {
+        packed = (packed << 2) | (((bases[i] >> 1) ^ (bases[i] >> 2)) & 3);
+      }
+      return packed;
+    }
+
+#ifdef NUCLEOTIDE_KERNEL_X86
+
+    /**
+     * Locate the invalid symbols among 16 ones (SSE4 version).
+     *
+     * \param bases The 16 symbols to check.
+     *
+     * \param alphabet The classes of valid symbols.
+     *
+     * \return Returns the mask of invalid symbols.
+     */
+    __attribute__((target("sse4.2")))
+    static inline uint32_t _invalidMask16SSE4(const char *bases, uint8_t alphabet) {
+      const __m128i low_table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_low_nibble_classes));
+      const __m128i high_table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_high_nibble_classes));
+      const __m128i nibble = _mm_set1_epi8(0x0F);
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bases));
+      const __m128i classes = _mm_and_si128(_mm_shuffle_epi8(low_table, _mm_and_si128(v, nibble)),
+                                            _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble)));
+      const __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(classes, _mm_set1_epi8(alphabet)), _mm_setzero_si128());
+      return uint32_t(_mm_movemask_epi8(invalid));
+    }
+
+    /**
+     * Locate the invalid symbols among 32 ones (SSE4 version).
+     *
+     * \param bases The 32 symbols to check.
+     *
+     * \param alphabet The classes of valid symbols.
+     *
+     * \return Returns the mask of invalid symbols.
+     */
+    __attribute__((target("sse4.2")))
+    static inline uint32_t _invalidMask32SSE4(const char *bases, uint8_t alphabet) {
+      return _invalidMask16SSE4(bases, alphabet) | (_invalidMask16SSE4(bases + 16, alphabet) << 16);
+    }
+
+    /**
+     * Encode 16 valid nucleotides (SSE4 version).
+     *
+     * \param bases The 16 nucleotides to encode.
+     *
+     * \return Returns the packed encoding of the nucleotides.
+     */
+    __attribute__((target("sse4.2")))
+    static inline uint32_t _pack16SSE4(const char *bases) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bases));
+      const __m128i codes = _mm_and_si128(_mm_xor_si128(_mm_srli_epi16(v, 1), _mm_srli_epi16(v, 2)), _mm_set1_epi8(3));
+      // Pairs of codes (c0, c1) become 4*c0+c1 then pairs of pairs
+      // (p0, p1) become 16*p0+p1, thus each 32 bits word holds the
+      // packed encoding of 4 nucleotides in its first byte.
+      const __m128i pairs = _mm_maddubs_epi16(codes, _mm_set1_epi16(0x0104));
+      const __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00010010));
+      const __m128i bytes = _mm_shuffle_epi8(quads, _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1,
+                                                                 -1, -1, -1, -1, -1, -1, -1, -1));
+      return __builtin_bswap32(uint32_t(_mm_cvtsi128_si32(bytes)));
+    }
+
+    /**
+     * Encode 32 valid nucleotides (SSE4 version).
+     *
+     * \param bases The 32 nucleotides to encode.
+     *
+     * \return Returns the packed encoding of the nucleotides.
+     */
+    __attribute__((target("sse4.2")))
+    static inline uint64_t _pack32SSE4(const char *bases) {
+      return (uint64_t(_pack16SSE4(bases)) << 32) | _pack16SSE4(bases + 16);
+    }
+
+    /**
+     * Locate the invalid symbols among 32 ones (AVX2 version).
+     *
+     * \param bases The 32 symbols to check.
+     *
+     * \param alphabet The classes of valid symbols.
+     *
+     * \return Returns the mask of invalid symbols.
+     */
+    __attribute__((target("avx2")))
+    static inline uint32_t _invalidMask32AVX2(const char *bases, uint8_t alphabet) {
+      const __m256i low_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(_low_nibble_classes)));
+      const __m256i high_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(_high_nibble_classes)));
+      const __m256i nibble = _mm256_set1_epi8(0x0F);
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bases));
+      const __m256i classes = _mm256_and_si256(_mm256_shuffle_epi8(low_table, _mm256_and_si256(v, nibble)),
+                                               _mm256_shuffle_epi8(high_table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+      const __m256i invalid = _mm256_cmpeq_epi8(_mm256_and_si256(classes, _mm256_set1_epi8(alphabet)), _mm256_setzero_si256());
+      return uint32_t(_mm256_movemask_epi8(invalid));
+    }
+
+    /**
+     * Encode 32 valid nucleotides (AVX2 version).
+     *
+     * \param bases The 32 nucleotides to encode.
+     *
+     * \return Returns the packed encoding of the nucleotides.
+     */
+    __attribute__((target("avx2")))
+    static inline uint64_t _pack32AVX2(const char *bases) {
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bases));
+      const __m256i codes = _mm256_and_si256(_mm256_xor_si256(_mm256_srli_epi16(v, 1), _mm256_srli_epi16(v, 2)), _mm256_set1_epi8(3));
+      // Same as _pack16SSE4() on both 128 bits lanes.
+      const __m256i pairs = _mm256_maddubs_epi16(codes, _mm256_set1_epi16(0x0104));
+      const __m256i quads = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00010010));
+      const __m256i bytes = _mm256_shuffle_epi8(quads, _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1,
+                                                                       -1, -1, -1, -1, -1, -1, -1, -1,
+                                                                       0, 4, 8, 12, -1, -1, -1, -1,
+                                                                       -1, -1, -1, -1, -1, -1, -1, -1));
+      const uint64_t first = uint32_t(_mm_cvtsi128_si32(_mm256_castsi256_si128(bytes)));
+      const uint64_t last = uint32_t(_mm_cvtsi128_si32(_mm256_extracti128_si256(bytes, 1)));
+      return __builtin_bswap64(first | (last << 32));
+    }
+
+#endif
+
+    /**
+     * Locate the invalid symbols among 32 ones.
+     *
+     * \param bases The 32 symbols to check.
+     *
+     * \param alphabet The classes of valid symbols.
+     *
+     * \param level The implementation to use.
+     *
+     * \return Returns the mask of invalid symbols.
+     */
+    static inline uint32_t _invalidMask32(const char *bases, uint8_t alphabet, Level level) {
+#ifdef NUCLEOTIDE_KERNEL_X86
+      switch (level) {
+      case AVX2: return _invalidMask32AVX2(bases, alphabet);
+      case SSE4: return _invalidMask32SSE4(bases, alphabet);
+      default: break;
+      }
+#endif
+      return _invalidMask32Scalar(bases, alphabet);
+    }
+
+    /**
+     * Encode 32 valid nucleotides.
+     *
+     * \param bases The 32 nucleotides to encode.
+     *
+     * \param level The implementation to use.
+     *
+     * \return Returns the packed encoding of the nucleotides.
+     */
+    static inline uint64_t _pack32(const char *bases, Level level) {
+#ifdef NUCLEOTIDE_KERNEL_X86
+      switch (level) {
+      case AVX2: return _pack32AVX2(bases);
+      case SSE4: return _pack32SSE4(bases);
+      default: break;
+      }
+#endif
+      return _pack32Scalar(bases);
+    }
+
+    /**
+     * Detect the best implementation supported by the running
+     * processor.
+     *
+     * \return Returns the best available implementation level.
+     */
+    static inline Level _detectLevel() {
+#ifdef NUCLEOTIDE_KERNEL_X86
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")) {
+        return AVX2;
+      }
+      if (__builtin_cpu_supports("sse4.2")) {
+        return SSE4;
+      }
+#endif
+      return SCALAR;
+    }
+
+  public:
+
+    /**
+     * Get the best implementation supported by the running processor.
+     *
+     * \return Returns the best available implementation level.
+     */
+    static inline Level bestLevel() {
+      static const Level level = _detectLevel();
+      return level;
+    }
+
+    /**
+     * Get the name of the given implementation level.
+     *
+     * \param level The implementation level.
+     *
+     * \return Returns the name of the given implementation level.
+     */
+    static inline const char *level2string(Level level) {
+      switch (level) {
+      case SCALAR: return "scalar";
+      case SSE4: return "SSE4";
+      case AVX2: return "AVX2";
+      }
+      return "";
+    }
+
+    /**
+     * Locate the invalid symbols of a short block.
+     *
+     * \param bases The symbols to check.
+     *
+     * \param n The number of symbols to check (at most 64).
+     *
+     * \param alphabet The symbols considered as valid nucleotides.
+     *
+     * \param level The implementation to use.
+     *
+     * \return Returns a mask whose i-th bit is set if and only if the
+     * i-th symbol is not a valid nucleotide.
+     */
+    static inline uint64_t invalidMask(const char *bases, size_t n,
+                                       Alphabet alphabet = UPPER_ACGT, Level level = bestLevel()) {
+      assert(n <= 64);
+      assert(level <= bestLevel());
+      char buffer[64];
+      if (n < 64) {
+        _pad(buffer, bases, n);
+        bases = buffer;
+      }
+      return _invalidMask32(bases, alphabet, level) | (uint64_t(_invalidMask32(bases + 32, alphabet, level)) << 32);
+    }
+
+    /**
+     * Find the first invalid symbol of some block.
+     *
+     * \param bases The symbols to check.
+     *
+     * \param n The number of symbols to check.
+     *
+     * \param alphabet The symbols considered as valid nucleotides.
+     *
+     * \param level The implementation to use.
+     *
+     * \return Returns the position of the first symbol which is not a
+     * valid nucleotide or n if all the symbols are valid.
+     */
+    static inline size_t findInvalid(const char *bases, size_t n,
+                                     Alphabet alphabet = UPPER_ACGT, Level level = bestLevel()) {
+      assert(level <= bestLevel());
+      size_t i = 0;
+      for (; i + 32 <= n; i += 32) {
+        const uint32_t mask = _invalidMask32(bases + i, alphabet, level);
+        if (mask) {
+          return i + __builtin_ctz(mask);
+        }
+      }
+      if (i < n) {
+        const uint64_t mask = invalidMask(bases + i, n - i, alphabet, level);
+        if (mask) {
+          return i + __builtin_ctzll(mask);
+        }
+      }
+      return n;
+    }
+
+    /**
+     * Compute the 2 bits encoding of a short block of valid
+     * nucleotides.
+     *
+     * \param bases The nucleotide symbols (which are assumed to be
+     * valid, see invalidMask()).
+     *
+     * \param n The number of nucleotides (at most 32).
+     *
+     * \param level The implementation to use.
+     *
+     * \return Returns the packed encoding of the nucleotides (the
+     * last nucleotide being encoded by the 2 least significant bits).
+     */
+    static inline uint64_t pack(const char *bases, size_t n, Level level = bestLevel()) {
+      assert(n <= 32);
+      assert(level <= bestLevel());
+      if (n == 32) {
+        return _pack32(bases, level);
+      }
+      char buffer[64];
+      _pad(buffer, bases, n);
+      return n ? (_pack32(buffer, level) >> (64 - 2 * n)) : 0;
+    }
+
+    /**
+     * Reverse the order of the nucleotides of some packed block.
+     *
+     * \param packed The packed encoding of the nucleotides (see
+     * pack()).
+     *
+     * \param n The number of nucleotides (at least 1 and at most 32).
+     *
+     * \return Returns the packed encoding of the reversed
+     * nucleotides.
+     */
+    static inline uint64_t reverse(uint64_t packed, size_t n) {
+      assert(n > 0);
+      assert(n <= 32);
+      // Reverse the 2 bits codes by reversing the bytes, then their
+      // nibbles, then the codes of each nibble.
+      packed = __builtin_bswap64(packed);
+      packed = ((packed >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((packed & 0x0F0F0F0F0F0F0F0Full) << 4);
+      packed = ((packed >> 2) & 0x3333333333333333ull) | ((packed & 0x3333333333333333ull) << 2);
+      return packed >> (64 - 2 * n);
+    }
+
+    /**
+     * Compute the 2 bits encoding of the reverse complement of some
+     * packed block of nucleotides.
+     *
+     * \param packed The packed encoding of the nucleotides (see
+     * pack()).
+     *
+     * \param n The number of nucleotides (at least 1 and at most 32).
+     *
+     * \return Returns the packed encoding of the reverse complement
+     * of the nucleotides.
+     */
+    static inline uint64_t reverseComplement(uint64_t packed, size_t n) {
+      // The complement of a code c is 3 - c (i.e., its bitwise
+      // negation), and the bits beyond the n nucleotides are shifted
+      // out by the reversal.
+      return reverse(~packed, n);
+    }
+
+    /**
+     * Validate and encode some block of symbols.
+     *
+     * \param bases The symbols to encode.
+     *
+     * \param n The number of symbols.
+     *
+     * \param packed The array of (at least \f$\lceil n / 32
+     * \rceil\f$) words to fill with the packed encoding of the
+     * consecutive groups of 32 symbols (see pack(); the encoding of
+     * invalid symbols is not relevant).
+     *
+     * \param invalid The array of (at least \f$\lceil n / 64
+     * \rceil\f$) words to fill with the masks of invalid symbols of
+     * the consecutive groups of 64 symbols (see invalidMask()).
+     *
+     * \param alphabet The symbols considered as valid nucleotides.
+     *
+     * \param level The implementation to use.
+     *
+     * \return Returns the number of invalid symbols.
+     */
+    static inline size_t encode(const char *bases, size_t n, uint64_t *packed, uint64_t *invalid,
+                                Alphabet alphabet = UPPER_ACGT, Level level = bestLevel()) {
+      assert(level <= bestLevel());
+      size_t nb_invalid = 0;
+      size_t i = 0;
+      for (; i + 64 <= n; i += 64) {
+        *packed++ = _pack32(bases + i, level);
+        *packed++ = _pack32(bases + i + 32, level);
+        *invalid = _invalidMask32(bases + i, alphabet, level) | (uint64_t(_invalidMask32(bases + i + 32, alphabet, level)) << 32);
+        nb_invalid += __builtin_popcountll(*invalid++);
+      }
+      if (i < n) {
+        *invalid = invalidMask(bases + i, n - i, alphabet, level);
+        nb_invalid += __builtin_popcountll(*invalid);
+        for (; i < n; i += 32) {
+          *packed++ = pack(bases + i, (n - i < 32) ? n - i : 32, level);
+        }
+      }
+      return nb_invalid;
+    }
+
+  };
+
+}
+
+#endif
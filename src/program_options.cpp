@@ -43,7 +43,10 @@
 
 #include "program_options.hpp"
 
+#include "bh_kmer_index.hpp"
 #include "common.hpp"
+#include "decompressor.hpp"
+#include "exception.hpp"
 #include "transformer.hpp"
 
 #include <algorithm> // find_if()
@@ -58,18 +61,58 @@ const Settings ProgramOptions::default_settings = Settings(21 /* kmer_length */,
                                                            10 /* prefix_length */,
                                                            "identity" /* method */);
 
+/**
+ * Check whether the given option (without its leading dashes) is only
+ * available when building the index.
+ *
+ * \param opt The option to check.
+ *
+ * \return Returns true if the option can't be used in query mode.
+ */
+static bool isBuildOnlyOption(const string &opt) {
+  static const char *build_only_options[] = {
+    "length", "k", "prefix-length", "p", "nb-bins", "n", "queue-size", "s",
+    "index-backend", "i", "freeze-index", "f", "sharded-index", "S",
+    "output-index", "o",
+    "tag", "t", "method", "m"
+  };
+  for (const char *o: build_only_options) {
+    if (opt == o) return true;
+  }
+  return false;
+}
+
 void ProgramOptions::usage() const {
   cerr << '\n'
        << "Usage: " << _program_name << " [options] [-[-]] <filename> [<filename> ...]\n"
-       << "Where available options are:\n"
-       << " -h | --help" << "\t\t\t" << "Show this message then exit.\n"
-       << " -  | --" << "\t\t\t" << "Can be use to process file whose name starts by a dash.\n"
-       << " -q | --quiet" << "\t\t\t" << "Don't print warnings and informations about ignored k-mers.\n"
-       << " -V | --verbose" << "\t\t\t" << "Print warnings and informations about ignored k-mers.\n"
+       << "   or: " << _program_name << " query [query options] [-[-]] <index> <filename> [<filename> ...]\n"
+       << "\n"
+       << "The first form builds the k-mer index of the given files and prints its statistics.\n"
+       << "The second form reports, for each read of the given files, the number and the ratio\n"
+       << "of its k-mers that belong to the given index file (see the '--output-index' option).\n"
+       << "The fasta/fastq files can be compressed (supported formats:";
+  string codecs;
+  for (Decompressor::Codec codec: { Decompressor::GZIP, Decompressor::BGZF, Decompressor::ZSTD }) {
+    if (Decompressor::isSupported(codec)) {
+      codecs += " " + Decompressor::codec2string(codec);
+    }
+  }
+  cerr << (codecs.empty() ? " none" : codecs) << ").\n"
+       << "\n"
+       << "Where available options are (query options are marked with a star):\n"
+       << "*-h | --help" << "\t\t\t" << "Show this message then exit.\n"
+       << "*-  | --" << "\t\t\t" << "Can be use to process file whose name starts by a dash.\n"
+       << "*-q | --quiet" << "\t\t\t" << "Don't print warnings and informations about ignored k-mers.\n"
+       << "*-V | --verbose" << "\t\t\t" << "Print warnings and informations about ignored k-mers.\n"
        << " -k | --length <value>" << "\t\t" << "Set the k-mer length (default: " << default_settings.kmer_length << ").\n"
        << " -p | --prefix-length <value>" << "\t" << "Set the prefix length of k-mers (default: " << default_settings.prefix_length << ").\n"
        << " -n | --nb-bins <value>" << "\t\t" << "Number of bins for the computed statistics (default: " << default_settings.nb_bins << ").\n"
-       << " -s | --queue-size <value>" << "\t" << "Size of the circular queue (rounded to the ceiling power of two) used to share k-mers between collectors and processors (default: " << default_settings.queue_size << " k-mers).\n"
+       << " -s | --queue-size <value>" << "\t" << "Size of the circular queue (rounded to the ceiling power of two) used to share blocks of k-mers between collectors and processors (default: " << default_settings.queue_size << " blocks).\n"
+       << "*-b | --block-size <value>" << "\t" << "Number of k-mers per block shared between collectors and processors (default: " << default_settings.block_size << " k-mers).\n"
+       << " -i | --index-backend <backend>" << "\t" << "The k-mer index backend, either 'set' (balanced binary search trees) or 'hash' (open-addressing hash tables) (default: " << Settings::indexBackend2string(default_settings.index_backend) << ").\n"
+       << " -f | --freeze-index" << "\t\t" << "Freeze the k-mer index into compact sorted arrays once all the k-mers are inserted.\n"
+       << " -S | --sharded-index" << "\t\t" << "Assign each sub-index to a single k-mer processor (k-mers are routed to their owner), thus insertions don't need any locking.\n"
+       << " -o | --output-index <file>" << "\t" << "Save the k-mer index in the given file once all the k-mers are inserted (implies --freeze-index).\n"
        << " -t | --tag <string>" << "\t\t" << "The experiment tag (default is the coma separated list of input files).\n"
        << " -d | --transformer-plugin-directory <dir>\n"
        << "\t\t\t\t" << "Add the given directory to the search paths for transformer plugins.\n"
@@ -88,6 +131,7 @@ void ProgramOptions::usage() const {
 
 ProgramOptions::ProgramOptions(int argc, char** argv):
   _program_name(basename(argv[0])),
+  _mode(BUILD),
   _settings(default_settings),
   _filenames()
 {
@@ -100,6 +144,11 @@ ProgramOptions::ProgramOptions(int argc, char** argv):
 
   Transformer::addPluginSearchPath(PACKAGE_LIBDIR);
 
+  if ((argc > 1) && (string(argv[1]) == "query")) {
+    _mode = QUERY;
+    ++i;
+  }
+
   while (++i < argc) {
 
     if (options_accepted && (argv[i][0] == '-')) {
@@ -115,7 +164,9 @@ ProgramOptions::ProgramOptions(int argc, char** argv):
         opt = &argv[i][1];
       }
 
-      if ((opt == "help") || (opt == "h")) {
+      if ((_mode == QUERY) && isBuildOnlyOption(opt)) {
+        err = 5;
+      } else if ((opt == "help") || (opt == "h")) {
         usage();
       } else if (opt.empty()) {
         options_accepted = false;
@@ -175,6 +226,37 @@ ProgramOptions::ProgramOptions(int argc, char** argv):
         } else {
           err = 1;
         }
+      } else if ((opt == "block-size") || (opt == "b")) {
+        if ((i + 1) < argc) {
+          char *ptr;
+          _settings.block_size = strtoul(argv[++i], &ptr, 10);
+          if ((_settings.block_size == 0) || (*ptr != '\0')) {
+            err = 2;
+            --i;
+          }
+        } else {
+          err = 1;
+        }
+      } else if ((opt == "index-backend") || (opt == "i")) {
+        if ((i + 1) < argc) {
+          if (!Settings::string2indexBackend(argv[++i], _settings.index_backend)) {
+            err = 4;
+            --i;
+          }
+        } else {
+          err = 1;
+        }
+      } else if ((opt == "freeze-index") || (opt == "f")) {
+        _settings.freeze_index = true;
+      } else if ((opt == "sharded-index") || (opt == "S")) {
+        _settings.sharded_index = true;
+      } else if ((opt == "output-index") || (opt == "o")) {
+        if ((i + 1) < argc) {
+          _settings.index_filename = argv[++i];
+          _settings.freeze_index = true;
+        } else {
+          err = 1;
+        }
       } else if ((opt == "tag") || (opt == "t")) {
         if ((i + 1) < argc) {
           _settings.tag = argv[++i];
@@ -219,6 +301,13 @@ ProgramOptions::ProgramOptions(int argc, char** argv):
       case 3:
         cerr << "Error: Plugin '" << argv[i] << "' not found." << endl;
         break;
+      case 4:
+        cerr << "Error: Option '" << argv[i] << "' expects either 'set' or 'hash' as argument but "
+             << "'" << argv[i + 1] << "' was given." << endl;
+        break;
+      case 5:
+        cerr << "Error: Option '" << argv[i] << "' is not available in query mode." << endl;
+        break;
       default:
         break;
       }
@@ -237,6 +326,33 @@ ProgramOptions::ProgramOptions(int argc, char** argv):
 
   }
 
+  if (_mode == QUERY) {
+    // The first file name is the index to query and the settings are
+    // the ones stored in the index file.
+    if (_filenames.size() < 2) {
+      cerr << "Error: An index file name and at least one file name must be provided." << endl;
+      usage();
+    }
+    const size_t block_size = _settings.block_size;
+    const bool verbose = _settings.verbose;
+    const string index_filename = _filenames.front();
+    _filenames.erase(_filenames.begin());
+    try {
+      _settings = BhKmerIndex::readSettings(index_filename, verbose);
+    } catch (const Exception &e) {
+      cerr << e.what() << endl;
+      usage();
+    }
+    _settings.block_size = block_size;
+    _settings.verbose = verbose;
+    _settings.index_filename = index_filename;
+    _settings.freeze_index = true;
+    tag.erase(0, index_filename.size() + 1);
+    _settings.tag = tag;
+    _filenames.shrink_to_fit();
+    return;
+  }
+
   if(_settings.prefix_length >= _settings.kmer_length) {
     cerr << "Error: The prefix length (" << _settings.prefix_length << ")"
          << " must be strictly less than the length (" << _settings.kmer_length << ")."
@@ -56,12 +56,27 @@ namespace bijecthash {
    */
   class ProgramOptions {
 
+  public:
+
+    /**
+     * The program running mode.
+     */
+    enum Mode {
+               BUILD, /**< Build the k-mer index of the given files and compute its statistics */
+               QUERY, /**< Query the k-mers of the given files against a saved k-mer index */
+    };
+
   private:
     /**
      * The program name.
      */
     const std::string _program_name;
 
+    /**
+     * The program running mode.
+     */
+    Mode _mode;
+
     /**
      * The program settings.
      */
@@ -102,6 +117,16 @@ namespace bijecthash {
       return _program_name;
     }
 
+    /**
+     * Get the program running mode.
+     *
+     * \return Return the program running mode (QUERY if the first
+     * argument of the command line is "query" and BUILD otherwise).
+     */
+    inline Mode mode() const {
+      return _mode;
+    }
+
     /**
      * Get the program settings.
      *
@@ -114,6 +139,9 @@ namespace bijecthash {
     /**
      * Get the filenames to process.
      *
+     * In QUERY mode, the index file name is not part of the returned
+     * filenames (see Settings::index_filename).
+     *
      * \return Return the filenames to process.
      */
     inline const std::vector<std::string> &filenames() const {
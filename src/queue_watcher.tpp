@@ -61,15 +61,11 @@ namespace bijecthash {
     double nb = 0;
     auto delay = std::chrono::nanoseconds(100);
     int disp = 1024 - 1;
-    size_t running_writers;
     size_t s;
 
-    do {
-      running_writers = ThreadedProcessorHelper<Writer, T>::running();
-    } while (!running_writers);
-
     size_t running_readers = ThreadedProcessorHelper<Reader, T>::running();
-    while (running_writers > 0) {
+    // The queue is closed once all the writers have completed.
+    while (!queue.closed()) {
       s = queue.size();
       mean += s;
       var += s * s;
@@ -88,14 +84,13 @@ namespace bijecthash {
       io_mutex.lock();
       std::cerr << "[DEBUG] " << __FILE__ << ":" << __LINE__ << ":" << __FUNCTION__ << ":"
                 << "[thread " << std::this_thread::get_id() << "]:"
-                << "Watcher: " << running_writers << " / " << ThreadedProcessorHelper<Writer, T>::counter() << " running writers"
+                << "Watcher: " << ThreadedProcessorHelper<Writer, T>::running() << " / " << ThreadedProcessorHelper<Writer, T>::counter() << " running writers"
                 << " and " << running_readers << " / " << ThreadedProcessorHelper<Reader, T>::counter() << " running readers"
                 << ", queue size: " << s << std::endl;
       io_mutex.unlock();
 #endif
       std::this_thread::yield();
       std::this_thread::sleep_for(delay);
-      running_writers = ThreadedProcessorHelper<Writer, T>::running();
       running_readers = ThreadedProcessorHelper<Reader, T>::running();
     }
 
@@ -108,7 +103,7 @@ namespace bijecthash {
       io_mutex.lock();
       std::cerr << "[DEBUG] " << __FILE__ << ":" << __LINE__ << ":" << __FUNCTION__ << ":"
                 << "[thread " << std::this_thread::get_id() << "]:"
-                << "Watcher: " << running_writers << " / " << ThreadedProcessorHelper<Writer, T>::counter() << " running writers"
+                << "Watcher: " << ThreadedProcessorHelper<Writer, T>::running() << " / " << ThreadedProcessorHelper<Writer, T>::counter() << " running writers"
                 << " and " << running_readers << " / " << ThreadedProcessorHelper<Reader, T>::counter() << " running readers"
                 << ", queue size: " << s << std::endl;
       assert((ThreadedProcessorHelper<Writer, T>::running()) == 0);
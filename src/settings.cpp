@@ -54,17 +54,27 @@ BEGIN_BIJECTHASH_NAMESPACE
 Settings::Settings(size_t kmer_length, size_t prefix_length, const std::string &method,
                    const std::string &tag,
                    size_t nb_bins, size_t queue_size,
+                   size_t block_size,
+                   IndexBackend index_backend,
+                   bool freeze_index,
+                   bool sharded_index,
                    bool verbose):
   _transformer(), _method(method),
   kmer_length(kmer_length), prefix_length(prefix_length),
   tag(tag),
   nb_bins(nb_bins), queue_size(queue_size),
+  block_size(block_size),
+  index_backend(index_backend),
+  freeze_index(freeze_index),
+  sharded_index(sharded_index),
+  index_filename(),
   verbose(verbose)
 {
   assert(prefix_length > 0);
   assert(prefix_length < 14);
   assert(prefix_length < kmer_length);
   assert(kmer_length - prefix_length <= 64);
+  assert(block_size > 0);
 }
 
 bool Settings::setMethod(const string &method) {
@@ -87,12 +97,35 @@ shared_ptr<const Transformer> Settings::transformer() const {
   return _transformer;
 }
 
+string Settings::indexBackend2string(IndexBackend backend) {
+  switch (backend) {
+  case ORDERED_SET: return "set";
+  case HASH_SET: return "hash";
+  }
+  return "";
+}
+
+bool Settings::string2indexBackend(const string &name, IndexBackend &backend) {
+  for (IndexBackend b: { ORDERED_SET, HASH_SET }) {
+    if (name == indexBackend2string(b)) {
+      backend = b;
+      return true;
+    }
+  }
+  return false;
+}
+
 ostream &operator<<(ostream &os, const Settings &s) {
   os << "- kmer_length: " << s.kmer_length << " nucleotides\n"
      << "- prefix_length: " << s.prefix_length << " nucleotides\n"
      << "- method: " << s.getMethod() << " => " << s.transformer()->description << '\n'
      << "- nb_bins: " << s.nb_bins << " bins\n"
-     << "- queue_size: " << s.queue_size << " k-mers\n"
+     << "- queue_size: " << s.queue_size << " blocks\n"
+     << "- block_size: " << s.block_size << " k-mers\n"
+     << "- index_backend: " << Settings::indexBackend2string(s.index_backend) << '\n'
+     << "- freeze_index: " << (s.freeze_index ? "yes" : "no") << '\n'
+     << "- sharded_index: " << (s.sharded_index ? "yes" : "no") << '\n'
+     << "- index_filename: " << s.index_filename << '\n'
      << "- tag: " << s.tag << '\n'
      << "- verbosity: " << (s.verbose ? "verbose" : "quiet") << endl;
   return os;
@@ -58,6 +58,15 @@ namespace bijecthash {
    */
   struct Settings {
 
+    /**
+     * The available k-mer index backends (data structures storing the
+     * k-mer suffixes of each sub-index).
+     */
+    enum IndexBackend {
+                       ORDERED_SET, /**< Suffixes are stored in a balanced binary search tree (std::set) */
+                       HASH_SET,    /**< Suffixes are stored in an open-addressing hash table (SuffixHashSet) */
+    };
+
   private:
 
     /**
@@ -97,6 +106,35 @@ namespace bijecthash {
      */
     size_t queue_size;
 
+    /**
+     * The number of k-mers per block shared between the k-mer collectors and processors.
+     */
+    size_t block_size;
+
+    /**
+     * The k-mer index backend.
+     */
+    IndexBackend index_backend;
+
+    /**
+     * Whether the k-mer index is frozen once all the k-mers are
+     * inserted.
+     */
+    bool freeze_index;
+
+    /**
+     * Whether each sub-index of the k-mer index is owned by a single
+     * k-mer processor (k-mers being routed to their owner), which
+     * avoids any locking during insertions.
+     */
+    bool sharded_index;
+
+    /**
+     * The file in which the (frozen) k-mer index is saved once all
+     * the k-mers are inserted (no file is written if empty).
+     */
+    std::string index_filename;
+
     /**
      * Verbosity of the program.
      */
@@ -118,11 +156,26 @@ namespace bijecthash {
      * \param queue_size The circular queue size to share data between
      * the k-mer collectors and processors.
      *
+     * \param block_size The number of k-mers per block shared between
+     * the k-mer collectors and processors.
+     *
+     * \param index_backend The k-mer index backend.
+     *
+     * \param freeze_index Whether the k-mer index is frozen once all
+     * the k-mers are inserted.
+     *
+     * \param sharded_index Whether each sub-index of the k-mer index
+     * is owned by a single k-mer processor.
+     *
      * \param verbose Verbosity of the program.
      */
     Settings(size_t kmer_length, size_t prefix_length, const std::string &method,
              const std::string &tag = "",
-             size_t nb_bins = 1024, size_t queue_size = 1024,
+             size_t nb_bins = 1024, size_t queue_size = 64,
+             size_t block_size = 4096,
+             IndexBackend index_backend = HASH_SET,
+             bool freeze_index = false,
+             bool sharded_index = false,
              bool verbose = true);
 
     /**
@@ -157,6 +210,29 @@ namespace bijecthash {
      */
     std::shared_ptr<const Transformer> transformer() const;
 
+    /**
+     * Get the name of the given index backend.
+     *
+     * \param backend The index backend.
+     *
+     * \return Returns the name of the given index backend (either
+     * "set" or "hash").
+     */
+    static std::string indexBackend2string(IndexBackend backend);
+
+    /**
+     * Get the index backend having the given name.
+     *
+     * \param name The index backend name (either "set" or "hash").
+     *
+     * \param backend The index backend to set.
+     *
+     * \return Returns true if the name corresponds to some index
+     * backend (then the backend parameter is updated) and false
+     * otherwise.
+     */
+    static bool string2indexBackend(const std::string &name, IndexBackend &backend);
+
   };
 
   /**
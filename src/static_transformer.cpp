@@ -0,0 +1,192 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#include "static_transformer.hpp"
+
+#include "common.hpp"
+#include "nucleotide_kernel.hpp"
+
+#include <utility>
+
+using namespace std;
+
+BEGIN_BIJECTHASH_NAMESPACE
+
+/**
+ * The k-specialized implementations of the transformations (see
+ * Transformer::Kernel).
+ *
+ * \tparam kind The transformation.
+ *
+ * \tparam K The length of the k-mers.
+ *
+ * \tparam P The length of the k-mer prefixes.
+ */
+template <Transformer::Kernel::Kind kind, size_t K, size_t P>
+struct _StaticKernel;
+
+/**
+ * Split some given packed word into a prefix/suffix code.
+ *
+ * \tparam K The length of the k-mers.
+ *
+ * \tparam P The length of the k-mer prefixes.
+ *
+ * \param v The packed word to split.
+ *
+ * \return Returns the prefix/suffix code of the given word.
+ */
+template <size_t K, size_t P>
+static inline Transformer::EncodedKmer _split(uint64_t v) {
+  static_assert(P < K, "The prefix must be shorter than the k-mers");
+  static_assert(K <= 32, "The k-mers must fit in a word");
+  return Transformer::EncodedKmer { v >> (2 * (K - P)), v & ((1ull << (2 * (K - P))) - 1) };
+}
+
+template <size_t K, size_t P>
+struct _StaticKernel<Transformer::Kernel::IDENTITY, K, P> {
+  static inline Transformer::EncodedKmer encode(const Transformer::Kernel &, uint64_t kmer) {
+    return _split<K, P>(kmer);
+  }
+};
+
+template <size_t K, size_t P>
+struct _StaticKernel<Transformer::Kernel::CANONICAL, K, P> {
+  static inline Transformer::EncodedKmer encode(const Transformer::Kernel &, uint64_t kmer) {
+    // The reverse complement is kept on ties (and flagged). The
+    // choice is made by masking since it is unpredictable.
+    const uint64_t rc = NucleotideKernel::reverseComplement(kmer, K);
+    const uint64_t keep_rc = -uint64_t(rc <= kmer);
+    Transformer::EncodedKmer e = _split<K, P>(kmer ^ ((kmer ^ rc) & keep_rc));
+    e.suffix |= keep_rc & (1ull << 62);
+    return e;
+  }
+};
+
+template <size_t K, size_t P>
+struct _StaticKernel<Transformer::Kernel::GAB, K, P> {
+  static inline Transformer::EncodedKmer encode(const Transformer::Kernel &kernel, uint64_t kmer) {
+    // The (2K bits) k-mer halves are swapped, then xor-ed and
+    // multiplied.
+    constexpr uint64_t mask = (K < 32) ? ((1ull << (2 * K)) - 1) : uint64_t(-1);
+    return _split<K, P>((kernel.a * ((((kmer << K) | (kmer >> K)) & mask) ^ kernel.b)) & mask);
+  }
+};
+
+template <Transformer::Kernel::Kind kind, size_t K, size_t P>
+static Transformer::EncodedKmer _encode(const Transformer::Kernel &kernel, uint64_t kmer) {
+  return _StaticKernel<kind, K, P>::encode(kernel, kmer);
+}
+
+template <Transformer::Kernel::Kind kind, size_t K, size_t P>
+static void _encodeBatch(const Transformer::Kernel &kernel, const uint64_t *packed, size_t n,
+                         Transformer::EncodedKmer *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = _StaticKernel<kind, K, P>::encode(kernel, packed[i]);
+  }
+}
+
+/**
+ * The maximal prefix length having specialized implementations
+ * (which is the maximal value allowed by the program options).
+ */
+static constexpr size_t _max_prefix_length = 13;
+
+template <Transformer::Kernel::Kind kind, size_t K, size_t... I>
+static bool _select(size_t prefix_length,
+                    StaticTransformer::Function &function, StaticTransformer::BatchFunction &batch_function,
+                    index_sequence<I...>) {
+  // Prefix lengths are 1 to _max_prefix_length.
+  return ((prefix_length == I + 1
+           ? (function = _encode<kind, K, I + 1>, batch_function = _encodeBatch<kind, K, I + 1>, true)
+           : false) || ...);
+}
+
+template <Transformer::Kernel::Kind kind>
+static bool _select(size_t kmer_length, size_t prefix_length,
+                    StaticTransformer::Function &function, StaticTransformer::BatchFunction &batch_function) {
+  const auto prefix_lengths = make_index_sequence<_max_prefix_length>();
+  switch (kmer_length) {
+  case 15: return _select<kind, 15>(prefix_length, function, batch_function, prefix_lengths);
+  case 21: return _select<kind, 21>(prefix_length, function, batch_function, prefix_lengths);
+  case 25: return _select<kind, 25>(prefix_length, function, batch_function, prefix_lengths);
+  case 31: return _select<kind, 31>(prefix_length, function, batch_function, prefix_lengths);
+  default: return false;
+  }
+}
+
+static bool _select(Transformer::Kernel::Kind kind, size_t kmer_length, size_t prefix_length,
+                    StaticTransformer::Function &function, StaticTransformer::BatchFunction &batch_function) {
+  switch (kind) {
+  case Transformer::Kernel::IDENTITY:
+    return _select<Transformer::Kernel::IDENTITY>(kmer_length, prefix_length, function, batch_function);
+  case Transformer::Kernel::CANONICAL:
+    return _select<Transformer::Kernel::CANONICAL>(kmer_length, prefix_length, function, batch_function);
+  case Transformer::Kernel::GAB:
+    if (!_select<Transformer::Kernel::GAB>(kmer_length, prefix_length, function, batch_function)) {
+      return false;
+    }
+    // The batch encoding of the GaB transformer is vectorized, which
+    // is faster than the (scalar) specialized loop.
+    batch_function = NULL;
+    return true;
+  default:
+    return false;
+  }
+}
+
+StaticTransformer::StaticTransformer(const shared_ptr<const Transformer> &transformer):
+  _transformer(transformer), _kernel { Transformer::Kernel::GENERIC, 0, 0 },
+  _function(NULL), _batch_function(NULL)
+{
+  if (_transformer) {
+    _kernel = _transformer->getKernel();
+    if (!_select(_kernel.kind, _transformer->kmer_length, _transformer->prefix_length, _function, _batch_function)) {
+      _function = NULL;
+      _batch_function = NULL;
+    }
+  }
+  DEBUG_MSG("The encoding of packed k-mers is " << (specialized() ? "" : "not ") << "specialized");
+}
+
+END_BIJECTHASH_NAMESPACE
@@ -0,0 +1,185 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifndef __STATIC_TRANSFORMER_HPP__
+#define __STATIC_TRANSFORMER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <transformer.hpp>
+
+namespace bijecthash {
+
+  /**
+   * Statically dispatched encoding of packed k-mers.
+   *
+   * Encoding a k-mer with a transformer goes through its virtual
+   * methods, whose masks and shifts depend on the runtime values of
+   * \f$k\f$ and \f$p\f$. For the transformations having a
+   * k-specialized implementation (see Transformer::getKernel()) and
+   * the most common \f$(k, p)\f$ pairs, this class uses template
+   * instances where \f$k\f$ and \f$p\f$ are compile-time constants,
+   * thus where the masks and shifts are constant-folded and the batch
+   * encoding loop is fully inlined.
+   *
+   * Any other transformer (or any other pair) falls back to the
+   * methods of the transformer.
+   */
+  class StaticTransformer {
+
+  public:
+
+    /**
+     * Data type of the functions encoding some packed k-mer.
+     *
+     * \param kernel The description of the transformation.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    typedef Transformer::EncodedKmer (*Function)(const Transformer::Kernel &kernel, uint64_t kmer);
+
+    /**
+     * Data type of the functions encoding some batch of packed
+     * k-mers.
+     *
+     * \param kernel The description of the transformation.
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    typedef void (*BatchFunction)(const Transformer::Kernel &kernel, const uint64_t *packed, size_t n,
+                                  Transformer::EncodedKmer *out);
+
+  private:
+
+    /**
+     * The transformer (used as a fallback).
+     */
+    std::shared_ptr<const Transformer> _transformer;
+
+    /**
+     * The description of the transformation.
+     */
+    Transformer::Kernel _kernel;
+
+    /**
+     * The specialized encoding function (NULL if there is no
+     * specialized implementation).
+     */
+    Function _function;
+
+    /**
+     * The specialized batch encoding function (NULL if there is no
+     * specialized implementation or if the transformer one is
+     * faster).
+     */
+    BatchFunction _batch_function;
+
+  public:
+
+    /**
+     * Builds a statically dispatched encoder for the given
+     * transformer.
+     *
+     * \param transformer The transformer to use (possibly NULL, in
+     * which case no k-mer can be encoded).
+     */
+    StaticTransformer(const std::shared_ptr<const Transformer> &transformer);
+
+    /**
+     * Check whether this encoder uses a specialized implementation.
+     *
+     * \return Returns true if the encoding of packed k-mers doesn't
+     * go through the transformer.
+     */
+    inline bool specialized() const {
+      return _function;
+    }
+
+    /**
+     * Encode some given packed k-mer into a prefix/suffix code.
+     *
+     * This gives the same encoding as the packed operator of the
+     * transformer (see Transformer::operator()(uint64_t) const).
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    inline Transformer::EncodedKmer operator()(uint64_t kmer) const {
+      return _function ? _function(_kernel, kmer) : (*_transformer)(kmer);
+    }
+
+    /**
+     * Encode some given batch of packed k-mers into prefix/suffix
+     * codes.
+     *
+     * This gives the same encodings as the transformer (see
+     * Transformer::transformBatch()).
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    inline void transformBatch(const uint64_t *packed, size_t n, Transformer::EncodedKmer *out) const {
+      if (_batch_function) {
+        _batch_function(_kernel, packed, n, out);
+      } else {
+        _transformer->transformBatch(packed, n, out);
+      }
+    }
+
+  };
+
+}
+
+#endif
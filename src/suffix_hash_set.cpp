@@ -0,0 +1,200 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#include "suffix_hash_set.hpp"
+
+#include "common.hpp"
+
+#include <cstring>
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+using namespace std;
+
+BEGIN_BIJECTHASH_NAMESPACE
+
+/**
+ * Compute the bit mask of the control bytes of some group that are
+ * equal to the given byte.
+ *
+ * \param group The first control byte of the group.
+ *
+ * \param b The byte to look for.
+ *
+ * \return Returns a mask whose i-th bit is set if and only if the
+ * i-th control byte of the group is equal to b.
+ */
+static inline uint32_t match(const uint8_t *group, uint8_t b) {
+#ifdef __SSE2__
+  const __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(b)));
+#else
+  uint32_t m = 0;
+  for (size_t i = 0; i < SuffixHashSet::group_size; ++i) {
+    m |= uint32_t(group[i] == b) << i;
+  }
+  return m;
+#endif
+}
+
+SuffixHashSet::SuffixHashSet(const SuffixHashSet &s):
+  _data(), _size(s._size), _capacity(s._capacity)
+{
+  if (_capacity) {
+    const size_t n = _capacity + _capacity / sizeof(uint64_t);
+    _data.reset(new uint64_t[n]);
+    memcpy(_data.get(), s._data.get(), n * sizeof(uint64_t));
+  }
+}
+
+SuffixHashSet::SuffixHashSet(SuffixHashSet &&s) noexcept:
+  _data(std::move(s._data)), _size(s._size), _capacity(s._capacity)
+{
+  s._size = s._capacity = 0;
+}
+
+SuffixHashSet &SuffixHashSet::operator=(const SuffixHashSet &s) {
+  if (this != &s) {
+    *this = SuffixHashSet(s);
+  }
+  return *this;
+}
+
+SuffixHashSet &SuffixHashSet::operator=(SuffixHashSet &&s) noexcept {
+  if (this != &s) {
+    _data = std::move(s._data);
+    _size = s._size;
+    _capacity = s._capacity;
+    s._size = s._capacity = 0;
+  }
+  return *this;
+}
+
+void SuffixHashSet::_insertNew(value_type value, uint64_t h) {
+  const size_t groups_mask = _capacity / group_size - 1;
+  uint8_t *ctrl = _ctrl();
+  size_t g = (h >> 7) & groups_mask;
+  uint32_t m;
+  while (!(m = match(ctrl + g * group_size, _empty))) {
+    g = (g + 1) & groups_mask;
+  }
+  const size_t pos = g * group_size + __builtin_ctz(m);
+  ctrl[pos] = h & 0x7F;
+  _data[pos] = value;
+  ++_size;
+}
+
+void SuffixHashSet::_rehash(size_t capacity) {
+  assert(capacity >= group_size);
+  assert((capacity & (capacity - 1)) == 0);
+  DEBUG_MSG("Rehashing set " << this << " from " << _capacity << " to " << capacity << " slots");
+  SuffixHashSet old(std::move(*this));
+  _capacity = capacity;
+  // The control bytes use capacity / 8 additional words.
+  _data.reset(new uint64_t[_capacity + _capacity / sizeof(uint64_t)]);
+  memset(_ctrl(), _empty, _capacity);
+  for (value_type v: old) {
+    _insertNew(v, _hash(v));
+  }
+  assert(_size == old._size);
+}
+
+bool SuffixHashSet::insert(value_type value) {
+  const uint64_t h = _hash(value);
+  if (_capacity) {
+    const size_t groups_mask = _capacity / group_size - 1;
+    const uint8_t tag = h & 0x7F;
+    const uint8_t *ctrl = _ctrl();
+    size_t g = (h >> 7) & groups_mask;
+    for (;;) {
+      const uint8_t *group = ctrl + g * group_size;
+      for (uint32_t m = match(group, tag); m; m &= m - 1) {
+        if (_data[g * group_size + __builtin_ctz(m)] == value) {
+          return false;
+        }
+      }
+      if (match(group, _empty)) {
+        // Since values are never removed, the value is absent.
+        break;
+      }
+      g = (g + 1) & groups_mask;
+    }
+  }
+  // Keep the load factor below 7/8.
+  if (8 * (_size + 1) > 7 * _capacity) {
+    _rehash(_capacity ? 2 * _capacity : group_size);
+  }
+  _insertNew(value, h);
+  return true;
+}
+
+bool SuffixHashSet::contains(value_type value) const {
+  if (!_capacity) {
+    return false;
+  }
+  const uint64_t h = _hash(value);
+  const size_t groups_mask = _capacity / group_size - 1;
+  const uint8_t tag = h & 0x7F;
+  const uint8_t *ctrl = _ctrl();
+  size_t g = (h >> 7) & groups_mask;
+  for (;;) {
+    const uint8_t *group = ctrl + g * group_size;
+    for (uint32_t m = match(group, tag); m; m &= m - 1) {
+      if (_data[g * group_size + __builtin_ctz(m)] == value) {
+        return true;
+      }
+    }
+    if (match(group, _empty)) {
+      return false;
+    }
+    g = (g + 1) & groups_mask;
+  }
+}
+
+void SuffixHashSet::clear() {
+  _data.reset();
+  _size = _capacity = 0;
+}
+
+END_BIJECTHASH_NAMESPACE
@@ -0,0 +1,353 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifndef __SUFFIX_HASH_SET_HPP__
+#define __SUFFIX_HASH_SET_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+namespace bijecthash {
+
+  /**
+   * An open-addressing hash set of 64 bits integers (k-mer suffixes).
+   *
+   * Values are stored in a flat array of slots. Each slot is
+   * associated to a control byte which is either empty (high bit set)
+   * or holds a 7 bits tag of the hash of the stored value. Slots are
+   * grouped by 16 consecutive ones, and groups are linearly probed;
+   * the 16 control bytes of some group are compared to the searched
+   * tag at once using SSE2 instructions (when available), so that
+   * almost no value has to be compared in practice.
+   *
+   * Compared to a std::set<uint64_t>, which costs a 40 bytes node per
+   * stored value, this costs at most 9 bytes per slot with a load
+   * factor between 7/16 and 7/8 (thus between 10.3 and 20.6 bytes per
+   * stored value).
+   *
+   * Values can't be removed from the set. This class is not thread
+   * safe.
+   */
+  class SuffixHashSet {
+
+  public:
+
+    /**
+     * The type of stored values.
+     */
+    typedef uint64_t value_type;
+
+    /**
+     * The number of slots of a group.
+     */
+    static const size_t group_size = 16;
+
+  private:
+
+    /**
+     * The control byte value of empty slots.
+     */
+    static const uint8_t _empty = 0x80;
+
+    /**
+     * The storage (slots followed by their control bytes).
+     */
+    std::unique_ptr<uint64_t[]> _data;
+
+    /**
+     * The number of stored values.
+     */
+    size_t _size;
+
+    /**
+     * The number of slots (either 0 or a power of two greater than or
+     * equal to group_size).
+     */
+    size_t _capacity;
+
+    /**
+     * Get the control bytes (which follow the slots).
+     *
+     * \return Returns the address of the first control byte.
+     */
+    inline uint8_t *_ctrl() const {
+      return reinterpret_cast<uint8_t *>(_data.get() + _capacity);
+    }
+
+    /**
+     * Mix the bits of the given value (this is the finalizer of the
+     * MurmurHash3 function, which is bijective).
+     *
+     * \param v The value to hash.
+     *
+     * \return Returns the hash of the given value.
+     */
+    static inline uint64_t _hash(uint64_t v) {
+      v ^= v >> 33;
+      v *= 0xff51afd7ed558ccdull;
+      v ^= v >> 33;
+      v *= 0xc4ceb9fe1a85ec53ull;
+      v ^= v >> 33;
+      return v;
+    }
+
+    /**
+     * Insert some value known to be absent from this set, assuming
+     * there is enough room.
+     *
+     * \param value The value to insert.
+     *
+     * \param h The hash of the value.
+     */
+    void _insertNew(value_type value, uint64_t h);
+
+    /**
+     * Reallocate this set to the given capacity and re-insert all its
+     * values.
+     *
+     * \param capacity The new capacity (a power of two greater than or
+     * equal to group_size).
+     */
+    void _rehash(size_t capacity);
+
+  public:
+
+    /**
+     * Forward iterator over the values of some set (in an
+     * unspecified order).
+     */
+    class const_iterator {
+
+    private:
+
+      /**
+       * The iterated set.
+       */
+      const SuffixHashSet *_set;
+
+      /**
+       * The current slot.
+       */
+      size_t _pos;
+
+      /**
+       * Move to the first occupied slot from the current one (included).
+       */
+      inline void _skipEmptySlots() {
+        const uint8_t *ctrl = _set->_ctrl();
+        while ((_pos < _set->_capacity) && (ctrl[_pos] & _empty)) {
+          ++_pos;
+        }
+      }
+
+    public:
+
+      typedef std::forward_iterator_tag iterator_category;
+      typedef SuffixHashSet::value_type value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const value_type *pointer;
+      typedef const value_type &reference;
+
+      /**
+       * Builds an iterator on the given set at the given slot.
+       *
+       * \param set The iterated set.
+       *
+       * \param pos The starting slot (moved to the first occupied slot
+       * from it).
+       */
+      inline const_iterator(const SuffixHashSet *set, size_t pos): _set(set), _pos(pos) {
+        _skipEmptySlots();
+      }
+
+      inline reference operator*() const {
+        return _set->_data[_pos];
+      }
+
+      inline const_iterator &operator++() {
+        ++_pos;
+        _skipEmptySlots();
+        return *this;
+      }
+
+      inline const_iterator operator++(int) {
+        const_iterator it = *this;
+        ++(*this);
+        return it;
+      }
+
+      inline bool operator==(const const_iterator &it) const {
+        return _pos == it._pos;
+      }
+
+      inline bool operator!=(const const_iterator &it) const {
+        return _pos != it._pos;
+      }
+
+    };
+
+    /**
+     * Builds an empty set (no memory is allocated until the first
+     * insertion).
+     */
+    inline SuffixHashSet(): _data(), _size(0), _capacity(0) {}
+
+    /**
+     * Copy constructor.
+     *
+     * \param s The set to copy.
+     */
+    SuffixHashSet(const SuffixHashSet &s);
+
+    /**
+     * Move constructor.
+     *
+     * \param s The set to move (which becomes empty).
+     */
+    SuffixHashSet(SuffixHashSet &&s) noexcept;
+
+    /**
+     * The assignment operator.
+     *
+     * \param s The set to copy.
+     *
+     * \return Returns this set.
+     */
+    SuffixHashSet &operator=(const SuffixHashSet &s);
+
+    /**
+     * The move assignment operator.
+     *
+     * \param s The set to move (which becomes empty).
+     *
+     * \return Returns this set.
+     */
+    SuffixHashSet &operator=(SuffixHashSet &&s) noexcept;
+
+    /**
+     * Check if this set is empty.
+     *
+     * \return Returns true if this set is empty and false otherwise.
+     */
+    inline bool empty() const {
+      return _size == 0;
+    }
+
+    /**
+     * Get this set size.
+     *
+     * \return Returns the number of values in this set.
+     */
+    inline size_t size() const {
+      return _size;
+    }
+
+    /**
+     * Get this set capacity.
+     *
+     * \return Returns the number of allocated slots of this set.
+     */
+    inline size_t capacity() const {
+      return _capacity;
+    }
+
+    /**
+     * Get the memory used by this set storage.
+     *
+     * \return Returns the number of allocated bytes (slots and control
+     * bytes).
+     */
+    inline size_t memory() const {
+      return _capacity * (sizeof(uint64_t) + 1);
+    }
+
+    /**
+     * Inserts the given value in this set if not already present.
+     *
+     * \param value The value to insert.
+     *
+     * \return Returns true if the value was inserted and false if it
+     * was already present in this set.
+     */
+    bool insert(value_type value);
+
+    /**
+     * Check whether the given value belongs to this set.
+     *
+     * \param value The value to look for.
+     *
+     * \return Returns true if the value is in this set and false
+     * otherwise.
+     */
+    bool contains(value_type value) const;
+
+    /**
+     * Remove all the values of this set and release its memory.
+     */
+    void clear();
+
+    /**
+     * Get an iterator on the first value of this set.
+     *
+     * \return Returns an iterator on the first value of this set.
+     */
+    inline const_iterator begin() const {
+      return const_iterator(this, 0);
+    }
+
+    /**
+     * Get an iterator past the last value of this set.
+     *
+     * \return Returns an iterator past the last value of this set.
+     */
+    inline const_iterator end() const {
+      return const_iterator(this, _capacity);
+    }
+
+  };
+
+}
+
+#endif
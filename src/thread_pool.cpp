@@ -0,0 +1,199 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#include "thread_pool.hpp"
+
+#include "common.hpp"
+
+#include <cassert>
+
+using namespace std;
+
+BEGIN_BIJECTHASH_NAMESPACE
+
+thread_local ThreadPool *ThreadPool::_current_pool = NULL;
+thread_local size_t ThreadPool::_current_worker = ThreadPool::npos;
+
+ThreadPool::ThreadPool(size_t nb_workers):
+  _workers(),
+  _nb_pending(0), _nb_queued(0), _nb_sleeping(0), _next_worker(0),
+  _stop(false),
+  _mutex(), _task_available(), _all_done(),
+  _exception()
+{
+  if (nb_workers == 0) {
+    nb_workers = thread::hardware_concurrency();
+    if (nb_workers == 0) {
+      nb_workers = 1;
+    }
+  }
+  _workers.reserve(nb_workers);
+  for (size_t i = 0; i < nb_workers; ++i) {
+    _workers.emplace_back(new _Worker());
+  }
+  // Workers are started once they all exist since they may steal
+  // tasks from each other.
+  for (size_t i = 0; i < nb_workers; ++i) {
+    _workers[i]->thread = thread(&ThreadPool::_workerLoop, this, i);
+  }
+  DEBUG_MSG("Thread pool " << this << " started with " << nb_workers << " worker(s)");
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    unique_lock<mutex> lock(_mutex);
+    _all_done.wait(lock, [this]() { return _nb_pending.load() == 0; });
+    _stop = true;
+  }
+  _task_available.notify_all();
+  for (auto &worker: _workers) {
+    worker->thread.join();
+  }
+  DEBUG_MSG("Thread pool " << this << " stopped");
+}
+
+bool ThreadPool::_take(size_t worker, Task &task) {
+  const size_t n = _workers.size();
+  if (worker != npos) {
+    _Worker &w = *_workers[worker];
+    lock_guard<mutex> lock(w.mutex);
+    if (!w.tasks.empty()) {
+      task = std::move(w.tasks.back());
+      w.tasks.pop_back();
+      --_nb_queued;
+      return true;
+    }
+  }
+  const size_t first = ((worker != npos) ? worker + 1 : _next_worker.load(memory_order_relaxed));
+  for (size_t i = 0; i < n; ++i) {
+    const size_t victim = (first + i) % n;
+    if (victim == worker) continue;
+    _Worker &w = *_workers[victim];
+    lock_guard<mutex> lock(w.mutex);
+    if (!w.tasks.empty()) {
+      DEBUG_MSG("Worker " << worker << " steals a task from worker " << victim);
+      task = std::move(w.tasks.front());
+      w.tasks.pop_front();
+      --_nb_queued;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::_execute(Task &task) {
+  try {
+    task();
+  } catch (...) {
+    lock_guard<mutex> lock(_mutex);
+    if (!_exception) {
+      _exception = current_exception();
+    }
+  }
+  task = nullptr;
+  if (--_nb_pending == 0) {
+    { lock_guard<mutex> lock(_mutex); }
+    _all_done.notify_all();
+  }
+}
+
+void ThreadPool::_workerLoop(size_t worker) {
+  _current_pool = this;
+  _current_worker = worker;
+  Task task;
+  for (;;) {
+    if (_take(worker, task)) {
+      _execute(task);
+    } else {
+      unique_lock<mutex> lock(_mutex);
+      ++_nb_sleeping;
+      // See submit() for the wake up protocol.
+      atomic_thread_fence(memory_order_seq_cst);
+      _task_available.wait(lock, [this]() { return (_nb_queued.load() > 0) || _stop.load(); });
+      --_nb_sleeping;
+      if (_stop.load() && (_nb_queued.load() == 0)) {
+        break;
+      }
+    }
+  }
+}
+
+void ThreadPool::submit(Task task) {
+  assert(!_stop.load());
+  size_t worker = currentWorker();
+  if (worker == npos) {
+    worker = _next_worker++ % _workers.size();
+  }
+  ++_nb_pending;
+  {
+    _Worker &w = *_workers[worker];
+    lock_guard<mutex> lock(w.mutex);
+    // The counter is updated while holding the worker lock, thus
+    // before any worker can take the task (and decrement it).
+    ++_nb_queued;
+    w.tasks.push_back(std::move(task));
+  }
+  // Either some sleeping worker has registered itself before this
+  // fence (and is notified) or it will see the new task when checking
+  // its wake up condition.
+  atomic_thread_fence(memory_order_seq_cst);
+  if (_nb_sleeping.load(memory_order_relaxed) > 0) {
+    { lock_guard<mutex> lock(_mutex); }
+    _task_available.notify_one();
+  }
+}
+
+void ThreadPool::wait() {
+  assert(currentWorker() == npos);
+  exception_ptr e;
+  {
+    unique_lock<mutex> lock(_mutex);
+    _all_done.wait(lock, [this]() { return _nb_pending.load() == 0; });
+    swap(e, _exception);
+  }
+  if (e) {
+    rethrow_exception(e);
+  }
+}
+
+END_BIJECTHASH_NAMESPACE
@@ -0,0 +1,277 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifndef __THREAD_POOL_HPP__
+#define __THREAD_POOL_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bijecthash {
+
+  /**
+   * A work-stealing thread pool.
+   *
+   * Each worker thread has its own deque of tasks. Tasks submitted by
+   * a worker are pushed to its own deque and a worker runs its own
+   * tasks in Last In First Out order (which is cache friendly). Once
+   * its deque is empty, a worker steals the oldest task of some other
+   * worker. Workers sleep (without consuming any CPU) when there is
+   * no task at all.
+   *
+   * Tasks submitted from outside the pool are dispatched among the
+   * workers in a round-robin fashion.
+   */
+  class ThreadPool {
+
+  public:
+
+    /**
+     * The type of tasks.
+     */
+    typedef std::function<void()> Task;
+
+    /**
+     * The value returned by currentWorker() when the calling thread
+     * is not a worker of the pool.
+     */
+    static const size_t npos = size_t(-1);
+
+  private:
+
+    /**
+     * A worker (its deque being padded in order to avoid false
+     * sharing with the other workers).
+     */
+    struct alignas(64) _Worker {
+
+      /**
+       * The mutex protecting the deque of tasks.
+       */
+      std::mutex mutex;
+
+      /**
+       * The tasks submitted to this worker.
+       */
+      std::deque<Task> tasks;
+
+      /**
+       * The worker thread.
+       */
+      std::thread thread;
+
+    };
+
+    /**
+     * The workers of this pool.
+     */
+    std::vector<std::unique_ptr<_Worker>> _workers;
+
+    /**
+     * The number of tasks submitted but not completed.
+     */
+    std::atomic_size_t _nb_pending;
+
+    /**
+     * The number of tasks waiting in the deques.
+     */
+    std::atomic_size_t _nb_queued;
+
+    /**
+     * The number of sleeping workers.
+     */
+    std::atomic_size_t _nb_sleeping;
+
+    /**
+     * The next worker to which a task submitted from outside the pool
+     * is dispatched.
+     */
+    std::atomic_size_t _next_worker;
+
+    /**
+     * Whether the workers must stop (once all the tasks are
+     * completed).
+     */
+    std::atomic_bool _stop;
+
+    /**
+     * The mutex associated to the condition variables.
+     */
+    std::mutex _mutex;
+
+    /**
+     * Condition variable notified when some task is submitted (or
+     * when the pool is stopping).
+     */
+    std::condition_variable _task_available;
+
+    /**
+     * Condition variable notified when all the submitted tasks are
+     * completed.
+     */
+    std::condition_variable _all_done;
+
+    /**
+     * The first exception thrown by some task since the last call to
+     * wait() (if any).
+     */
+    std::exception_ptr _exception;
+
+    /**
+     * The pool the current thread works for (if any).
+     */
+    static thread_local ThreadPool *_current_pool;
+
+    /**
+     * The worker index of the current thread (only relevant if the
+     * current thread works for some pool).
+     */
+    static thread_local size_t _current_worker;
+
+    /**
+     * Take a task, either from the deque of the given worker (the most
+     * recent one) or from the deque of another worker (the oldest
+     * one).
+     *
+     * \param worker The worker index (or npos to only steal tasks).
+     *
+     * \param task The task to set.
+     *
+     * \return Returns true if some task has been taken and false
+     * otherwise.
+     */
+    bool _take(size_t worker, Task &task);
+
+    /**
+     * Run the given task and account for its completion.
+     *
+     * \param task The task to run (which is reset afterward).
+     */
+    void _execute(Task &task);
+
+    /**
+     * The worker thread main loop.
+     *
+     * \param worker The worker index.
+     */
+    void _workerLoop(size_t worker);
+
+  public:
+
+    /**
+     * Creates a pool of worker threads.
+     *
+     * \param nb_workers The number of workers (if 0 [default], then
+     * the number of hardware threads is used).
+     */
+    ThreadPool(size_t nb_workers = 0);
+
+    /**
+     * Deleted copy constructor.
+     */
+    ThreadPool(const ThreadPool &) = delete;
+
+    /**
+     * Deleted assignment operator.
+     */
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * Waits for all the submitted tasks to complete then stops the
+     * worker threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * Get the number of workers of this pool.
+     *
+     * \return Returns the number of workers of this pool.
+     */
+    inline size_t size() const {
+      return _workers.size();
+    }
+
+    /**
+     * Get the worker index of the calling thread.
+     *
+     * \return Returns the worker index (between 0 and size() - 1) of
+     * the calling thread or npos if it is not a worker of this pool.
+     */
+    inline size_t currentWorker() const {
+      return (_current_pool == this) ? _current_worker : npos;
+    }
+
+    /**
+     * Submit a new task to this pool.
+     *
+     * This can be called from any thread, including from the tasks
+     * themselves.
+     *
+     * \param task The task to run.
+     */
+    void submit(Task task);
+
+    /**
+     * Wait for all the submitted tasks (including the ones submitted
+     * by some task) to complete.
+     *
+     * This must not be called by some task of this pool.
+     *
+     * If some task has thrown an exception, the first one is rethrown
+     * (once all the tasks are completed).
+     */
+    void wait();
+
+  };
+
+}
+
+#endif
@@ -44,10 +44,14 @@
 #ifndef __THREADED_READER_WRITER_HPP__
 #define __THREADED_READER_WRITER_HPP__
 
+#include <cassert>
 #include <cstddef>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <circular_queue.hpp>
+#include <thread_pool.hpp>
 
 namespace bijecthash {
 
@@ -60,7 +64,8 @@ namespace bijecthash {
    *
    * \tparam Reader The reader class. This class must have a `run()`
    * method that launches a new thread. This thread must read the data
-   * of type T from the shared circular queue. Thus a reference to
+   * of type T from the shared circular queue until it is both closed
+   * and empty (see CircularQueue::waitPop()). Thus a reference to
    * this circular queue must be given as constructor parameter. This
    * class must also provide a `join()` method that blocks the current
    * thread until the threaded reader ends its execution.
@@ -73,6 +78,13 @@ namespace bijecthash {
    * blocks the current thread until the threaded writer ends its
    * execution.
    *
+   * Alternatively, the readers and the writers can be run as tasks of
+   * a ThreadPool (see run(ThreadPool &)). In such case, the Reader
+   * class must provide a `process(T &)` method that handles one data
+   * and the Writer class must provide a `nextBlock(T &)` method that
+   * produces the next data (returning false once there is no more
+   * data to produce).
+   *
    * \tparam T The type of data handled by both the readers and the
    * writers.
    */
@@ -112,6 +124,28 @@ namespace bijecthash {
      */
     virtual void _post() {}
 
+    /**
+     * Pop some data from the shared queue and have it processed by
+     * the reader associated to the current pool worker.
+     *
+     * Since exactly one task is submitted per enqueued data and since
+     * some data may have been processed by the writer tasks, the
+     * queue may be empty. The pop may also fail while some writer is
+     * still publishing the head data (see run(ThreadPool &)).
+     *
+     * \param pool The pool running the current task.
+     *
+     * \return Returns true if some data was processed.
+     */
+    bool _processOne(ThreadPool &pool) {
+      T data;
+      if (!_queue.pop(data)) {
+        return false;
+      }
+      _readers[pool.currentWorker()].process(data);
+      return true;
+    }
+
 
   public:
 
@@ -139,6 +173,9 @@ namespace bijecthash {
     /**
      * Starts the thread of each reader and writer and waits for each
      * to complete.
+     *
+     * The shared queue is closed once all the writers have completed,
+     * which tells the readers that no more data will come.
      */
     void run() {
       _pre();
@@ -151,12 +188,66 @@ namespace bijecthash {
       for (auto &w: _writers) {
         w.join();
       }
+      _queue.close();
       for (auto &r: _readers) {
         r.join();
       }
       _post();
     }
 
+    /**
+     * Run each writer as a task of the given pool and each data it
+     * produces as another task (handled by the reader associated to
+     * the worker running this task).
+     *
+     * This way, the workers rebalance their load whatever the number
+     * of writers is (each idle worker steals the pending tasks of the
+     * busy ones). The shared queue still bounds the number of
+     * produced data which are not yet handled. When it is full, the
+     * writer task handles some pending data by itself instead of
+     * waiting.
+     *
+     * There must be (at least) one reader per pool worker. The reader
+     * `run()` and `join()` methods are not used at all.
+     *
+     * \param pool The pool running the tasks.
+     */
+    void run(ThreadPool &pool) {
+      assert(_readers.size() >= pool.size());
+      _pre();
+      for (auto &w: _writers) {
+        pool.submit([this, &pool, &w]() {
+          T data;
+          while (w.nextBlock(data)) {
+            while (!_queue.emplace(std::move(data))) {
+              if (!_processOne(pool)) {
+                std::this_thread::yield();
+              }
+            }
+            pool.submit([this, &pool]() {
+              _processOne(pool);
+            });
+          }
+        });
+      }
+      pool.wait();
+      // A task fails to pop some data when the head of the queue is
+      // reserved but not yet published by some writer (even if the
+      // next data are), thus some data may still be pending once all
+      // the tasks have completed. Since there is no more writer, the
+      // remaining data are now handled for sure.
+      while (!_queue.empty()) {
+        for (size_t i = 0; i < pool.size(); ++i) {
+          pool.submit([this, &pool]() {
+            while (_processOne(pool));
+          });
+        }
+        pool.wait();
+      }
+      _queue.close();
+      _post();
+    }
+
   };
 
 }
@@ -46,6 +46,7 @@
 #include "common.hpp"
 #include "exception.hpp"
 #include "locker.hpp"
+#include "nucleotide_kernel.hpp"
 
 #include <iostream>
 
@@ -90,6 +91,11 @@ shared_ptr<const Transformer> Transformer::string2transformer(size_t kmer_length
   if (it != _available_transformers.end()) {
     DEBUG_MSG("Comparison with '" << it->label << "' succeed");
     it->factory(kmer_length, prefix_length, label, extra, t);
+    if (t) {
+      Transformer *ptr = const_cast<Transformer *>(t.get());
+      ptr->_label = label;
+      ptr->_extra = extra;
+    }
   } else {
     Exception e;
     e << "Error: Unsupported transformation method '" << method << "'.\n";
@@ -188,23 +194,15 @@ uint64_t Transformer::_encode(const char *dna_str, size_t n) {
   DEBUG_MSG("n = " << n);
   DEBUG_MSG("dna_str = '" << string(dna_str, n) << "'");
   assert(n <= (4 * sizeof(uint64_t)));
-  uint64_t encoded = 0;
-  for (size_t i = 0; i < n; ++i) {
-    int val = 0;
-    switch (dna_str[i]) {
-    case 'A': val = 0; break;
-    case 'C': val = 1; break;
-    case 'G': val = 2; break;
-    case 'T': val = 3; break;
-    default:
-      Exception e;
-      e << "Error: unable to encode the given k-mer (" << string(dna_str, n) << ")"
-        << " since it contains the symbol '" << dna_str[i] << "'"
-        << " which is neither A nor C nor G nor T.\n";
-      throw e;
-    }
-    encoded = (encoded << 2) | val;
+  const uint64_t invalid = NucleotideKernel::invalidMask(dna_str, n);
+  if (invalid) {
+    Exception e;
+    e << "Error: unable to encode the given k-mer (" << string(dna_str, n) << ")"
+      << " since it contains the symbol '" << dna_str[__builtin_ctzll(invalid)] << "'"
+      << " which is neither A nor C nor G nor T.\n";
+    throw e;
   }
+  const uint64_t encoded = NucleotideKernel::pack(dna_str, n);
   DEBUG_MSG("encoded = " << encoded);
   return encoded;
 }
@@ -222,6 +220,7 @@ string Transformer::_decode(uint64_t v, size_t n) {
 }
 
 Transformer::Transformer(const size_t kmer_length, const size_t prefix_length, const string &description):
+  _label(), _extra(),
   kmer_length(kmer_length),
   prefix_length(prefix_length),
   suffix_length(kmer_length - prefix_length),
@@ -237,6 +236,42 @@ Transformer::Transformer(const size_t kmer_length, const size_t prefix_length, c
   assert((kmer_length - prefix_length) <= (4 * sizeof(uint64_t)));
 }
 
+Transformer::EncodedKmer Transformer::operator()(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  return (*this)(_decode(kmer, kmer_length));
+}
+
+uint64_t Transformer::transformPacked(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  return _join((*this)(kmer));
+}
+
+void Transformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  assert(kmer_length <= 32);
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = (*this)(packed[i]);
+  }
+}
+
+string Transformer::getParameters() const {
+  return _extra;
+}
+
+Transformer::Kernel Transformer::getKernel() const {
+  return Kernel { Kernel::GENERIC, 0, 0 };
+}
+
+string Transformer::getMethod() const {
+  if (_label.empty()) {
+    return "";
+  }
+  string params = getParameters();
+  if (params.empty() || (params[0] == '(')) {
+    return _label + params;
+  }
+  return _label + "=" + params;
+}
+
 string Transformer::getTransformedKmer(const Transformer::EncodedKmer &e) const {
   string kmer = _decode(e.prefix, prefix_length);
   kmer += _decode(e.suffix, suffix_length);
@@ -147,6 +147,16 @@ namespace bijecthash {
      */
     static sphinxpp::PluginHandler _plugin_handler;
 
+    /**
+     * The label of this transformer (set by string2transformer()).
+     */
+    std::string _label;
+
+    /**
+     * The arguments of this transformer (set by string2transformer()).
+     */
+    std::string _extra;
+
   protected:
 
     /**
@@ -209,6 +219,27 @@ namespace bijecthash {
       uint64_t suffix; /**< The encoded suffix */
     };
 
+    /**
+     * Data type describing a transformation having a k-specialized
+     * implementation in the core library (see StaticTransformer).
+     */
+    struct Kernel {
+
+      /**
+       * The transformations having a k-specialized implementation.
+       */
+      enum Kind {
+        GENERIC,   /**< No specialized implementation */
+        IDENTITY,  /**< See the identity transformer */
+        CANONICAL, /**< See the canonical transformer */
+        GAB        /**< See the GaB transformer */
+      };
+
+      Kind kind;  /**< The transformation */
+      uint64_t a; /**< The multiplicative coefficient (GAB only) */
+      uint64_t b; /**< The xor-ed value (GAB only) */
+    };
+
     /**
      * \brief Decodes an empty string of a given length.
      *
@@ -222,6 +253,81 @@ namespace bijecthash {
       return _decode(0, n);
     }
 
+    /**
+     * Decodes a DNA string of length n from a 64 bits integer.
+     *
+     * \param v The encoded value to decode.
+     *
+     * \param n The length of the DNA string to decode (at most 32).
+     *
+     * \return Returns the DNA string such that each 2 bits of the value
+     * (right aligned) represent some nucleotide using A <=> 00, C <=>
+     * 01, G <=> 10 and T <=> 11.
+     */
+    static std::string decode(uint64_t v, size_t n) {
+      return _decode(v, n);
+    }
+
+  protected:
+
+    /**
+     * Split some packed (transformed) k-mer into its prefix/suffix
+     * code (the k-mer length must be at most 32).
+     *
+     * \param v The packed k-mer.
+     *
+     * \return Returns the EncodedKmer made of the prefix and suffix
+     * of the given packed k-mer.
+     */
+    inline EncodedKmer _split(uint64_t v) const {
+      EncodedKmer e;
+      e.prefix = v >> (2 * suffix_length);
+      e.suffix = v & ((1ull << (2 * suffix_length)) - 1);
+      return e;
+    }
+
+    /**
+     * Join some prefix/suffix code into a packed (transformed) k-mer
+     * (the k-mer length must be at most 32).
+     *
+     * The bits of the suffix code beyond the suffix nucleotides (used
+     * by some transformers to store extra informations) are ignored.
+     *
+     * \param e The encoded k-mer.
+     *
+     * \return Returns the packed concatenation of the prefix and the
+     * suffix of the given encoding.
+     */
+    inline uint64_t _join(const EncodedKmer &e) const {
+      return (e.prefix << (2 * suffix_length)) | (e.suffix & ((1ull << (2 * suffix_length)) - 1));
+    }
+
+    /**
+     * Encode some given batch of packed k-mers using the packed
+     * encoding operator of the given transformer class.
+     *
+     * The operator is called without virtual dispatch, which allows
+     * the compiler to inline (and possibly vectorize) it in the loop.
+     * This is the helper used by derived classes to overload
+     * transformBatch().
+     *
+     * \param transformer The transformer to use.
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    template <typename T>
+    static inline void _transformBatch(const T &transformer, const uint64_t *packed, size_t n, EncodedKmer *out) {
+      for (size_t i = 0; i < n; ++i) {
+        out[i] = transformer.T::operator()(packed[i]);
+      }
+    }
+
+  public:
+
     /**
      * Builds a Transformer depending on the k-mer length and the prefix
      * length.
@@ -251,6 +357,69 @@ namespace bijecthash {
      */
     virtual EncodedKmer operator()(const std::string &kmer) const = 0;
 
+    /**
+     * Encode some given packed k-mer into a prefix/suffix code.
+     *
+     * The k-mer is given using two bits per nucleotide (A <=> 00, C
+     * <=> 01, G <=> 10 and T <=> 11, the first nucleotide being
+     * encoded by the most significant used bits), which is only
+     * possible when \f$k \leq 32\f$.
+     *
+     * By default, the k-mer is decoded then encoded using the string
+     * version of this operator, thus derived classes that can work on
+     * the packed k-mer directly should overload this operator.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    virtual EncodedKmer operator()(uint64_t kmer) const;
+
+    /**
+     * Transform some given packed k-mer into a packed transformed
+     * k-mer.
+     *
+     * This is the packed word to packed word stage of this
+     * transformer, *i.e.*, the packed version of
+     * `getTransformedKmer((*this)(kmer))`, which allows to chain
+     * transformers without any string round trip (see
+     * CompositionTransformer). It is only available when \f$k \leq
+     * 32\f$.
+     *
+     * By default, the k-mer is encoded using the packed version of
+     * the encoding operator then its prefix and suffix are joined,
+     * which is consistent with the default getTransformedKmer()
+     * method. Derived classes overloading getTransformedKmer() for
+     * such k-mers should overload this method too.
+     *
+     * \param kmer The packed k-mer to transform.
+     *
+     * \return Returns the packed transformed k-mer.
+     */
+    virtual uint64_t transformPacked(uint64_t kmer) const;
+
+    /**
+     * Encode some given batch of packed k-mers into prefix/suffix
+     * codes.
+     *
+     * This amortizes the cost of the (virtual) call over the whole
+     * batch. The encodings are stored contiguously, in the order of
+     * the given k-mers, which is the layout of the blocks of encoded
+     * k-mers of the index.
+     *
+     * By default, the packed version of the encoding operator is
+     * called for each k-mer, thus derived classes should overload this
+     * method (see _transformBatch()). It is only available when \f$k
+     * \leq 32\f$.
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    virtual void transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const;
+
     /**
      * Decode some given encoded k-mer.
      *
@@ -275,6 +444,44 @@ namespace bijecthash {
      */
     virtual std::string getTransformedKmer(const EncodedKmer &e) const;
 
+    /**
+     * Get the arguments allowing to build a transformer identical to
+     * this one using its label (see getMethod()).
+     *
+     * By default, this returns the arguments given to the
+     * string2transformer() method, thus each derived class using
+     * random parameters (or any parameter that is not given as
+     * argument) should overload this method.
+     *
+     * \return Returns the arguments of this transformer (without the
+     * leading '=' symbol).
+     */
+    virtual std::string getParameters() const;
+
+    /**
+     * Get the description of the transformation operated by this
+     * transformer if it has a k-specialized implementation in the
+     * core library (see StaticTransformer).
+     *
+     * By default, this returns a GENERIC kernel. A derived class
+     * returning another kernel must produce exactly the same
+     * encodings as the specialized implementation.
+     *
+     * \return Returns the description of the transformation.
+     */
+    virtual Kernel getKernel() const;
+
+    /**
+     * Get the method allowing to build a transformer identical to this
+     * one (including its random parameters, if any) using the
+     * string2transformer() method.
+     *
+     * \return Returns the transformer method (the label followed by
+     * the parameters) or an empty string if this transformer wasn't
+     * built using the string2transformer() method.
+     */
+    std::string getMethod() const;
+
     /**
      * This method compute the Transformer corresponding to the given
      * string description.
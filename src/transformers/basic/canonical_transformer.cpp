@@ -44,81 +44,76 @@
 #include "canonical_transformer.hpp"
 
 #include "common.hpp"
-#include "exception.hpp"
-
-#include <iostream>
+#include "nucleotide_kernel.hpp"
 
 using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
-static char complement(char nucl) {
-  if (nucl > 'Z') {
-    nucl += 'A' - 'a';
-  }
-  switch (nucl) {
-  case 'A': return 'T';
-  case 'C': return 'G';
-  case 'G': return 'C';
-  case 'T':
-  case 'U': return 'A';
-  default:
-    Exception e;
-    e << "Unable to compute the reverse complement of nucleotide '" << nucl << "'\n";
-    throw e;
-  }
-  return 0;
-}
-
 CanonicalTransformer::CanonicalTransformer(size_t kmer_length, size_t prefix_length):
-  Transformer(kmer_length, prefix_length, "Canonical") {
+  Transformer(kmer_length, prefix_length, "Canonical"),
+  _suffix_mask((1ull << (2 * suffix_length)) - 1)
+{
   // We need one bit (to store information about the conserved k-mer
   // (between the k-mer and is reverse).
   assert(suffix_length < ((sizeof(uint64_t) << 3) / 2));
 }
 
-Transformer::EncodedKmer CanonicalTransformer::operator()(const string &kmer) const {
-  assert(kmer.length() == kmer_length);
-  string lowest_kmer(kmer_length, '\0');
-  size_t i = 0;
-  int best = 0;
-  while ((best >= 0) && (i < kmer_length)) {
-    lowest_kmer[i] = complement(kmer[kmer_length - i - 1]);
-    if (best == 0) {
-      if (kmer[i] < lowest_kmer[i]) {
-        best = -1;
-      } else {
-        if (kmer[i] > lowest_kmer[i]) {
-          best = 1;
-        }
-      }
-    }
-    ++i;
-  }
+Transformer::EncodedKmer CanonicalTransformer::_encodeLowest(uint64_t kmer_hi, uint64_t kmer_lo,
+                                                             uint64_t rc_hi, uint64_t rc_lo) const {
+  // Since A < C < G < T, both the lexicographic order of the k-mers
+  // and the numeric order of their 2 bits encoding are the same. As
+  // for the string version, the reverse complement is kept on ties.
   uint64_t m = 0;
-  if (best < 0) {
-    lowest_kmer = kmer;
-  } else {
+  if ((rc_hi < kmer_hi) || ((rc_hi == kmer_hi) && (rc_lo <= kmer_lo))) {
+    kmer_hi = rc_hi;
+    kmer_lo = rc_lo;
     m = 1ull << 62;
   }
   EncodedKmer e;
-  e.prefix = _encode(lowest_kmer.c_str(), prefix_length);
-  e.suffix = _encode(lowest_kmer.c_str() + prefix_length, suffix_length);
-  e.suffix |= m;
+  e.prefix = (kmer_hi << (2 * (32 - suffix_length))) | (kmer_lo >> (2 * suffix_length));
+  e.suffix = (kmer_lo & _suffix_mask) | m;
   return e;
 }
 
+Transformer::EncodedKmer CanonicalTransformer::operator()(const string &kmer) const {
+  assert(kmer.length() == kmer_length);
+  if (kmer_length <= 32) {
+    return (*this)(_encode(kmer.c_str(), kmer_length));
+  }
+  // The k-mer is packed on two words, the low one holding its last 32
+  // nucleotides. Its reverse complement starts with the reverse
+  // complement of these 32 nucleotides.
+  const size_t n = kmer_length - 32;
+  const uint64_t kmer_hi = _encode(kmer.c_str(), n);
+  const uint64_t kmer_lo = _encode(kmer.c_str() + n, 32);
+  const uint64_t rc_lo = NucleotideKernel::reverseComplement(kmer_lo, 32);
+  return _encodeLowest(kmer_hi, kmer_lo,
+                       rc_lo >> (2 * (32 - n)),
+                       (rc_lo << (2 * n)) | NucleotideKernel::reverseComplement(kmer_hi, n));
+}
+
+Transformer::EncodedKmer CanonicalTransformer::operator()(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  return _encodeLowest(0, kmer, 0, NucleotideKernel::reverseComplement(kmer, kmer_length));
+}
+
+void CanonicalTransformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  _transformBatch(*this, packed, n, out);
+}
+
 string CanonicalTransformer::operator()(const Transformer::EncodedKmer &e) const {
-  string kmer = getTransformedKmer(e);
-  if (e.suffix >> 62) {
-    size_t p = (kmer_length >> 1) + (kmer_length & 1);
-    for (size_t i = 0; i < p; ++i) {
-      char c = complement(kmer[i]);
-      kmer[i] = complement(kmer[kmer_length - i - 1]);
-      kmer[kmer_length - i - 1] = c;
-    }
+  if (!(e.suffix >> 62)) {
+    return getTransformedKmer(e);
   }
-  return kmer;
+  // The reverse complement of the suffix is the beginning of the
+  // original k-mer, and the reverse complement of the prefix its end.
+  return (_decode(NucleotideKernel::reverseComplement(e.suffix & _suffix_mask, suffix_length), suffix_length)
+          + _decode(NucleotideKernel::reverseComplement(e.prefix, prefix_length), prefix_length));
+}
+
+Transformer::Kernel CanonicalTransformer::getKernel() const {
+  return Kernel { Kernel::CANONICAL, 0, 0 };
 }
 
 END_BIJECTHASH_NAMESPACE
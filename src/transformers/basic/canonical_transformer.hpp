@@ -45,6 +45,7 @@
 #define __CANONICAL_TRANSFORMER_HPP__
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <transformer.hpp>
@@ -57,6 +58,32 @@ namespace bijecthash {
    */
   class CanonicalTransformer: public Transformer {
 
+  private:
+
+    /**
+     * The mask of the bits of the suffix encoding.
+     */
+    const uint64_t _suffix_mask;
+
+    /**
+     * Encode the lowest of some packed k-mer and its reverse
+     * complement.
+     *
+     * Both are given on two words, the low one holding the (up to) 32
+     * last nucleotides and the high one the remaining first ones.
+     *
+     * \param kmer_hi The high word of the packed k-mer.
+     *
+     * \param kmer_lo The low word of the packed k-mer.
+     *
+     * \param rc_hi The high word of the packed reverse complement.
+     *
+     * \param rc_lo The low word of the packed reverse complement.
+     *
+     * \return Returns the EncodedKmer of the lowest of both.
+     */
+    EncodedKmer _encodeLowest(uint64_t kmer_hi, uint64_t kmer_lo, uint64_t rc_hi, uint64_t rc_lo) const;
+
   public:
 
     /**
@@ -81,6 +108,30 @@ namespace bijecthash {
      */
     virtual EncodedKmer operator()(const std::string &kmer) const override;
 
+    /**
+     * Encode some given packed k-mer into a prefix/suffix code.
+     *
+     * The reverse complement of the packed k-mer is computed in
+     * constant time using bit tricks.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    virtual EncodedKmer operator()(uint64_t kmer) const override;
+
+    /**
+     * Encode some given batch of packed k-mers into prefix/suffix
+     * codes (see Transformer::transformBatch()).
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    virtual void transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const override;
+
     /**
      * Decode some given encoded k-mer.
      *
@@ -92,6 +143,14 @@ namespace bijecthash {
      */
     virtual std::string operator()(const EncodedKmer &e) const override;
 
+    /**
+     * Get the description of the transformation operated by this
+     * transformer (see Transformer::getKernel()).
+     *
+     * \return Returns the CANONICAL kernel.
+     */
+    virtual Kernel getKernel() const override;
+
   };
 
 }
@@ -45,15 +45,18 @@
 
 #include "common.hpp"
 #include "exception.hpp"
-#include "identity_transformer.hpp"
+
+#include <algorithm>
 
 using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
 CompositionTransformer::CompositionTransformer(size_t kmer_length, size_t prefix_length, shared_ptr<const Transformer> &t1, shared_ptr<const Transformer> &t2, const string &description):
-  Transformer(kmer_length, prefix_length, description), _t1(t1), _t2(t2)
+  Transformer(kmer_length, prefix_length, description), _t1(t1), _t2(t2), _stages()
 {
+  _appendStages(_t1);
+  _appendStages(_t2);
   if (description.empty()) {
     string *desc_ptr = const_cast<string *>(&(this->description));
     desc_ptr->clear();
@@ -66,7 +69,26 @@ CompositionTransformer::CompositionTransformer(size_t kmer_length, size_t prefix
   DEBUG_MSG("description: '" << description << "'");
 }
 
+void CompositionTransformer::_appendStages(const shared_ptr<const Transformer> &t) {
+  shared_ptr<const CompositionTransformer> c = dynamic_pointer_cast<const CompositionTransformer>(t);
+  if (c) {
+    _stages.insert(_stages.end(), c->_stages.begin(), c->_stages.end());
+  } else {
+    _stages.push_back(t.get());
+  }
+}
+
+Transformer::EncodedKmer CompositionTransformer::_splitKmer(const string &kmer) const {
+  EncodedKmer e;
+  e.prefix = _encode(kmer.c_str(), prefix_length);
+  e.suffix = _encode(kmer.c_str() + prefix_length, suffix_length);
+  return e;
+}
+
 Transformer::EncodedKmer CompositionTransformer::operator()(const string &kmer) const {
+  if (kmer_length <= 32) {
+    return (*this)(_encode(kmer.c_str(), kmer_length));
+  }
   EncodedKmer e1 = (*_t1)(kmer);
   string s1 = _t1->getTransformedKmer(e1);
   EncodedKmer e2 = (*_t2)(s1);
@@ -83,22 +105,60 @@ Transformer::EncodedKmer CompositionTransformer::operator()(const string &kmer)
   return e2;
 }
 
+Transformer::EncodedKmer CompositionTransformer::operator()(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  // Each stage but the last one transforms the packed k-mer, and the
+  // last one encodes it.
+  const size_t n = _stages.size() - 1;
+  uint64_t v = kmer;
+  for (size_t i = 0; i < n; ++i) {
+    v = _stages[i]->transformPacked(v);
+  }
+  EncodedKmer e = (*_stages[n])(v);
+#ifdef DEBUG
+  string orig_kmer = (*this)(e);
+  DEBUG_MSG("orig_kmer: '" << orig_kmer << "'");
+  if (orig_kmer != _decode(kmer, kmer_length)) {
+    throw Exception("Error: the unpermuted k-mer differs from the original k-mer.\n");
+  }
+#endif
+  return e;
+}
+
+void CompositionTransformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  assert(kmer_length <= 32);
+  const size_t last = _stages.size() - 1;
+  uint64_t chunk[256];
+  for (size_t first = 0; first < n; first += 256) {
+    const size_t m = min<size_t>(n - first, 256);
+    copy(packed + first, packed + first + m, chunk);
+    for (size_t s = 0; s < last; ++s) {
+      const Transformer &t = *_stages[s];
+      for (size_t i = 0; i < m; ++i) {
+        chunk[i] = t.transformPacked(chunk[i]);
+      }
+    }
+    _stages[last]->transformBatch(chunk, m, out + first);
+  }
+}
+
+uint64_t CompositionTransformer::transformPacked(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  for (const Transformer *t: _stages) {
+    kmer = t->transformPacked(kmer);
+  }
+  return kmer;
+}
+
 string CompositionTransformer::operator()(const Transformer::EncodedKmer &e) const {
-  // string s2 = (*_t2)(e);
-  // EncodedKmer e1;
-  // e1.prefix = _encode(s2.c_str(), prefix_length);
-  // e1.suffix = _encode(s2.c_str() + prefix_length, suffix_length);
-  // string s1 = (*_t1)(e1);
   string s2 = (*_t2)(e);
-  EncodedKmer e1 = IdentityTransformer(kmer_length, prefix_length)(s2);
-  string s1 = (*_t1)(e1);
+  string s1 = (*_t1)(_splitKmer(s2));
   return s1;
 }
 
 string CompositionTransformer::getTransformedKmer(const Transformer::EncodedKmer &e) const {
   string s2 = _t2->getTransformedKmer(e);
-  EncodedKmer e1 = IdentityTransformer(kmer_length, prefix_length)(s2);
-  string s1 = _t1->getTransformedKmer(e1);
+  string s1 = _t1->getTransformedKmer(_splitKmer(s2));
   return s1;
 }
 
@@ -109,4 +169,8 @@ shared_ptr<const CompositionTransformer> operator*(shared_ptr<const Transformer>
   return t;
 }
 
+string CompositionTransformer::getParameters() const {
+  return "(" + _t1->getMethod() + "*" + _t2->getMethod() + ")";
+}
+
 END_BIJECTHASH_NAMESPACE
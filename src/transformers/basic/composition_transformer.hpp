@@ -47,6 +47,7 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <transformer.hpp>
 
@@ -70,6 +71,34 @@ namespace bijecthash {
      */
     std::shared_ptr<const Transformer> _t2;
 
+    /**
+     * The flattened chain of the composed (non composition)
+     * transformers, in application order.
+     *
+     * The transformers are owned by _t1 and _t2 (or their own
+     * composed transformers).
+     */
+    std::vector<const Transformer *> _stages;
+
+    /**
+     * Append the flattened chain of the given transformer to the
+     * stages of this composition.
+     *
+     * \param t The transformer to append.
+     */
+    void _appendStages(const std::shared_ptr<const Transformer> &t);
+
+    /**
+     * Split some (transformed) k-mer into its prefix/suffix code
+     * without any transformation.
+     *
+     * \param kmer The k-mer to split.
+     *
+     * \return Returns the encoding of the prefix and suffix of the
+     * given k-mer.
+     */
+    EncodedKmer _splitKmer(const std::string &kmer) const;
+
   public:
 
     /**
@@ -105,6 +134,44 @@ namespace bijecthash {
      */
     virtual EncodedKmer operator()(const std::string &kmer) const override;
 
+    /**
+     * Encode some given packed k-mer into a prefix/suffix code.
+     *
+     * The packed k-mer goes through the packed stages of the composed
+     * transformers (see Transformer::transformPacked()) without being
+     * decoded.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    virtual EncodedKmer operator()(uint64_t kmer) const override;
+
+    /**
+     * Encode some given batch of packed k-mers into prefix/suffix
+     * codes (see Transformer::transformBatch()).
+     *
+     * The k-mers go through the packed stages by chunks, stage after
+     * stage, then the last stage encodes each chunk at once.
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    virtual void transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const override;
+
+    /**
+     * Transform some given packed k-mer into a packed transformed
+     * k-mer.
+     *
+     * \param kmer The packed k-mer to transform.
+     *
+     * \return Returns the packed transformed k-mer.
+     */
+    virtual uint64_t transformPacked(uint64_t kmer) const override;
+
     /**
      * Decode some given encoded k-mer.
      *
@@ -125,6 +192,15 @@ namespace bijecthash {
      */
     virtual std::string getTransformedKmer(const EncodedKmer &e) const override;
 
+    /**
+     * Get the arguments allowing to build a transformer identical to
+     * this one.
+     *
+     * \return Returns the "(t1*t2)" string where t1 and t2 are the
+     * methods of the composed transformers.
+     */
+    virtual std::string getParameters() const override;
+
   };
 
   std::shared_ptr<const CompositionTransformer> operator*(std::shared_ptr<const Transformer> &t2, std::shared_ptr<const Transformer> &t1);
@@ -56,8 +56,23 @@ Transformer::EncodedKmer IdentityTransformer::operator()(const std::string &kmer
   return e;
 }
 
+Transformer::EncodedKmer IdentityTransformer::operator()(uint64_t kmer) const {
+  EncodedKmer e;
+  e.prefix = kmer >> (2 * suffix_length);
+  e.suffix = kmer & ((1ull << (2 * suffix_length)) - 1);
+  return e;
+}
+
+void IdentityTransformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  _transformBatch(*this, packed, n, out);
+}
+
 string IdentityTransformer::operator()(const Transformer::EncodedKmer &e) const {
   return getTransformedKmer(e);
 }
 
+Transformer::Kernel IdentityTransformer::getKernel() const {
+  return Kernel { Kernel::IDENTITY, 0, 0 };
+}
+
 END_BIJECTHASH_NAMESPACE
@@ -82,6 +82,27 @@ namespace bijecthash {
      */
     virtual EncodedKmer operator()(const std::string &kmer) const override;
 
+    /**
+     * Encode some given packed k-mer into a prefix/suffix code.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    virtual EncodedKmer operator()(uint64_t kmer) const override;
+
+    /**
+     * Encode some given batch of packed k-mers into prefix/suffix
+     * codes (see Transformer::transformBatch()).
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    virtual void transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const override;
+
     /**
      * Decode some given encoded k-mer.
      *
@@ -93,6 +114,14 @@ namespace bijecthash {
      */
     virtual std::string operator()(const EncodedKmer &e) const override;
 
+    /**
+     * Get the description of the transformation operated by this
+     * transformer (see Transformer::getKernel()).
+     *
+     * \return Returns the IDENTITY kernel.
+     */
+    virtual Kernel getKernel() const override;
+
   };
 
 }
@@ -43,6 +43,7 @@
 
 #include <sphinx++/macros.h>
 
+#include <cstdlib>
 #include <memory>
 #include <string>
 #include <vector>
@@ -78,16 +79,18 @@ BEGIN_BIJECTHASH_NAMESPACE
   "and its reverse complement according to the lexicographic order."
 
 #define RANDOM_NUCL_TRANSFORMER_LABEL       "random_nucl" SUFFIX
-#define RANDOM_NUCL_TRANSFORMER_EXTRA       ""
+#define RANDOM_NUCL_TRANSFORMER_EXTRA       "[=<p_0>,...,<p_{k-1}>]"
 #define RANDOM_NUCL_TRANSFORMER_DESCRIPTION                             \
   "The '" RANDOM_NUCL_TRANSFORMER_LABEL RANDOM_NUCL_TRANSFORMER_EXTRA "' " \
-  "is a (fixed) permutation at the nucleotide level of the given k-mer."
+  "is a (fixed) permutation at the nucleotide level of the given k-mer " \
+  "(default: a random permutation of the k positions)."
 
 #define RANDOM_BITS_TRANSFORMER_LABEL       "random_bits" SUFFIX
-#define RANDOM_BITS_TRANSFORMER_EXTRA       ""
+#define RANDOM_BITS_TRANSFORMER_EXTRA       "[=<p_0>,...,<p_{2k-1}>]"
 #define RANDOM_BITS_TRANSFORMER_DESCRIPTION                             \
   "The '" RANDOM_BITS_TRANSFORMER_LABEL RANDOM_BITS_TRANSFORMER_EXTRA "' " \
-  "is a (fixed) permutation at the bit level of the given k-mer."
+  "is a (fixed) permutation at the bit level of the given k-mer " \
+  "(default: a random permutation of the 2k bits)."
 
 #define INVERSE_TRANSFORMER_LABEL           "inverse" SUFFIX
 #define INVERSE_TRANSFORMER_EXTRA           ""
@@ -120,6 +123,37 @@ BEGIN_BIJECTHASH_NAMESPACE
 ////////////////////////////////////////////////////////////////
 
 
+static vector<size_t> _parsePermutation(const string &label, const string &extra, size_t n) {
+  vector<size_t> p;
+  if (extra.empty()) {
+    return p;
+  }
+  vector<bool> seen(n, false);
+  const char *ptr = extra.c_str();
+  do {
+    char *end;
+    size_t v = strtoul(ptr, &end, 10);
+    if ((end == ptr) || (v >= n) || seen[v]) {
+      Exception e;
+      e << "Error: unable to parse the permutation of the '" << label << "' method." << endl
+        << "       Expecting a permutation of [0; " << n << "[." << endl
+        << "=> '" << label << "=" << extra << "'" << endl
+        << "   " << string(label.size() + (ptr - extra.c_str()) + 2, ' ') << "^\n";
+      throw e;
+    }
+    seen[v] = true;
+    p.push_back(v);
+    ptr = end + (*end == ',');
+  } while (*ptr && (p.size() < n));
+  if (*ptr || (p.size() != n)) {
+    Exception e;
+    e << "Error: unable to parse the permutation of the '" << label << "' method." << endl
+      << "       Expecting exactly " << n << " values." << endl;
+    throw e;
+  }
+  return p;
+}
+
 shared_ptr<const Transformer> _transformerFactory(size_t kmer_length,
                                                   size_t prefix_length,
                                                   const string &label,
@@ -131,9 +165,11 @@ shared_ptr<const Transformer> _transformerFactory(size_t kmer_length,
   } else if (label == CANONICAL_TRANSFORMER_LABEL) {
     t = make_shared<const CanonicalTransformer>(kmer_length, prefix_length);
   } else if (label == RANDOM_NUCL_TRANSFORMER_LABEL) {
-    t = make_shared<const PermutationTransformer>(kmer_length, prefix_length);
+    vector<size_t> p = _parsePermutation(label, extra, kmer_length);
+    t = make_shared<const PermutationTransformer>(kmer_length, prefix_length, p);
   } else if (label == RANDOM_BITS_TRANSFORMER_LABEL) {
-    t = make_shared<const PermutationBitTransformer>(kmer_length, prefix_length);
+    vector<size_t> p = _parsePermutation(label, extra, kmer_length <= 32 ? 2 * kmer_length : 64);
+    t = make_shared<const PermutationBitTransformer>(kmer_length, prefix_length, p);
   } else if (label == INVERSE_TRANSFORMER_LABEL) {
     vector<size_t> p(kmer_length);
     for (size_t i = 0; i < kmer_length; ++i) {
@@ -55,16 +55,38 @@ using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
-uint64_t PermutationBitTransformer::_applyBitwisePermutation(uint64_t encoded_kmer, const vector<size_t> &permutation) const {
+uint64_t PermutationBitTransformer::_applyBitwisePermutation(uint64_t encoded_kmer, const vector<uint64_t> &table) const {
+  assert(((table.size() >> 8) == 8) || !(encoded_kmer >> (table.size() >> 5)));
   uint64_t permuted = 0;
-  for (size_t i = 0; i < permutation.size(); ++i) {
-    size_t bit_index = permutation[i];
-    uint64_t bit = (encoded_kmer >> bit_index) & 1;
-    permuted |= (bit << i);
+  const uint64_t *byte_table = table.data();
+  while (encoded_kmer) {
+    permuted |= byte_table[encoded_kmer & 0xFF];
+    encoded_kmer >>= 8;
+    byte_table += 256;
   }
   return permuted;
 }
 
+vector<uint64_t> PermutationBitTransformer::_computePermutationTable(const vector<size_t> &p) {
+  // The i-th bit of the permuted value is the p[i]-th bit of the
+  // original value. Thus, for each byte of the original value, the
+  // table stores the bits of the permuted value set by each of the 256
+  // possible byte values.
+  const size_t n = p.size();
+  const size_t nb_bytes = (n + 7) >> 3;
+  vector<uint64_t> table(nb_bytes << 8, 0);
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t *byte_table = &table[(p[i] >> 3) << 8];
+    const size_t bit = p[i] & 7;
+    for (size_t b = 0; b < 256; ++b) {
+      if ((b >> bit) & 1) {
+        byte_table[b] |= 1ull << i;
+      }
+    }
+  }
+  return table;
+}
+
 vector<size_t> PermutationBitTransformer::_generateRandomPermutation(size_t n) {
   vector<size_t> p(n);
   iota(p.begin(), p.end(), 0);
@@ -91,9 +113,9 @@ Transformer::EncodedKmer PermutationBitTransformer::operator()(const string &kme
 #ifdef DEBUG
     uint64_t orig = v;
 #endif
-    v = _applyBitwisePermutation(v, _permutation);
+    v = _applyBitwisePermutation(v, _permutation_table);
 #ifdef DEBUG
-    uint64_t rev_v = _applyBitwisePermutation(v, _reverse_permutation);
+    uint64_t rev_v = _applyBitwisePermutation(v, _reverse_permutation_table);
     DEBUG_MSG("orig = " << orig);
     DEBUG_MSG("v = " << v);
     DEBUG_MSG("rev_v = " << rev_v);
@@ -102,23 +124,42 @@ Transformer::EncodedKmer PermutationBitTransformer::operator()(const string &kme
     e.prefix = v >> _prefix_shift;
     e.suffix = v & _suffix_mask;
   } else {
+    // Only the first 32 nucleotides are permuted. The transformed
+    // k-mer is the permuted word followed by the last nucleotides,
+    // thus the suffix starts with the end of the permuted word (if
+    // the prefix is shorter than 32 nucleotides).
+    const size_t n = kmer_length - 32;
     uint64_t prefix = _encode(kmer.c_str(), 32);
-    uint64_t suffix = _encode(kmer.c_str() + 32, kmer_length - 32);
-    uint64_t prefix_transformed = _applyBitwisePermutation(prefix, _permutation);
+    uint64_t suffix = _encode(kmer.c_str() + 32, n);
+    uint64_t prefix_transformed = _applyBitwisePermutation(prefix, _permutation_table);
     e.prefix = prefix_transformed >> _prefix_shift;
-    e.suffix = prefix_transformed << (prefix_length << 1) | suffix;
+    e.suffix = ((n < 32) ? ((prefix_transformed & ((1ull << _prefix_shift) - 1)) << (n << 1)) : 0) | suffix;
   }
   return e;
 }
 
+Transformer::EncodedKmer PermutationBitTransformer::operator()(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  EncodedKmer e;
+  const uint64_t v = _applyBitwisePermutation(kmer, _permutation_table);
+  e.prefix = v >> _prefix_shift;
+  e.suffix = v & _suffix_mask;
+  return e;
+}
+
+void PermutationBitTransformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  _transformBatch(*this, packed, n, out);
+}
+
 string PermutationBitTransformer::operator()(const EncodedKmer &e) const {
   if (kmer_length <= 32) {
     uint64_t v = (e.prefix << _prefix_shift) | e.suffix;
-    v = _applyBitwisePermutation(v, _reverse_permutation);
+    v = _applyBitwisePermutation(v, _reverse_permutation_table);
     return _decode(v, kmer_length);
   } else {
-    uint64_t u = (e.prefix << _prefix_shift) | (e.suffix >> (prefix_length << 1));
-    u = _applyBitwisePermutation(u, _reverse_permutation);
+    const size_t n = kmer_length - 32;
+    uint64_t u = (e.prefix << _prefix_shift) | ((n < 32) ? (e.suffix >> (n << 1)) : 0);
+    u = _applyBitwisePermutation(u, _reverse_permutation_table);
     uint64_t v = e.suffix & _suffix_mask;
     return _decode(u, 32) + _decode(v, kmer_length - 32);
   }
@@ -127,8 +168,11 @@ string PermutationBitTransformer::operator()(const EncodedKmer &e) const {
 PermutationBitTransformer::PermutationBitTransformer(size_t kmer_length, size_t prefix_length,
                                                      const vector<size_t> &permutation, const string &description):
   Transformer(kmer_length, prefix_length, description),
-  _permutation(permutation.size() == 2 * kmer_length ? permutation : _generateRandomPermutation(kmer_length <= 32 ? 2 * kmer_length : 64)),
+  _permutation(permutation.size() == (kmer_length <= 32 ? 2 * kmer_length : 64) ? permutation : _generateRandomPermutation(kmer_length <= 32 ? 2 * kmer_length : 64)),
   _reverse_permutation(_computeReversePermutation(_permutation)),
+  _permutation_table(_computePermutationTable(_permutation)),
+  _reverse_permutation_table(_computePermutationTable(_reverse_permutation)),
+  _random_permutation(permutation.size() != _permutation.size()),
   _kmer_mask((1ull << kmer_length << kmer_length) - 1ull),
   _prefix_shift((((kmer_length > 32) ? 32 : kmer_length) - prefix_length) << 1),
   _suffix_mask((kmer_length > 32) ? ((1ull << ((kmer_length - 32) << 1)) - 1) : ((1ull << (suffix_length << 1)) - 1))
@@ -137,7 +181,7 @@ PermutationBitTransformer::PermutationBitTransformer(size_t kmer_length, size_t
     string *desc_ptr = const_cast<string *>(&(this->description));
     desc_ptr->clear();
     *desc_ptr += "Permutation_bins[";
-    for (size_t i = 0; i < 2 * kmer_length; ++i) {
+    for (size_t i = 0; i < _permutation.size(); ++i) {
       if (i) *desc_ptr += ",";
       *desc_ptr += to_string(_permutation[i]);
     }
@@ -147,25 +191,37 @@ PermutationBitTransformer::PermutationBitTransformer(size_t kmer_length, size_t
   DEBUG_MSG("description: '" << description << "'" << '\n';
             cerr << MSG_DBG_HEADER << "permutation:" << '\n';
             cerr << "  ";
-            for (size_t i = 0; i < 2 * kmer_length; ++i) {
+            for (size_t i = 0; i < _permutation.size(); ++i) {
               cerr << setw(4) << i;
             }
             cerr << '\n' << "  ";
-            for (size_t i = 0; i < 2 * kmer_length; ++i) {
+            for (size_t i = 0; i < _permutation.size(); ++i) {
               cerr << setw(4) << _permutation[i];
             }
             cerr << '\n';
             cerr << MSG_DBG_HEADER << "reverse permutation:" << '\n';
             cerr << "  ";
-            for (size_t i = 0; i < 2 * kmer_length; ++i) {
+            for (size_t i = 0; i < _permutation.size(); ++i) {
               cerr << setw(4) << i;
             }
             cerr << '\n';
             cerr << "  ";
-            for (size_t i = 0; i < 2 * kmer_length; ++i) {
+            for (size_t i = 0; i < _permutation.size(); ++i) {
               cerr << setw(4) << _reverse_permutation[i];
             }
             cerr);
 }
 
+string PermutationBitTransformer::getParameters() const {
+  if (!_random_permutation) {
+    return Transformer::getParameters();
+  }
+  string params;
+  for (size_t i = 0; i < _permutation.size(); ++i) {
+    if (i) params += ",";
+    params += to_string(_permutation[i]);
+  }
+  return params;
+}
+
 END_BIJECTHASH_NAMESPACE
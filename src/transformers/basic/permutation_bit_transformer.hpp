@@ -66,11 +66,12 @@ namespace bijecthash {
      *
      * \param encoded_kmer The value to permute (interpreted as a bit sequence).
      *
-     * \param permutation The permutation of the bits to apply.
+     * \param table The byte-wise lookup table of the permutation of
+     * the bits to apply (see _computePermutationTable()).
      *
      * \return Returns the permuted value (interpreted as a bit sequence).
      */
-    uint64_t _applyBitwisePermutation(uint64_t encoded_kmer, const std::vector<size_t> &permutation) const;
+    uint64_t _applyBitwisePermutation(uint64_t encoded_kmer, const std::vector<uint64_t> &table) const;
 
   protected:
 
@@ -85,6 +86,24 @@ namespace bijecthash {
      */
     const std::vector<size_t> _reverse_permutation;
 
+    /**
+     * The byte-wise lookup table of the permutation.
+     *
+     * For each byte \f$j\f$ of the value to permute and each possible
+     * value \f$b\f$ of this byte, the entry at \f$256j+b\f$ is the
+     * value whose bits are the permuted bits of \f$b\f$.
+     */
+    const std::vector<uint64_t> _permutation_table;
+
+    /**
+     * The byte-wise lookup table of the reverse permutation.
+     */
+    const std::vector<uint64_t> _reverse_permutation_table;
+
+    /**
+     * Whether the permutation was randomly generated.
+     */
+    const bool _random_permutation;
 
     /**
      * Precomputed binary mask for retrieving the whole k-mer.
@@ -119,6 +138,21 @@ namespace bijecthash {
      */
     static std::vector<size_t> _computeReversePermutation(const std::vector<size_t> &p);
 
+    /**
+     * This method computes the byte-wise lookup table of the given
+     * bit permutation.
+     *
+     * Permuting a value then requires one lookup per (non null) byte
+     * instead of one shift per bit.
+     *
+     * \param p Some permutation of the range [0; |p|[ with |p| at
+     * most 64.
+     *
+     * \return Returns the \f$256\lceil|p|/8\rceil\f$ entries lookup
+     * table of the given permutation.
+     */
+    static std::vector<uint64_t> _computePermutationTable(const std::vector<size_t> &p);
+
   public:
 
     /**
@@ -149,6 +183,27 @@ namespace bijecthash {
      */
     virtual EncodedKmer operator()(const std::string &kmer) const override;
 
+    /**
+     * Encode some given packed k-mer into a prefix/suffix code.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    virtual EncodedKmer operator()(uint64_t kmer) const override;
+
+    /**
+     * Encode some given batch of packed k-mers into prefix/suffix
+     * codes (see Transformer::transformBatch()).
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    virtual void transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const override;
+
     /**
      * Decode some given encoded k-mer.
      *
@@ -160,6 +215,16 @@ namespace bijecthash {
      */
     virtual std::string operator()(const EncodedKmer &e) const override;
 
+    /**
+     * Get the arguments allowing to build a transformer identical to
+     * this one.
+     *
+     * \return Returns the comma separated bit permutation if it was
+     * randomly generated and the arguments given at construction
+     * otherwise.
+     */
+    virtual std::string getParameters() const override;
+
   };
 
 }
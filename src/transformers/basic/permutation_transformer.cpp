@@ -45,6 +45,7 @@
 
 #include "common.hpp"
 #include "exception.hpp"
+#include "nucleotide_kernel.hpp"
 
 #include <algorithm>
 #ifdef DEBUG
@@ -59,7 +60,17 @@ BEGIN_BIJECTHASH_NAMESPACE
 PermutationTransformer::PermutationTransformer(size_t kmer_length, size_t prefix_length, const vector<size_t> &permutation, const string &description):
   Transformer(kmer_length, prefix_length, description),
   _permutation(permutation.size() == kmer_length ? permutation : _generateRandomPermutation(kmer_length)),
-  _reverse_permutation(_computeReversePermutation(_permutation))
+  _reverse_permutation(_computeReversePermutation(_permutation)),
+  _random_permutation(permutation.size() != kmer_length),
+  _kind(_computeKind(_permutation)),
+  _rotation(_permutation[0]),
+  _kmer_mask((1ull << kmer_length << kmer_length) - 1ull),
+  _permutation_table(((_kind == GENERIC) && (kmer_length <= 32))
+                     ? _computePermutationTable(_permutation)
+                     : vector<uint64_t>()),
+  _reverse_permutation_table(((_kind == GENERIC) && (kmer_length <= 32))
+                             ? _computePermutationTable(_reverse_permutation)
+                             : vector<uint64_t>())
 {
   if (description.empty()) {
     string *desc_ptr = const_cast<string *>(&(this->description));
@@ -123,7 +134,65 @@ string PermutationTransformer::_applyPermutation(const string &s, const vector<s
   return permuted;
 }
 
+PermutationTransformer::Kind PermutationTransformer::_computeKind(const vector<size_t> &p) {
+  const size_t n = p.size();
+  bool reversal = true, rotation = true;
+  for (size_t i = 0; (reversal || rotation) && (i < n); ++i) {
+    reversal &= (p[i] == n - 1 - i);
+    rotation &= (p[i] == (i + p[0]) % n);
+  }
+  return (reversal ? REVERSAL : (rotation ? ROTATION : GENERIC));
+}
+
+vector<uint64_t> PermutationTransformer::_computePermutationTable(const vector<size_t> &p) {
+  // The nucleotide at position i of the permuted k-mer is the one at
+  // position p[i] of the original k-mer. The nucleotide at position i
+  // of a packed k-mer is stored at bits 2(k - 1 - i) and 2(k - 1 - i) + 1,
+  // thus the 4 nucleotides of the j-th byte are at positions k - 1 - 4j
+  // down to k - 4 - 4j.
+  const size_t k = p.size();
+  assert(k <= 32);
+  const size_t nb_bytes = (k + 3) >> 2;
+  vector<uint64_t> table(nb_bytes << 8, 0);
+  for (size_t i = 0; i < k; ++i) {
+    const size_t from = k - 1 - p[i];
+    const size_t to = k - 1 - i;
+    uint64_t *byte_table = &table[(from >> 2) << 8];
+    const size_t shift = (from & 3) << 1;
+    for (size_t b = 0; b < 256; ++b) {
+      byte_table[b] |= ((b >> shift) & 3ull) << (to << 1);
+    }
+  }
+  return table;
+}
+
+uint64_t PermutationTransformer::_applyPackedPermutation(uint64_t v, bool reverse) const {
+  assert(kmer_length <= 32);
+  switch (_kind) {
+  case REVERSAL:
+    return NucleotideKernel::reverse(v, kmer_length);
+  case ROTATION: {
+    const size_t r = (reverse && _rotation) ? (kmer_length - _rotation) : _rotation;
+    return r ? (((v << (r << 1)) | (v >> ((kmer_length - r) << 1))) & _kmer_mask) : v;
+  }
+  default:
+    break;
+  }
+  uint64_t permuted = 0;
+  const uint64_t *byte_table = (reverse ? _reverse_permutation_table : _permutation_table).data();
+  while (v) {
+    permuted |= byte_table[v & 0xFF];
+    v >>= 8;
+    byte_table += 256;
+  }
+  return permuted;
+}
+
 Transformer::EncodedKmer PermutationTransformer::operator()(const string &kmer) const {
+  assert(kmer.size() == kmer_length);
+  if (kmer_length <= 32) {
+    return (*this)(_encode(kmer.c_str(), kmer_length));
+  }
   EncodedKmer e;
   string permuted_kmer = _applyPermutation(kmer, _permutation);
   DEBUG_MSG("Permuted k-mer:   '" << permuted_kmer << "'" << '\n';
@@ -138,11 +207,47 @@ Transformer::EncodedKmer PermutationTransformer::operator()(const string &kmer)
   return e;
 }
 
+Transformer::EncodedKmer PermutationTransformer::operator()(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  EncodedKmer e;
+  const uint64_t v = _applyPackedPermutation(kmer, false);
+  DEBUG_MSG("Permuted k-mer:   " << v << '\n';
+            uint64_t unpermuted_kmer = _applyPackedPermutation(v, true);
+            cerr << MSG_DBG_HEADER << "Unpermuted k-mer: " << unpermuted_kmer << '\n';
+            if (unpermuted_kmer != kmer) {
+              throw Exception("Error: the unpermuted k-mer differs from the original k-mer.\n");
+            }
+            cerr);
+  e.prefix = v >> (suffix_length << 1);
+  e.suffix = v & ((1ull << (suffix_length << 1)) - 1);
+  return e;
+}
+
+void PermutationTransformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  _transformBatch(*this, packed, n, out);
+}
+
 string PermutationTransformer::operator()(const Transformer::EncodedKmer &e) const {
+  if (kmer_length <= 32) {
+    const uint64_t v = (e.prefix << (suffix_length << 1)) | e.suffix;
+    return _decode(_applyPackedPermutation(v, true), kmer_length);
+  }
   string permuted_kmer = _decode(e.prefix, prefix_length);
   permuted_kmer += _decode(e.suffix, suffix_length);
   string kmer = _applyPermutation(permuted_kmer, _reverse_permutation);
   return kmer;
 }
 
+string PermutationTransformer::getParameters() const {
+  if (!_random_permutation) {
+    return Transformer::getParameters();
+  }
+  string params;
+  for (size_t i = 0; i < kmer_length; ++i) {
+    if (i) params += ",";
+    params += to_string(_permutation[i]);
+  }
+  return params;
+}
+
 END_BIJECTHASH_NAMESPACE
@@ -45,6 +45,7 @@
 #define __PERMUTATION_TRANSFORMER_HPP__
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -71,6 +72,54 @@ namespace bijecthash {
      */
     const std::vector<size_t> _reverse_permutation;
 
+    /**
+     * Whether the permutation was randomly generated.
+     */
+    const bool _random_permutation;
+
+    /**
+     * The kinds of permutations having a dedicated packed
+     * implementation.
+     */
+    enum Kind {
+      GENERIC,  /**< Any permutation (applied using lookup tables). */
+      REVERSAL, /**< The nucleotides are reversed. */
+      ROTATION  /**< The nucleotides are (left) rotated. */
+    };
+
+    /**
+     * The kind of the permutation.
+     */
+    const Kind _kind;
+
+    /**
+     * The number of positions of the left rotation (only relevant for
+     * the ROTATION kind).
+     */
+    const size_t _rotation;
+
+    /**
+     * Precomputed binary mask for retrieving the whole (packed) k-mer.
+     */
+    const uint64_t _kmer_mask;
+
+    /**
+     * The byte-wise lookup table of the permutation on packed k-mers
+     * (only computed for the GENERIC kind when \f$k \leq 32\f$).
+     *
+     * For each byte \f$j\f$ of the packed k-mer (*i.e.*, 4 consecutive
+     * nucleotides) and each possible value \f$b\f$ of this byte, the
+     * entry at \f$256j+b\f$ is the packed value where the nucleotides
+     * of \f$b\f$ are scattered at their permuted positions.
+     */
+    const std::vector<uint64_t> _permutation_table;
+
+    /**
+     * The byte-wise lookup table of the reverse permutation on packed
+     * k-mers.
+     */
+    const std::vector<uint64_t> _reverse_permutation_table;
+
     /**
      * This method generates a random permutation of the range [0; k[.
      *
@@ -100,6 +149,40 @@ namespace bijecthash {
      */
     static std::string _applyPermutation(const std::string &s, const std::vector<size_t> &p);
 
+    /**
+     * This method computes the kind of the given permutation.
+     *
+     * \param p Some permutation of the range [0; |p|[
+     *
+     * \return Returns REVERSAL if p[i] = |p| - 1 - i, ROTATION if
+     * p[i] = (i + p[0]) % |p| and GENERIC otherwise.
+     */
+    static Kind _computeKind(const std::vector<size_t> &p);
+
+    /**
+     * This method computes the byte-wise lookup table of the given
+     * permutation on packed k-mers.
+     *
+     * \param p Some permutation of the range [0; k[ with k at most
+     * 32.
+     *
+     * \return Returns the \f$256\lceil k/4\rceil\f$ entries lookup
+     * table of the given permutation.
+     */
+    static std::vector<uint64_t> _computePermutationTable(const std::vector<size_t> &p);
+
+    /**
+     * This applies the permutation (or its reverse) to the given
+     * packed k-mer (the k-mer length must be at most 32).
+     *
+     * \param v The packed k-mer to permute.
+     *
+     * \param reverse When true, the reverse permutation is applied.
+     *
+     * \return Returns the packed permuted k-mer.
+     */
+    uint64_t _applyPackedPermutation(uint64_t v, bool reverse) const;
+
   public:
 
     /**
@@ -131,6 +214,27 @@ namespace bijecthash {
      */
     virtual EncodedKmer operator()(const std::string &kmer) const override;
 
+    /**
+     * Encode some given packed k-mer into a prefix/suffix code.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    virtual EncodedKmer operator()(uint64_t kmer) const override;
+
+    /**
+     * Encode some given batch of packed k-mers into prefix/suffix
+     * codes (see Transformer::transformBatch()).
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    virtual void transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const override;
+
     /**
      * Decode some given encoded k-mer.
      *
@@ -142,6 +246,16 @@ namespace bijecthash {
      */
     virtual std::string operator()(const EncodedKmer &e) const override;
 
+    /**
+     * Get the arguments allowing to build a transformer identical to
+     * this one.
+     *
+     * \return Returns the comma separated permutation if it was
+     * randomly generated and the arguments given at construction
+     * otherwise.
+     */
+    virtual std::string getParameters() const override;
+
   };
 
 }
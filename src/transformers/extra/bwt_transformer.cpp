@@ -46,34 +46,59 @@
 #include "common.hpp"
 
 #include <algorithm>
-#include <vector>
+#include <cstdint>
 
 using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
 BwtTransformer::BwtTransformer(size_t kmer_length, size_t prefix_length):
-  Transformer(kmer_length, prefix_length, "Bwt") {
-  assert(suffix_length <= 30);
+  Transformer(kmer_length, prefix_length, "Bwt"),
+  _kmer_mask((1ull << kmer_length << kmer_length) - 1ull),
+  _suffix_mask((1ull << (2 * suffix_length)) - 1)
+{
+  // The BWT row of the k-mer is stored on the 6 highest bits of the
+  // suffix code.
+  assert(suffix_length <= 29);
 }
 
 Transformer::EncodedKmer BwtTransformer::operator()(const string& kmer) const {
+  assert(kmer.length() == kmer_length);
+  if (kmer_length <= 32) {
+    return (*this)(_encode(kmer.c_str(), kmer_length));
+  }
   EncodedKmer encoded;
-  int n = kmer.length();
-  size_t bwt_pos =0;
-  int pos = n - 1;
-  vector<string> rotations(n);
-
-  for (int i = 0; i < n; ++i) {
-    int shift = (i + pos) % n;
-    rotations[i] = kmer.substr(shift) + kmer.substr(0, shift);
+  const size_t n = kmer_length;
+  const char *s = kmer.c_str();
+
+  // Sort the rotations (given by their starting positions) without
+  // materializing them.
+  assert(n <= 64);
+  uint8_t rotations[64];
+  for (size_t i = 0; i < n; ++i) {
+    rotations[i] = i;
   }
-
-  sort(rotations.begin(), rotations.end());
-  string result;
-  for (int i = 0; i < n; ++i) {
-    result += rotations[i][n - 1];
-    if (rotations[i] == kmer) {
+  sort(rotations, rotations + n,
+       [s, n](size_t a, size_t b) {
+         for (size_t j = 0; j < n; ++j) {
+           const char c_a = s[(a + j) % n];
+           const char c_b = s[(b + j) % n];
+           if (c_a != c_b) {
+             return c_a < c_b;
+           }
+         }
+         return false;
+       });
+
+  // The BWT is made of the last symbols of the sorted rotations, and
+  // bwt_pos is the last row of the k-mer itself (the k-mer is
+  // repeated on several consecutive rows when it is periodic).
+  char result[64];
+  size_t bwt_pos = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const size_t r = rotations[i];
+    result[i] = s[(r + n - 1) % n];
+    if ((r == 0) || (!kmer.compare(r, n - r, s, n - r) && !kmer.compare(0, r, s + n - r, r))) {
       bwt_pos = i;
     }
   }
@@ -82,25 +107,81 @@ Transformer::EncodedKmer BwtTransformer::operator()(const string& kmer) const {
 
   assert(bwt_pos < 64); // BWT_pos can be encoded in only 6 bits
 
-
-  encoded.prefix = _encode(result.c_str(), prefix_length);
-  encoded.suffix = _encode(result.c_str() + prefix_length, suffix_length);
+  encoded.prefix = _encode(result, prefix_length);
+  encoded.suffix = _encode(result + prefix_length, suffix_length);
   encoded.suffix |= bwt_pos << 58;
 
   return encoded;
 }
 
+Transformer::EncodedKmer BwtTransformer::operator()(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  const size_t n = kmer_length;
 
-string BwtTransformer::operator()(const Transformer::EncodedKmer& e) const {
-  size_t bwt_pos = (e.suffix >> 58);
+  // Since A < C < G < T, the lexicographic order of the rotations is
+  // the numeric order of their 2 bits encoding.
+  uint64_t rotations[32];
+  rotations[0] = kmer;
+  for (size_t i = 1; i < n; ++i) {
+    rotations[i] = ((kmer << (2 * i)) | (kmer >> (2 * (n - i)))) & _kmer_mask;
+  }
+  sort(rotations, rotations + n);
+
+  // The BWT is made of the last symbols of the sorted rotations, and
+  // bwt_pos is the last row of the k-mer itself (the k-mer is
+  // repeated on several consecutive rows when it is periodic).
+  uint64_t bwt = 0;
+  size_t bwt_pos = 0;
+  for (size_t i = 0; i < n; ++i) {
+    bwt = (bwt << 2) | (rotations[i] & 3);
+    if (rotations[i] == kmer) {
+      bwt_pos = i;
+    }
+  }
 
-  string prefix = _decode(e.prefix, prefix_length);
-  string suffix = _decode(e.suffix, suffix_length);
-  string bwt_rotation = prefix + suffix;
+  DEBUG_MSG("kmer: " << kmer << " BWT rotation index: '" << bwt_pos << "'");
 
-  string bwt = bwt_rotation.substr(bwt_rotation.size() - bwt_pos) + bwt_rotation.substr(0, bwt_rotation.size() - bwt_pos);
+  EncodedKmer encoded;
+  encoded.prefix = bwt >> (2 * suffix_length);
+  encoded.suffix = (bwt & _suffix_mask) | (uint64_t(bwt_pos) << 58);
+  return encoded;
+}
 
-  return bwt;
+void BwtTransformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  _transformBatch(*this, packed, n, out);
+}
+
+string BwtTransformer::operator()(const Transformer::EncodedKmer& e) const {
+  size_t bwt_pos = (e.suffix >> 58);
+  const size_t n = kmer_length;
+  assert(bwt_pos < n);
+
+  const string bwt = _decode(e.prefix, prefix_length) + _decode(e.suffix, suffix_length);
+
+  // Inverse BWT using the LF mapping: the rows of the sorted rotations
+  // ending with a given symbol are in the same order than the rows
+  // starting with this symbol. Row bwt_pos is the k-mer itself, hence
+  // the symbols are retrieved from the last one to the first one.
+  size_t first_row[256] = { 0 };
+  uint8_t rank[64];
+  for (size_t i = 0; i < n; ++i) {
+    rank[i] = first_row[uint8_t(bwt[i])]++;
+  }
+  size_t nb_rows = 0;
+  for (const char c: { 'A', 'C', 'G', 'T' }) {
+    const size_t nb = first_row[uint8_t(c)];
+    first_row[uint8_t(c)] = nb_rows;
+    nb_rows += nb;
+  }
+  assert(nb_rows == n);
+
+  string kmer(n, '\0');
+  size_t row = bwt_pos;
+  for (size_t i = n; i--;) {
+    kmer[i] = bwt[row];
+    row = first_row[uint8_t(bwt[row])] + rank[row];
+  }
+  return kmer;
 }
 
 END_BIJECTHASH_NAMESPACE
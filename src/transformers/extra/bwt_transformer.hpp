@@ -45,6 +45,7 @@
 #define __BWT_TRANSFORMER_HPP__
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <transformer.hpp>
@@ -56,6 +57,18 @@ namespace bijecthash {
    */
   class BwtTransformer : public Transformer {
 
+  private:
+
+    /**
+     * Precomputed binary mask for retrieving the whole (packed) k-mer.
+     */
+    const uint64_t _kmer_mask;
+
+    /**
+     * Precomputed binary mask for retrieving the suffix.
+     */
+    const uint64_t _suffix_mask;
+
   public:
 
     /**
@@ -80,7 +93,32 @@ namespace bijecthash {
     virtual EncodedKmer operator()(const std::string &kmer) const override;
 
     /**
-     * Decodes a given encoded k-mer back to its original string representation.
+     * Encodes a given packed k-mer into a prefix/suffix code using a
+     * bwt.
+     *
+     * The rotations are computed and sorted as packed words.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    virtual EncodedKmer operator()(uint64_t kmer) const override;
+
+    /**
+     * Encode some given batch of packed k-mers into prefix/suffix
+     * codes (see Transformer::transformBatch()).
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    virtual void transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const override;
+
+    /**
+     * Decodes a given encoded k-mer back to its original string
+     * representation (using the inverse bwt).
      *
      * Each derived class must overload this operator.
      *
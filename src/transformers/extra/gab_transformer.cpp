@@ -44,7 +44,9 @@
 #include "gab_transformer.hpp"
 
 #include "common.hpp"
+#include "hash_kernel.hpp"
 
+#include <algorithm>
 #ifdef DEBUG
 #  include <bitset>
 #endif
@@ -172,22 +174,60 @@ Transformer::EncodedKmer GaBTransformer::operator()(const std::string &kmer) con
     e.prefix = v >> _prefix_shift;
     e.suffix = v & _suffix_mask;
   } else {
+    // Only the first 32 nucleotides are hashed. The transformed k-mer
+    // is the hashed word followed by the last nucleotides, thus the
+    // suffix starts with the end of the hashed word (if the prefix is
+    // shorter than 32 nucleotides).
+    const size_t n = kmer_length - 32;
     uint64_t prefix = _encode(kmer.c_str(), 32);
-    uint64_t suffix = _encode(kmer.c_str() + 32, kmer_length - 32);
+    uint64_t suffix = _encode(kmer.c_str() + 32, n);
     uint64_t prefix_transformed = _G(prefix);
     e.prefix = prefix_transformed >> _prefix_shift;
-    e.suffix = prefix_transformed << (prefix_length << 1) | suffix;
+    e.suffix = ((n < 32) ? ((prefix_transformed & ((1ull << _prefix_shift) - 1)) << (n << 1)) : 0) | suffix;
   }
   return e;
 }
 
+Transformer::EncodedKmer GaBTransformer::operator()(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  EncodedKmer e;
+  const uint64_t v = _G(kmer);
+  e.prefix = v >> _prefix_shift;
+  e.suffix = v & _suffix_mask;
+  return e;
+}
+
+void GaBTransformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  assert(kmer_length <= 32);
+  uint64_t chunk[256];
+  for (size_t first = 0; first < n; first += 256) {
+    const size_t m = min<size_t>(n - first, 256);
+    HashKernel::gab(packed + first, m, chunk, _a, _b, _rotation_offset, _kmer_mask);
+#ifdef DEBUG
+    uint64_t rev_chunk[256];
+    HashKernel::gabInverse(chunk, m, rev_chunk, _rev_a, _b, _rotation_offset, _kmer_mask);
+    assert(equal(rev_chunk, rev_chunk + m, packed + first));
+#endif
+    for (size_t i = 0; i < m; ++i) {
+      out[first + i].prefix = chunk[i] >> _prefix_shift;
+      out[first + i].suffix = chunk[i] & _suffix_mask;
+    }
+  }
+}
+
+uint64_t GaBTransformer::transformPacked(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  return _G(kmer);
+}
+
 std::string GaBTransformer::operator()(const Transformer::EncodedKmer &e) const {
   if (kmer_length <= 32) {
     uint64_t v = (e.prefix << _prefix_shift) | e.suffix;
     v = _G_rev(v);
     return _decode(v, kmer_length);
   } else {
-    uint64_t u = (e.prefix << _prefix_shift) | (e.suffix >> (prefix_length << 1));
+    const size_t n = kmer_length - 32;
+    uint64_t u = (e.prefix << _prefix_shift) | ((n < 32) ? (e.suffix >> (n << 1)) : 0);
     u = _G_rev(u);
     uint64_t v = e.suffix & _suffix_mask;
     return _decode(u, 32) + _decode(v, kmer_length - 32);
@@ -199,10 +239,19 @@ std::string GaBTransformer::getTransformedKmer(const Transformer::EncodedKmer &e
     uint64_t v = (e.prefix << _prefix_shift) | e.suffix;
     return _decode(v, kmer_length);
   } else {
-    uint64_t u = (e.prefix << _prefix_shift) | (e.suffix >> (prefix_length << 1));
+    const size_t n = kmer_length - 32;
+    uint64_t u = (e.prefix << _prefix_shift) | ((n < 32) ? (e.suffix >> (n << 1)) : 0);
     uint64_t v = e.suffix & _suffix_mask;
     return _decode(u, 32) + _decode(v, kmer_length - 32);
   }
 }
 
+string GaBTransformer::getParameters() const {
+  return to_string(_a) + "," + to_string(_b);
+}
+
+Transformer::Kernel GaBTransformer::getKernel() const {
+  return Kernel { Kernel::GAB, _a, _b };
+}
+
 END_BIJECTHASH_NAMESPACE
@@ -0,0 +1,639 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifndef HASH_KERNEL_HPP
+#define HASH_KERNEL_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "inthash.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#  define HASH_KERNEL_X86
+#  include <immintrin.h>
+#endif
+
+namespace bijecthash {
+
+  /**
+   * Batch evaluation of the bijective integer hash functions of the
+   * GaB and IntHash transformers (and of their inverses).
+   *
+   * Both functions are pure integer mixers (shifts, rotations, xors,
+   * additions and multiplications of 64 bits words), thus they are
+   * evaluated on 4 (resp. 8) words at once when the processor
+   * supports AVX2 (resp. AVX-512F and AVX-512DQ) instructions. Since
+   * AVX2 has no 64 bits multiplication, the products are computed
+   * from three 32 bits multiplications. The implementation is chosen
+   * at runtime (see bestLevel()), but any supported level can be
+   * explicitly required (which is useful for testing and
+   * benchmarking).
+   *
+   * Each batch function stores the hash value of the i-th input word
+   * at index i of the output array, which may be the input array
+   * itself.
+   */
+  class HashKernel {
+
+  public:
+
+    /**
+     * The available implementations (ordered by increasing
+     * requirements).
+     */
+    enum Level {
+      SCALAR, /**< Portable implementation */
+      AVX2,   /**< 4 words at once */
+      AVX512  /**< 8 words at once */
+    };
+
+  private:
+
+    /**
+     * The inverse of 21 modulo \f$2^{64}\f$ (see hash_64i()).
+     */
+    static constexpr uint64_t _inverse_21 = 14933078535860113213ull;
+
+    /**
+     * The inverse of 265 modulo \f$2^{64}\f$ (see hash_64i()).
+     */
+    static constexpr uint64_t _inverse_265 = 15244667743933553977ull;
+
+    /**
+     * Compute the GaB hash value of some word.
+     *
+     * \param s The word to hash.
+     *
+     * \param a The odd multiplicative coefficient.
+     *
+     * \param b The xor-ed value.
+     *
+     * \param rotation The rotation offset (half the number of bits of
+     * the hashed values).
+     *
+     * \param mask The mask of the bits of the hashed values.
+     *
+     * \return Returns \f$(a \times (rot(s) \oplus b)) \wedge mask\f$.
+     */
+    static inline uint64_t _gab(uint64_t s, uint64_t a, uint64_t b, size_t rotation, uint64_t mask) {
+      return (a * ((((s << rotation) | (s >> rotation)) & mask) ^ b)) & mask;
+    }
+
+    /**
+     * Compute the inverse of the GaB hash function on some word.
+     *
+     * \param s The word to unhash.
+     *
+     * \param rev_a The multiplicative inverse of the coefficient
+     * (modulo \f$mask + 1\f$).
+     *
+     * \param b The xor-ed value.
+     *
+     * \param rotation The rotation offset.
+     *
+     * \param mask The mask of the bits of the hashed values.
+     *
+     * \return Returns \f$rot(((rev\_a \times s) \wedge mask) \oplus
+     * b)\f$.
+     */
+    static inline uint64_t _gabInverse(uint64_t s, uint64_t rev_a, uint64_t b, size_t rotation, uint64_t mask) {
+      s = ((rev_a * s) & mask) ^ b;
+      return ((s << rotation) | (s >> rotation)) & mask;
+    }
+
+#ifdef HASH_KERNEL_X86
+
+    /**
+     * Multiply 4 words by some constant (AVX2 version).
+     *
+     * \param v The words to multiply.
+     *
+     * \param c The broadcast constant.
+     *
+     * \param c_hi The broadcast 32 most significant bits of the
+     * constant.
+     *
+     * \return Returns the 64 least significant bits of the products.
+     */
+    __attribute__((target("avx2")))
+    static inline __m256i _mul64AVX2(__m256i v, __m256i c, __m256i c_hi) {
+      const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(v, 32), c),
+                                             _mm256_mul_epu32(v, c_hi));
+      return _mm256_add_epi64(_mm256_mul_epu32(v, c), _mm256_slli_epi64(cross, 32));
+    }
+
+    /**
+     * Compute the GaB hash values of 4 words at once (AVX2 version).
+     *
+     * See _gab() for the hash parameters.
+     *
+     * \param in The input words.
+     *
+     * \param n The number of input words.
+     *
+     * \param out The output words.
+     *
+     * \return Returns the number of processed words (the greatest
+     * multiple of 4 not greater than n).
+     */
+    __attribute__((target("avx2")))
+    static inline size_t _gabAVX2(const uint64_t *in, size_t n, uint64_t *out,
+                                  uint64_t a, uint64_t b, size_t rotation, uint64_t mask) {
+      const __m128i r = _mm_cvtsi64_si128(rotation);
+      const __m256i va = _mm256_set1_epi64x(a), va_hi = _mm256_set1_epi64x(a >> 32);
+      const __m256i vb = _mm256_set1_epi64x(b), vmask = _mm256_set1_epi64x(mask);
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        v = _mm256_and_si256(_mm256_or_si256(_mm256_sll_epi64(v, r), _mm256_srl_epi64(v, r)), vmask);
+        v = _mm256_and_si256(_mul64AVX2(_mm256_xor_si256(v, vb), va, va_hi), vmask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), v);
+      }
+      return i;
+    }
+
+    /**
+     * Compute the inverse GaB hash values of 4 words at once (AVX2
+     * version).
+     *
+     * See _gabInverse() for the hash parameters.
+     *
+     * \param in The input words.
+     *
+     * \param n The number of input words.
+     *
+     * \param out The output words.
+     *
+     * \return Returns the number of processed words (the greatest
+     * multiple of 4 not greater than n).
+     */
+    __attribute__((target("avx2")))
+    static inline size_t _gabInverseAVX2(const uint64_t *in, size_t n, uint64_t *out,
+                                         uint64_t rev_a, uint64_t b, size_t rotation, uint64_t mask) {
+      const __m128i r = _mm_cvtsi64_si128(rotation);
+      const __m256i va = _mm256_set1_epi64x(rev_a), va_hi = _mm256_set1_epi64x(rev_a >> 32);
+      const __m256i vb = _mm256_set1_epi64x(b), vmask = _mm256_set1_epi64x(mask);
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        v = _mm256_xor_si256(_mm256_and_si256(_mul64AVX2(v, va, va_hi), vmask), vb);
+        v = _mm256_and_si256(_mm256_or_si256(_mm256_sll_epi64(v, r), _mm256_srl_epi64(v, r)), vmask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), v);
+      }
+      return i;
+    }
+
+    /**
+     * Compute the IntHash values of 4 words at once (AVX2 version).
+     *
+     * See hash_64() for the hash parameters.
+     *
+     * \param in The input words.
+     *
+     * \param n The number of input words.
+     *
+     * \param out The output words.
+     *
+     * \return Returns the number of processed words (the greatest
+     * multiple of 4 not greater than n).
+     */
+    __attribute__((target("avx2")))
+    static inline size_t _intHashAVX2(const uint64_t *in, size_t n, uint64_t *out, uint64_t mask) {
+      const __m256i vmask = _mm256_set1_epi64x(mask), ones = _mm256_set1_epi64x(-1);
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        key = _mm256_and_si256(_mm256_add_epi64(_mm256_xor_si256(key, ones), _mm256_slli_epi64(key, 21)), vmask);
+        key = _mm256_xor_si256(key, _mm256_srli_epi64(key, 24));
+        key = _mm256_and_si256(_mm256_add_epi64(_mm256_add_epi64(key, _mm256_slli_epi64(key, 3)),
+                                                _mm256_slli_epi64(key, 8)), vmask);
+        key = _mm256_xor_si256(key, _mm256_srli_epi64(key, 14));
+        key = _mm256_and_si256(_mm256_add_epi64(_mm256_add_epi64(key, _mm256_slli_epi64(key, 2)),
+                                                _mm256_slli_epi64(key, 4)), vmask);
+        key = _mm256_xor_si256(key, _mm256_srli_epi64(key, 28));
+        key = _mm256_and_si256(_mm256_add_epi64(key, _mm256_slli_epi64(key, 31)), vmask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), key);
+      }
+      return i;
+    }
+
+    /**
+     * Compute the inverse IntHash values of 4 words at once (AVX2
+     * version).
+     *
+     * See hash_64i() for the hash parameters.
+     *
+     * \param in The input words.
+     *
+     * \param n The number of input words.
+     *
+     * \param out The output words.
+     *
+     * \return Returns the number of processed words (the greatest
+     * multiple of 4 not greater than n).
+     */
+    __attribute__((target("avx2")))
+    static inline size_t _intHashInverseAVX2(const uint64_t *in, size_t n, uint64_t *out, uint64_t mask) {
+      const __m256i vmask = _mm256_set1_epi64x(mask), ones = _mm256_set1_epi64x(-1);
+      const __m256i inv21 = _mm256_set1_epi64x(_inverse_21), inv21_hi = _mm256_set1_epi64x(_inverse_21 >> 32);
+      const __m256i inv265 = _mm256_set1_epi64x(_inverse_265), inv265_hi = _mm256_set1_epi64x(_inverse_265 >> 32);
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        __m256i tmp = _mm256_sub_epi64(key, _mm256_slli_epi64(key, 31));
+        key = _mm256_and_si256(_mm256_sub_epi64(key, _mm256_slli_epi64(tmp, 31)), vmask);
+        tmp = _mm256_xor_si256(key, _mm256_srli_epi64(key, 28));
+        key = _mm256_xor_si256(key, _mm256_srli_epi64(tmp, 28));
+        key = _mm256_and_si256(_mul64AVX2(key, inv21, inv21_hi), vmask);
+        tmp = _mm256_xor_si256(key, _mm256_srli_epi64(key, 14));
+        tmp = _mm256_xor_si256(key, _mm256_srli_epi64(tmp, 14));
+        tmp = _mm256_xor_si256(key, _mm256_srli_epi64(tmp, 14));
+        key = _mm256_xor_si256(key, _mm256_srli_epi64(tmp, 14));
+        key = _mm256_and_si256(_mul64AVX2(key, inv265, inv265_hi), vmask);
+        tmp = _mm256_xor_si256(key, _mm256_srli_epi64(key, 24));
+        key = _mm256_xor_si256(key, _mm256_srli_epi64(tmp, 24));
+        tmp = _mm256_xor_si256(key, ones);
+        tmp = _mm256_xor_si256(_mm256_sub_epi64(key, _mm256_slli_epi64(tmp, 21)), ones);
+        tmp = _mm256_xor_si256(_mm256_sub_epi64(key, _mm256_slli_epi64(tmp, 21)), ones);
+        key = _mm256_andnot_si256(_mm256_sub_epi64(key, _mm256_slli_epi64(tmp, 21)), vmask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), key);
+      }
+      return i;
+    }
+
+    // Some GCC versions wrongly warn about the undefined pass-through
+    // operands of the AVX-512 intrinsics.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+    /**
+     * Compute the GaB hash values of 8 words at once (AVX-512
+     * version).
+     *
+     * See _gab() for the hash parameters.
+     *
+     * \param in The input words.
+     *
+     * \param n The number of input words.
+     *
+     * \param out The output words.
+     *
+     * \return Returns the number of processed words (the greatest
+     * multiple of 8 not greater than n).
+     */
+    __attribute__((target("avx512f,avx512dq")))
+    static inline size_t _gabAVX512(const uint64_t *in, size_t n, uint64_t *out,
+                                    uint64_t a, uint64_t b, size_t rotation, uint64_t mask) {
+      const __m128i r = _mm_cvtsi64_si128(rotation);
+      const __m512i va = _mm512_set1_epi64(a), vb = _mm512_set1_epi64(b), vmask = _mm512_set1_epi64(mask);
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m512i v = _mm512_loadu_si512(in + i);
+        v = _mm512_and_si512(_mm512_or_si512(_mm512_sll_epi64(v, r), _mm512_srl_epi64(v, r)), vmask);
+        v = _mm512_and_si512(_mm512_mullo_epi64(_mm512_xor_si512(v, vb), va), vmask);
+        _mm512_storeu_si512(out + i, v);
+      }
+      return i;
+    }
+
+    /**
+     * Compute the inverse GaB hash values of 8 words at once (AVX-512
+     * version).
+     *
+     * See _gabInverse() for the hash parameters.
+     *
+     * \param in The input words.
+     *
+     * \param n The number of input words.
+     *
+     * \param out The output words.
+     *
+     * \return Returns the number of processed words (the greatest
+     * multiple of 8 not greater than n).
+     */
+    __attribute__((target("avx512f,avx512dq")))
+    static inline size_t _gabInverseAVX512(const uint64_t *in, size_t n, uint64_t *out,
+                                           uint64_t rev_a, uint64_t b, size_t rotation, uint64_t mask) {
+      const __m128i r = _mm_cvtsi64_si128(rotation);
+      const __m512i va = _mm512_set1_epi64(rev_a), vb = _mm512_set1_epi64(b), vmask = _mm512_set1_epi64(mask);
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m512i v = _mm512_loadu_si512(in + i);
+        v = _mm512_xor_si512(_mm512_and_si512(_mm512_mullo_epi64(v, va), vmask), vb);
+        v = _mm512_and_si512(_mm512_or_si512(_mm512_sll_epi64(v, r), _mm512_srl_epi64(v, r)), vmask);
+        _mm512_storeu_si512(out + i, v);
+      }
+      return i;
+    }
+
+    /**
+     * Compute the IntHash values of 8 words at once (AVX-512
+     * version).
+     *
+     * See hash_64() for the hash parameters.
+     *
+     * \param in The input words.
+     *
+     * \param n The number of input words.
+     *
+     * \param out The output words.
+     *
+     * \return Returns the number of processed words (the greatest
+     * multiple of 8 not greater than n).
+     */
+    __attribute__((target("avx512f,avx512dq")))
+    static inline size_t _intHashAVX512(const uint64_t *in, size_t n, uint64_t *out, uint64_t mask) {
+      const __m512i vmask = _mm512_set1_epi64(mask), ones = _mm512_set1_epi64(-1);
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m512i key = _mm512_loadu_si512(in + i);
+        key = _mm512_and_si512(_mm512_add_epi64(_mm512_xor_si512(key, ones), _mm512_slli_epi64(key, 21)), vmask);
+        key = _mm512_xor_si512(key, _mm512_srli_epi64(key, 24));
+        key = _mm512_and_si512(_mm512_add_epi64(_mm512_add_epi64(key, _mm512_slli_epi64(key, 3)),
+                                                _mm512_slli_epi64(key, 8)), vmask);
+        key = _mm512_xor_si512(key, _mm512_srli_epi64(key, 14));
+        key = _mm512_and_si512(_mm512_add_epi64(_mm512_add_epi64(key, _mm512_slli_epi64(key, 2)),
+                                                _mm512_slli_epi64(key, 4)), vmask);
+        key = _mm512_xor_si512(key, _mm512_srli_epi64(key, 28));
+        key = _mm512_and_si512(_mm512_add_epi64(key, _mm512_slli_epi64(key, 31)), vmask);
+        _mm512_storeu_si512(out + i, key);
+      }
+      return i;
+    }
+
+    /**
+     * Compute the inverse IntHash values of 8 words at once (AVX-512
+     * version).
+     *
+     * See hash_64i() for the hash parameters.
+     *
+     * \param in The input words.
+     *
+     * \param n The number of input words.
+     *
+     * \param out The output words.
+     *
+     * \return Returns the number of processed words (the greatest
+     * multiple of 8 not greater than n).
+     */
+    __attribute__((target("avx512f,avx512dq")))
+    static inline size_t _intHashInverseAVX512(const uint64_t *in, size_t n, uint64_t *out, uint64_t mask) {
+      const __m512i vmask = _mm512_set1_epi64(mask), ones = _mm512_set1_epi64(-1);
+      const __m512i inv21 = _mm512_set1_epi64(_inverse_21), inv265 = _mm512_set1_epi64(_inverse_265);
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m512i key = _mm512_loadu_si512(in + i);
+        __m512i tmp = _mm512_sub_epi64(key, _mm512_slli_epi64(key, 31));
+        key = _mm512_and_si512(_mm512_sub_epi64(key, _mm512_slli_epi64(tmp, 31)), vmask);
+        tmp = _mm512_xor_si512(key, _mm512_srli_epi64(key, 28));
+        key = _mm512_xor_si512(key, _mm512_srli_epi64(tmp, 28));
+        key = _mm512_and_si512(_mm512_mullo_epi64(key, inv21), vmask);
+        tmp = _mm512_xor_si512(key, _mm512_srli_epi64(key, 14));
+        tmp = _mm512_xor_si512(key, _mm512_srli_epi64(tmp, 14));
+        tmp = _mm512_xor_si512(key, _mm512_srli_epi64(tmp, 14));
+        key = _mm512_xor_si512(key, _mm512_srli_epi64(tmp, 14));
+        key = _mm512_and_si512(_mm512_mullo_epi64(key, inv265), vmask);
+        tmp = _mm512_xor_si512(key, _mm512_srli_epi64(key, 24));
+        key = _mm512_xor_si512(key, _mm512_srli_epi64(tmp, 24));
+        tmp = _mm512_xor_si512(key, ones);
+        tmp = _mm512_xor_si512(_mm512_sub_epi64(key, _mm512_slli_epi64(tmp, 21)), ones);
+        tmp = _mm512_xor_si512(_mm512_sub_epi64(key, _mm512_slli_epi64(tmp, 21)), ones);
+        key = _mm512_andnot_si512(_mm512_sub_epi64(key, _mm512_slli_epi64(tmp, 21)), vmask);
+        _mm512_storeu_si512(out + i, key);
+      }
+      return i;
+    }
+
+#pragma GCC diagnostic pop
+
+#endif
+
+    /**
+     * Detect the best implementation supported by the running
+     * processor.
+     *
+     * \return Returns the best available implementation level.
+     */
+    static inline Level _detectLevel() {
+#ifdef HASH_KERNEL_X86
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return AVX512;
+      }
+      if (__builtin_cpu_supports("avx2")) {
+        return AVX2;
+      }
+#endif
+      return SCALAR;
+    }
+
+  public:
+
+    /**
+     * Get the best implementation supported by the running processor.
+     *
+     * \return Returns the best available implementation level.
+     */
+    static inline Level bestLevel() {
+      static const Level level = _detectLevel();
+      return level;
+    }
+
+    /**
+     * Get the name of the given implementation level.
+     *
+     * \param level The implementation level.
+     *
+     * \return Returns the name of the given implementation level.
+     */
+    static inline const char *level2string(Level level) {
+      switch (level) {
+      case SCALAR: return "scalar";
+      case AVX2: return "AVX2";
+      case AVX512: return "AVX-512";
+      }
+      return "";
+    }
+
+    /**
+     * Compute the GaB hash values of some words.
+     *
+     * \param in The words to hash.
+     *
+     * \param n The number of words to hash.
+     *
+     * \param out The array of (at least n) hash values to fill.
+     *
+     * \param a The odd multiplicative coefficient.
+     *
+     * \param b The xor-ed value.
+     *
+     * \param rotation The rotation offset (half the number of bits of
+     * the hashed values, thus at most 32).
+     *
+     * \param mask The mask of the bits of the hashed values.
+     *
+     * \param level The implementation to use.
+     */
+    static inline void gab(const uint64_t *in, size_t n, uint64_t *out,
+                           uint64_t a, uint64_t b, size_t rotation, uint64_t mask,
+                           Level level = bestLevel()) {
+      assert(level <= bestLevel());
+      assert(rotation <= 32);
+      size_t i = 0;
+#ifdef HASH_KERNEL_X86
+      switch (level) {
+      case AVX512: i = _gabAVX512(in, n, out, a, b, rotation, mask); break;
+      case AVX2: i = _gabAVX2(in, n, out, a, b, rotation, mask); break;
+      default: break;
+      }
+#endif
+      for (; i < n; ++i) {
+        out[i] = _gab(in[i], a, b, rotation, mask);
+      }
+    }
+
+    /**
+     * Compute the inverse GaB hash values of some words.
+     *
+     * \param in The words to unhash.
+     *
+     * \param n The number of words to unhash.
+     *
+     * \param out The array of (at least n) values to fill.
+     *
+     * \param rev_a The multiplicative inverse of the coefficient
+     * (modulo \f$mask + 1\f$).
+     *
+     * \param b The xor-ed value.
+     *
+     * \param rotation The rotation offset (at most 32).
+     *
+     * \param mask The mask of the bits of the hashed values.
+     *
+     * \param level The implementation to use.
+     */
+    static inline void gabInverse(const uint64_t *in, size_t n, uint64_t *out,
+                                  uint64_t rev_a, uint64_t b, size_t rotation, uint64_t mask,
+                                  Level level = bestLevel()) {
+      assert(level <= bestLevel());
+      assert(rotation <= 32);
+      size_t i = 0;
+#ifdef HASH_KERNEL_X86
+      switch (level) {
+      case AVX512: i = _gabInverseAVX512(in, n, out, rev_a, b, rotation, mask); break;
+      case AVX2: i = _gabInverseAVX2(in, n, out, rev_a, b, rotation, mask); break;
+      default: break;
+      }
+#endif
+      for (; i < n; ++i) {
+        out[i] = _gabInverse(in[i], rev_a, b, rotation, mask);
+      }
+    }
+
+    /**
+     * Compute the IntHash values of some words (see hash_64()).
+     *
+     * \param in The words to hash.
+     *
+     * \param n The number of words to hash.
+     *
+     * \param out The array of (at least n) hash values to fill.
+     *
+     * \param mask The mask of the bits of the hashed values.
+     *
+     * \param level The implementation to use.
+     */
+    static inline void intHash(const uint64_t *in, size_t n, uint64_t *out, uint64_t mask,
+                               Level level = bestLevel()) {
+      assert(level <= bestLevel());
+      size_t i = 0;
+#ifdef HASH_KERNEL_X86
+      switch (level) {
+      case AVX512: i = _intHashAVX512(in, n, out, mask); break;
+      case AVX2: i = _intHashAVX2(in, n, out, mask); break;
+      default: break;
+      }
+#endif
+      for (; i < n; ++i) {
+        out[i] = hash_64(in[i], mask);
+      }
+    }
+
+    /**
+     * Compute the inverse IntHash values of some words (see
+     * hash_64i()).
+     *
+     * \param in The words to unhash.
+     *
+     * \param n The number of words to unhash.
+     *
+     * \param out The array of (at least n) values to fill.
+     *
+     * \param mask The mask of the bits of the hashed values.
+     *
+     * \param level The implementation to use.
+     */
+    static inline void intHashInverse(const uint64_t *in, size_t n, uint64_t *out, uint64_t mask,
+                                      Level level = bestLevel()) {
+      assert(level <= bestLevel());
+      size_t i = 0;
+#ifdef HASH_KERNEL_X86
+      switch (level) {
+      case AVX512: i = _intHashInverseAVX512(in, n, out, mask); break;
+      case AVX2: i = _intHashInverseAVX2(in, n, out, mask); break;
+      default: break;
+      }
+#endif
+      for (; i < n; ++i) {
+        out[i] = hash_64i(in[i], mask);
+      }
+    }
+
+  };
+
+}
+
+#endif
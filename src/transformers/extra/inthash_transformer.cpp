@@ -44,8 +44,11 @@
 #include "inthash_transformer.hpp"
 
 #include "common.hpp"
+#include "hash_kernel.hpp"
 #include "inthash.h"
 
+#include <algorithm>
+
 using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
@@ -77,22 +80,60 @@ Transformer::EncodedKmer IntHashTransformer::operator()(const string &kmer) cons
     e.prefix = v >> _prefix_shift;
     e.suffix = v & _suffix_mask;
   } else {
+    // Only the first 32 nucleotides are hashed. The transformed k-mer
+    // is the hashed word followed by the last nucleotides, thus the
+    // suffix starts with the end of the hashed word (if the prefix is
+    // shorter than 32 nucleotides).
+    const size_t n = kmer_length - 32;
     uint64_t prefix = _encode(kmer.c_str(), 32);
-    uint64_t suffix = _encode(kmer.c_str() + 32, kmer_length - 32);
+    uint64_t suffix = _encode(kmer.c_str() + 32, n);
     uint64_t prefix_transformed = hash_64(prefix, _kmer_mask);
     e.prefix = prefix_transformed >> _prefix_shift;
-    e.suffix = prefix_transformed << (prefix_length << 1) | suffix;
+    e.suffix = ((n < 32) ? ((prefix_transformed & ((1ull << _prefix_shift) - 1)) << (n << 1)) : 0) | suffix;
   }
   return e;
 }
 
+Transformer::EncodedKmer IntHashTransformer::operator()(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  EncodedKmer e;
+  const uint64_t v = hash_64(kmer, _kmer_mask);
+  e.prefix = v >> _prefix_shift;
+  e.suffix = v & _suffix_mask;
+  return e;
+}
+
+void IntHashTransformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  assert(kmer_length <= 32);
+  uint64_t chunk[256];
+  for (size_t first = 0; first < n; first += 256) {
+    const size_t m = min<size_t>(n - first, 256);
+    HashKernel::intHash(packed + first, m, chunk, _kmer_mask);
+#ifdef DEBUG
+    uint64_t rev_chunk[256];
+    HashKernel::intHashInverse(chunk, m, rev_chunk, _kmer_mask);
+    assert(equal(rev_chunk, rev_chunk + m, packed + first));
+#endif
+    for (size_t i = 0; i < m; ++i) {
+      out[first + i].prefix = chunk[i] >> _prefix_shift;
+      out[first + i].suffix = chunk[i] & _suffix_mask;
+    }
+  }
+}
+
+uint64_t IntHashTransformer::transformPacked(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  return hash_64(kmer, _kmer_mask);
+}
+
 string IntHashTransformer::operator()(const Transformer::EncodedKmer &e) const {
   if (kmer_length <= 32) {
     uint64_t v = (e.prefix << _prefix_shift) | e.suffix;
     v = hash_64i(v, _kmer_mask);
     return _decode(v, kmer_length);
   } else {
-    uint64_t u = (e.prefix << _prefix_shift) | (e.suffix >> (prefix_length << 1));
+    const size_t n = kmer_length - 32;
+    uint64_t u = (e.prefix << _prefix_shift) | ((n < 32) ? (e.suffix >> (n << 1)) : 0);
     u = hash_64i(u, _kmer_mask);
     uint64_t v = e.suffix & _suffix_mask;
     return _decode(u, 32) + _decode(v, kmer_length - 32);
@@ -104,7 +145,8 @@ string IntHashTransformer::getTransformedKmer(const Transformer::EncodedKmer &e)
     uint64_t v = (e.prefix << _prefix_shift) | e.suffix;
     return _decode(v, kmer_length);
   } else {
-    uint64_t u = (e.prefix << _prefix_shift) | (e.suffix >> (prefix_length << 1));
+    const size_t n = kmer_length - 32;
+    uint64_t u = (e.prefix << _prefix_shift) | ((n < 32) ? (e.suffix >> (n << 1)) : 0);
     uint64_t v = e.suffix & _suffix_mask;
     return _decode(u, 32) + _decode(v, kmer_length - 32);
   }
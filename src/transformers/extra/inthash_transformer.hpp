@@ -100,6 +100,40 @@ namespace bijecthash {
      */
     virtual EncodedKmer operator()(const std::string &kmer) const override;
 
+    /**
+     * Encode some given packed k-mer into a prefix/suffix code.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    virtual EncodedKmer operator()(uint64_t kmer) const override;
+
+    /**
+     * Encode some given batch of packed k-mers into prefix/suffix
+     * codes (see Transformer::transformBatch()).
+     *
+     * The IntHash function is evaluated on several k-mers at once when
+     * the processor supports it (see HashKernel).
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    virtual void transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const override;
+
+    /**
+     * Transform some given packed k-mer into a packed transformed
+     * k-mer.
+     *
+     * \param kmer The packed k-mer to transform.
+     *
+     * \return Returns the packed transformed k-mer.
+     */
+    virtual uint64_t transformPacked(uint64_t kmer) const override;
+
     /**
      * Decode some given encoded k-mer.
      *
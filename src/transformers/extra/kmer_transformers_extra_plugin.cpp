@@ -43,6 +43,8 @@
 
 #include <sphinx++/macros.h>
 
+#include <cctype>
+#include <cstdlib>
 #include <memory>
 #include <string>
 #include <vector>
@@ -90,10 +92,13 @@ BEGIN_BIJECTHASH_NAMESPACE
   "b value acts as a bit mask of length 2 * k."
 
 #define MINIMIZER_TRANSFORMER_LABEL           "minimizer" SUFFIX
-#define MINIMIZER_TRANSFORMER_EXTRA           ""
+#define MINIMIZER_TRANSFORMER_EXTRA           "[=<ordering>[,<seed>]]"
 #define MINIMIZER_TRANSFORMER_DESCRIPTION                               \
   "The '" MINIMIZER_TRANSFORMER_LABEL MINIMIZER_TRANSFORMER_EXTRA "' "  \
-  "uses the minimizer of the k-mer to encode its transform."
+  "uses the minimizer of the k-mer to encode its transform. The "       \
+  "ordering of the minimizer candidates is either 'xorshift' (default), " \
+  "'lexicographic' or 'random' (random tables generated from the seed, " \
+  "by default a random one)."
 
 
 ////////////////////////////////////////////////////////////////
@@ -126,7 +131,25 @@ shared_ptr<const Transformer> _transformerFactory(size_t kmer_length,
     }
     t = make_shared<const GaBTransformer>(kmer_length, prefix_length, a, b);
   } else if (label == MINIMIZER_TRANSFORMER_LABEL) {
-    t = make_shared<const MinimizerTransformer>(kmer_length, prefix_length);
+    MinimizerTransformer::Ordering ordering = MinimizerTransformer::XORSHIFT;
+    uint64_t seed = 0;
+    if (!extra.empty()) {
+      size_t sep = extra.find(',');
+      bool ok = MinimizerTransformer::string2ordering(extra.substr(0, sep), ordering);
+      if (ok && (sep != string::npos)) {
+        // The seed must be a non empty unsigned decimal value (strtoul()
+        // would silently accept an empty or signed one).
+        const char *start = extra.c_str() + sep + 1;
+        char *ptr;
+        seed = strtoul(start, &ptr, 10);
+        ok = ((ordering == MinimizerTransformer::RANDOM_TABLE)
+              && isdigit((unsigned char) *start) && (*ptr == '\0'));
+      }
+      if (!ok) {
+        throw Exception("Error: unable to parse the minimizer method parameters.\n");
+      }
+    }
+    t = make_shared<const MinimizerTransformer>(kmer_length, prefix_length, ordering, seed);
   } else {
     Exception e;
     e << "Error: Unsupported transformation method '" << label << extra << "'.\n";
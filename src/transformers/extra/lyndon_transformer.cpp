@@ -45,43 +45,106 @@
 
 #include "common.hpp"
 
+#include <algorithm>
+
 using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
+/*
+ * Compute the (lowest) starting position of the least rotation of
+ * the n first symbols of s in linear time (using the two candidates
+ * "minimum expression" algorithm).
+ */
+static size_t leastRotation(const char *s, size_t n) {
+  size_t i = 0, j = 1, l = 0;
+  while ((i < n) && (j < n) && (l < n)) {
+    const char a = s[(i + l) % n];
+    const char b = s[(j + l) % n];
+    if (a == b) {
+      ++l;
+    } else {
+      // No rotation starting in ]i; i + l] (resp. ]j; j + l]) can be
+      // the least one.
+      if (a > b) {
+        i += l + 1;
+      } else {
+        j += l + 1;
+      }
+      if (i == j) {
+        ++j;
+      }
+      l = 0;
+    }
+  }
+  return (i < j ? i : j);
+}
+
 LyndonTransformer::LyndonTransformer(size_t kmer_length, size_t prefix_length):
-  Transformer(kmer_length, prefix_length, "Lyndon"){
-  assert(suffix_length <= 30);
+  Transformer(kmer_length, prefix_length, "Lyndon"),
+  _kmer_mask((1ull << kmer_length << kmer_length) - 1ull),
+  _suffix_mask((1ull << (2 * suffix_length)) - 1)
+{
+  // The position of the Lyndon rotation is stored on the 6 highest
+  // bits of the suffix code.
+  assert(suffix_length <= 29);
 }
 
 Transformer::EncodedKmer LyndonTransformer::operator()(const string &kmer) const {
-  EncodedKmer e;
-  size_t lyndon_pos = 0;
-  for (size_t i = 1; i < kmer.size(); ++i) {
-    if (kmer.substr(i) + kmer.substr(0, i) < kmer.substr(lyndon_pos) + kmer.substr(0, lyndon_pos)) {
-      lyndon_pos = i;
-    }
+  assert(kmer.size() == kmer_length);
+  if (kmer_length <= 32) {
+    return (*this)(_encode(kmer.c_str(), kmer_length));
   }
+  EncodedKmer e;
+  const size_t lyndon_pos = leastRotation(kmer.c_str(), kmer_length);
 
   DEBUG_MSG("Lyndon rotation index: " << lyndon_pos);
 
   assert(lyndon_pos < 64); // lyndon_pos can be encoded in only 6 bits
-  string lyndon_rotation;
-  lyndon_rotation.reserve(kmer.size());
-  lyndon_rotation = kmer.substr(lyndon_pos) + kmer.substr(0, lyndon_pos);
+  char lyndon_rotation[64];
+  kmer.copy(lyndon_rotation, kmer_length - lyndon_pos, lyndon_pos);
+  kmer.copy(lyndon_rotation + kmer_length - lyndon_pos, lyndon_pos);
 
-  DEBUG_MSG("Lyndon rotation: '" << lyndon_rotation << "'");
+  DEBUG_MSG("Lyndon rotation: '" << string(lyndon_rotation, kmer_length) << "'");
 
-  e.prefix = _encode(lyndon_rotation.c_str(), prefix_length);
-  e.suffix = _encode(lyndon_rotation.c_str() + prefix_length, suffix_length);
+  e.prefix = _encode(lyndon_rotation, prefix_length);
+  e.suffix = _encode(lyndon_rotation + prefix_length, suffix_length);
   e.suffix |= lyndon_pos<<58;
   return e;
 }
 
+Transformer::EncodedKmer LyndonTransformer::operator()(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  // Since A < C < G < T, the lexicographic order of the rotations is
+  // the numeric order of their 2 bits encoding. Ties are resolved in
+  // favor of the first rotation.
+  uint64_t lyndon_rotation = kmer;
+  size_t lyndon_pos = 0;
+  for (size_t i = 1; i < kmer_length; ++i) {
+    const uint64_t rotation = ((kmer << (2 * i)) | (kmer >> (2 * (kmer_length - i)))) & _kmer_mask;
+    if (rotation < lyndon_rotation) {
+      lyndon_rotation = rotation;
+      lyndon_pos = i;
+    }
+  }
+
+  DEBUG_MSG("Lyndon rotation index: " << lyndon_pos);
+
+  EncodedKmer e;
+  e.prefix = lyndon_rotation >> (2 * suffix_length);
+  e.suffix = (lyndon_rotation & _suffix_mask) | (uint64_t(lyndon_pos) << 58);
+  return e;
+}
+
+void LyndonTransformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  _transformBatch(*this, packed, n, out);
+}
+
 string LyndonTransformer::operator()(const Transformer::EncodedKmer &e) const {
   size_t lyndon_pos = e.suffix >> 58;
-  string lyndon_rotation = _decode(e.prefix, prefix_length) + _decode(e.suffix, suffix_length);
-  string kmer = lyndon_rotation.substr(lyndon_rotation.size() - lyndon_pos) + lyndon_rotation.substr(0, lyndon_rotation.size() - lyndon_pos);
+  string kmer = _decode(e.prefix, prefix_length) + _decode(e.suffix, suffix_length);
+  // The k-mer is the Lyndon rotation rotated back (to the right).
+  rotate(kmer.begin(), kmer.end() - lyndon_pos, kmer.end());
   return kmer;
 }
 
@@ -45,6 +45,7 @@
 #define __LYNDON_TRANSFORMER_HPP__
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <transformer.hpp>
@@ -56,6 +57,18 @@ namespace bijecthash {
    */
   class LyndonTransformer: public Transformer {
 
+  private:
+
+    /**
+     * Precomputed binary mask for retrieving the whole (packed) k-mer.
+     */
+    const uint64_t _kmer_mask;
+
+    /**
+     * Precomputed binary mask for retrieving the suffix.
+     */
+    const uint64_t _suffix_mask;
+
   public:
 
     /**
@@ -77,6 +90,30 @@ namespace bijecthash {
      */
     virtual EncodedKmer operator()(const std::string &kmer) const override;
 
+    /**
+     * Encode some given packed k-mer into its Lyndon rotation.
+     *
+     * The least rotation is found by comparing the (bitwise) rotations
+     * of the packed k-mer.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    virtual EncodedKmer operator()(uint64_t kmer) const override;
+
+    /**
+     * Encode some given batch of packed k-mers into prefix/suffix
+     * codes (see Transformer::transformBatch()).
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    virtual void transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const override;
+
     /**
      * Decode some given encoded k-mer.
      *
@@ -45,15 +45,43 @@
 
 #include "common.hpp"
 
+#include <algorithm>
 #include <limits>
+#include <random>
 
 using namespace std;
 
 BEGIN_BIJECTHASH_NAMESPACE
 
-MinimizerTransformer::MinimizerTransformer(size_t kmer_length, size_t prefix_length) :
-  Transformer(kmer_length, prefix_length, "Minimizer") {
-  assert(suffix_length <= 30);
+static uint64_t randomSeed() {
+  random_device rd;
+  uniform_int_distribution<uint64_t> d(1);
+  return d(rd);
+}
+
+static vector<uint64_t> randomTables(size_t prefix_length, uint64_t seed) {
+  // One table of 256 random values per byte of the packed candidates.
+  vector<uint64_t> tables(((2 * prefix_length + 7) >> 3) << 8);
+  mt19937_64 g(seed);
+  for (uint64_t &v: tables) {
+    v = g();
+  }
+  return tables;
+}
+
+MinimizerTransformer::MinimizerTransformer(size_t kmer_length, size_t prefix_length,
+                                           Ordering ordering, uint64_t seed) :
+  Transformer(kmer_length, prefix_length, "Minimizer"),
+  _ordering(ordering),
+  _seed(((ordering != RANDOM_TABLE) || seed) ? seed : randomSeed()),
+  _nb_candidates(kmer_length - prefix_length + 1),
+  _prefix_mask((1ull << prefix_length << prefix_length) - 1ull),
+  _kmer_mask((1ull << kmer_length << kmer_length) - 1ull),
+  _random_tables((ordering == RANDOM_TABLE) ? randomTables(prefix_length, _seed) : vector<uint64_t>())
+{
+  // The minimizer position is stored on the 6 highest bits of the
+  // suffix code.
+  assert(suffix_length <= 29);
 }
 
 uint64_t MinimizerTransformer::xorshift(uint64_t x) const {
@@ -63,14 +91,35 @@ uint64_t MinimizerTransformer::xorshift(uint64_t x) const {
   return x * 0x2545F4914F6CDD1D;
 }
 
+Transformer::EncodedKmer MinimizerTransformer::_encodePacked(uint64_t kmer, size_t minimizer_pos) const {
+  assert(kmer_length <= 32);
+  assert(minimizer_pos < _nb_candidates);
+  // The transformed k-mer is the minimizer followed by the
+  // nucleotides before and after it.
+  const size_t after_length = _nb_candidates - 1 - minimizer_pos;
+  const uint64_t before = minimizer_pos ? (kmer >> (2 * (kmer_length - minimizer_pos))) : 0;
+  const uint64_t after = kmer & ((1ull << (2 * after_length)) - 1);
+  Transformer::EncodedKmer encoded;
+  encoded.prefix = (kmer >> (2 * after_length)) & _prefix_mask;
+  encoded.suffix = (before << (2 * after_length)) | after;
+  encoded.suffix |= uint64_t(minimizer_pos) << (64 - 6);
+  return encoded;
+}
+
 Transformer::EncodedKmer MinimizerTransformer::operator()(const string& kmer) const {
+  assert(kmer.size() == kmer_length);
+  if (kmer_length <= 32) {
+    return (*this)(_encode(kmer.c_str(), kmer_length));
+  }
   Transformer::EncodedKmer encoded;
   uint64_t min_hash = numeric_limits<uint64_t>::max();
   size_t minimizer_pos = 0;
-  assert(kmer.size() == kmer_length);
 
+  // The candidates are rolled over the k-mer.
+  uint64_t candidate = _encode(kmer.c_str(), prefix_length - 1);
   for (size_t i = 0; i + prefix_length <= kmer_length; ++i) {
-    uint64_t hash = xorshift(_encode(kmer.c_str() + i, prefix_length));
+    candidate = ((candidate << 2) | _encode(kmer.c_str() + i + prefix_length - 1, 1)) & _prefix_mask;
+    uint64_t hash = _rank(candidate);
     if (hash < min_hash) {
       min_hash = hash;
       minimizer_pos = i;
@@ -78,46 +127,146 @@ Transformer::EncodedKmer MinimizerTransformer::operator()(const string& kmer) co
   }
   assert(minimizer_pos + prefix_length <= kmer_length);
 
-  string before = kmer.substr(0, minimizer_pos);
-  string minimizer = kmer.substr(minimizer_pos, prefix_length);
-  string after = kmer.substr(minimizer_pos + prefix_length);
+  char transformed[64];
+  kmer.copy(transformed, prefix_length, minimizer_pos);
+  kmer.copy(transformed + prefix_length, minimizer_pos);
+  kmer.copy(transformed + prefix_length + minimizer_pos, kmer_length - prefix_length - minimizer_pos,
+            minimizer_pos + prefix_length);
 
-  DEBUG_MSG("Minimizer: '" << minimizer << "', Before: '" << before << "', After: '" << after << "'");
+  DEBUG_MSG("Transformed: '" << string(transformed, kmer_length) << "', "
+            << "Prefix length: '" << prefix_length << "', "
+            << "Suffix Length: '" << suffix_length << "', "
+            << "Minimiser pos: '" << minimizer_pos << "'");
 
-  string transformed = minimizer + before + after;
-
-  DEBUG_MSG("Transformed: '" << transformed << "', "
-            << "Prefix:  '" << transformed.c_str() << "', Prefix length: '" << prefix_length << "', "
-            << "Suffix:'" << transformed.c_str() + prefix_length << "', Suffix Length: '" << suffix_length << "', "
-            << "Minimiser pos: '" << minimizer_pos << (64 - 6) << "'");
-
-  encoded.prefix = _encode(transformed.c_str(), prefix_length);
-  encoded.suffix = _encode(transformed.c_str() + prefix_length, suffix_length);
+  encoded.prefix = _encode(transformed, prefix_length);
+  encoded.suffix = _encode(transformed + prefix_length, suffix_length);
   encoded.suffix |= minimizer_pos << (64 - 6);
 
   return encoded;
 }
 
+Transformer::EncodedKmer MinimizerTransformer::operator()(uint64_t kmer) const {
+  assert(kmer_length <= 32);
+  uint64_t min_hash = numeric_limits<uint64_t>::max();
+  size_t minimizer_pos = 0;
+  for (size_t i = 0; i < _nb_candidates; ++i) {
+    uint64_t hash = _rank((kmer >> (2 * (_nb_candidates - 1 - i))) & _prefix_mask);
+    if (hash < min_hash) {
+      min_hash = hash;
+      minimizer_pos = i;
+    }
+  }
+  return _encodePacked(kmer, minimizer_pos);
+}
+
+void MinimizerTransformer::transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const {
+  assert(kmer_length <= 32);
+  Stream stream(*this);
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t kmer = packed[i];
+    if (i && ((((stream.getCurrentKmer() << 2) | (kmer & 3)) & _kmer_mask) == kmer)) {
+      stream.push(kmer & 3);
+    } else {
+      // Not the successor of the previous k-mer, feed the stream with
+      // the whole k-mer.
+      stream.reset();
+      for (size_t j = kmer_length; j--;) {
+        stream.push((kmer >> (2 * j)) & 3);
+      }
+    }
+    out[i] = stream.encode();
+  }
+}
 
 string MinimizerTransformer::operator()(const Transformer::EncodedKmer& encoded) const {
   size_t minimizer_pos = encoded.suffix >> (64 - 6);
+  assert(minimizer_pos < _nb_candidates);
 
-  string decoded;
-  decoded.reserve(kmer_length);
+  string decoded = _decode(encoded.prefix, prefix_length) + _decode(encoded.suffix, suffix_length);
 
-  string prefix = _decode(encoded.prefix, prefix_length);
-  decoded += prefix;
+  DEBUG_MSG("Transformed: '" << decoded << "', Minimizer pos: '" << minimizer_pos << "'");
 
-  string suffix = _decode(encoded.suffix, suffix_length);
-  decoded += suffix;
+  // Move the minimizer back after the nucleotides preceding it.
+  rotate(decoded.begin(), decoded.begin() + prefix_length, decoded.begin() + prefix_length + minimizer_pos);
+  return decoded;
+}
+
+string MinimizerTransformer::getParameters() const {
+  if (_ordering != RANDOM_TABLE) {
+    return Transformer::getParameters();
+  }
+  return ordering2string(_ordering) + "," + to_string(_seed);
+}
 
-  string minimizer = decoded.substr(0, prefix_length);
-  string before = decoded.substr(prefix_length, minimizer_pos);
-  string after = decoded.substr(minimizer_pos + prefix_length);
+string MinimizerTransformer::ordering2string(Ordering ordering) {
+  switch (ordering) {
+  case XORSHIFT: return "xorshift";
+  case LEXICOGRAPHIC: return "lexicographic";
+  case RANDOM_TABLE: return "random";
+  }
+  return "";
+}
 
-  DEBUG_MSG(" Minimizer: '" << minimizer << "', Before: '" << before << "', After: '" << after << "'");
+bool MinimizerTransformer::string2ordering(const string &name, Ordering &ordering) {
+  for (Ordering o: { XORSHIFT, LEXICOGRAPHIC, RANDOM_TABLE }) {
+    if (name == ordering2string(o)) {
+      ordering = o;
+      return true;
+    }
+  }
+  return false;
+}
+
+MinimizerTransformer::Stream::Stream(const MinimizerTransformer &transformer):
+  _transformer(transformer), _kmer(0), _length(0), _first(0), _size(0)
+{
+  assert(_transformer.kmer_length <= 32);
+}
+
+void MinimizerTransformer::Stream::reset() {
+  _kmer = 0;
+  _length = 0;
+  _first = 0;
+  _size = 0;
+}
+
+bool MinimizerTransformer::Stream::push(uint64_t code) {
+  assert(code < 4);
+  const size_t k = _transformer.kmer_length;
+  const size_t p = _transformer.prefix_length;
+  _kmer = ((_kmer << 2) | code) & _transformer._kmer_mask;
+  ++_length;
+  if (_length >= p) {
+    // The new candidate discards the queued ones having a greater rank
+    // (since they can't be the minimizer anymore), but not those
+    // having the same rank (the first one is kept on ties).
+    const uint64_t hash = _transformer._rank(_kmer & _transformer._prefix_mask);
+    while (_size && (_hashes[(_first + _size - 1) & 63] > hash)) {
+      --_size;
+    }
+    _hashes[(_first + _size) & 63] = hash;
+    _positions[(_first + _size) & 63] = _length - p;
+    ++_size;
+    // Discard the candidates starting before the current k-mer.
+    if (_length > k) {
+      while (_positions[_first] < _length - k) {
+        _first = (_first + 1) & 63;
+        --_size;
+      }
+    }
+    assert(_size);
+    assert(_size <= _transformer._nb_candidates);
+  }
+  return _length >= k;
+}
+
+size_t MinimizerTransformer::Stream::getMinimizerPosition() const {
+  assert(_length >= _transformer.kmer_length);
+  return _positions[_first] - (_length - _transformer.kmer_length);
+}
 
-  return before + minimizer + after;
+Transformer::EncodedKmer MinimizerTransformer::Stream::encode() const {
+  return _transformer._encodePacked(_kmer, getMinimizerPosition());
 }
 
 END_BIJECTHASH_NAMESPACE
@@ -47,6 +47,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include <transformer.hpp>
 
@@ -57,6 +58,203 @@ namespace bijecthash {
    */
   class MinimizerTransformer : public Transformer {
 
+  public:
+
+    /**
+     * The available orderings of the minimizer candidates (the
+     * \f$p\f$-mers of the \f$k\f$-mer).
+     */
+    enum Ordering {
+      XORSHIFT,      /**< The order of the xorshift hash values. */
+      LEXICOGRAPHIC, /**< The lexicographic order. */
+      RANDOM_TABLE   /**< The order of random tabulation hash values. */
+    };
+
+    /**
+     * Streaming minimizer computation.
+     *
+     * The stream is fed the nucleotides of a sequence and maintains
+     * both the current (packed) k-mer and the minimizer of its
+     * window using a monotone queue of the candidates, which makes
+     * the minimizer computation amortized constant time per k-mer
+     * (instead of \f$k - p + 1\f$ hash computations).
+     *
+     * The k-mer length must be at most 32.
+     */
+    class Stream {
+
+    private:
+
+      /**
+       * The transformer of this stream.
+       */
+      const MinimizerTransformer &_transformer;
+
+      /**
+       * The current (packed) k-mer.
+       */
+      uint64_t _kmer;
+
+      /**
+       * The number of nucleotides fed since the last reset.
+       */
+      size_t _length;
+
+      /**
+       * The hash values of the monotone queue candidates.
+       */
+      uint64_t _hashes[64];
+
+      /**
+       * The positions (in the stream) of the monotone queue candidates.
+       */
+      size_t _positions[64];
+
+      /**
+       * The index of the first candidate of the monotone queue
+       * (modulo 64).
+       */
+      size_t _first;
+
+      /**
+       * The number of candidates in the monotone queue.
+       */
+      size_t _size;
+
+    public:
+
+      /**
+       * Builds an empty stream for the given transformer.
+       *
+       * \param transformer The minimizer transformer to use.
+       */
+      Stream(const MinimizerTransformer &transformer);
+
+      /**
+       * Restart the stream (typically on a new sequence or after an
+       * invalid nucleotide).
+       */
+      void reset();
+
+      /**
+       * Feed the stream with the next nucleotide.
+       *
+       * \param code The 2 bits code of the nucleotide.
+       *
+       * \return Returns true if a whole k-mer is available (see
+       * encode()).
+       */
+      bool push(uint64_t code);
+
+      /**
+       * Get the current (packed) k-mer.
+       *
+       * \return Returns the current (packed) k-mer.
+       */
+      inline uint64_t getCurrentKmer() const {
+        return _kmer;
+      }
+
+      /**
+       * Get the minimizer position in the current k-mer.
+       *
+       * \return Returns the minimizer position in the current k-mer
+       * (this is only relevant if a whole k-mer is available).
+       */
+      size_t getMinimizerPosition() const;
+
+      /**
+       * Encodes the current k-mer.
+       *
+       * This gives the same encoding as the transformer.
+       *
+       * \return Returns the EncodedKmer corresponding to the current
+       * k-mer.
+       */
+      EncodedKmer encode() const;
+
+    };
+
+  private:
+
+    /**
+     * The minimizer candidates ordering.
+     */
+    const Ordering _ordering;
+
+    /**
+     * The seed of the random tables (only relevant for the
+     * RANDOM_TABLE ordering).
+     */
+    const uint64_t _seed;
+
+    /**
+     * The number of candidates (\f$k - p + 1\f$).
+     */
+    const size_t _nb_candidates;
+
+    /**
+     * Precomputed binary mask for retrieving the (packed) candidates.
+     */
+    const uint64_t _prefix_mask;
+
+    /**
+     * Precomputed binary mask for retrieving the whole (packed) k-mer.
+     */
+    const uint64_t _kmer_mask;
+
+    /**
+     * The byte-wise random tables of the RANDOM_TABLE ordering.
+     */
+    const std::vector<uint64_t> _random_tables;
+
+    /**
+     * Internal method to calculate the xorshift hash of a substring.
+     *
+     * \param x The value to hash hash.
+     *
+     * \return The hash of the given value.
+     */
+    uint64_t xorshift(uint64_t x) const;
+
+    /**
+     * Computes the rank of some candidate according to the ordering of
+     * this transformer.
+     *
+     * \param x The packed candidate.
+     *
+     * \return Returns the rank (hash value) of the given candidate.
+     */
+    inline uint64_t _rank(uint64_t x) const {
+      switch (_ordering) {
+      case LEXICOGRAPHIC:
+        return x;
+      case RANDOM_TABLE: {
+        uint64_t h = 0;
+        const uint64_t *table = _random_tables.data();
+        while (x) {
+          h ^= table[x & 0xFF];
+          x >>= 8;
+          table += 256;
+        }
+        return h;
+      }
+      default:
+        return xorshift(x);
+      }
+    }
+
+    /**
+     * Encodes the given packed k-mer knowing its minimizer position.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \param minimizer_pos The minimizer position in the k-mer.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    EncodedKmer _encodePacked(uint64_t kmer, size_t minimizer_pos) const;
+
   public:
 
     /**
@@ -66,8 +264,15 @@ namespace bijecthash {
      * value of \f$k\f$).
      *
      * \param prefix_length The length of the \f$k\f$-mer prefix.
+     *
+     * \param ordering The ordering of the minimizer candidates.
+     *
+     * \param seed The seed of the random tables (if zero, then a
+     * random seed is generated). This is only relevant for the
+     * RANDOM_TABLE ordering.
      */
-    MinimizerTransformer(size_t kmer_length, size_t prefix_length);
+    MinimizerTransformer(size_t kmer_length, size_t prefix_length,
+                         Ordering ordering = XORSHIFT, uint64_t seed = 0);
 
     /**
      * Encodes a given k-mer into a prefix/suffix code using a minimizer.
@@ -80,6 +285,33 @@ namespace bijecthash {
      */
     virtual EncodedKmer operator()(const std::string &kmer) const override;
 
+    /**
+     * Encodes a given packed k-mer into a prefix/suffix code using a
+     * minimizer.
+     *
+     * \param kmer The packed k-mer to encode.
+     *
+     * \return Returns the EncodedKmer corresponding to the given k-mer.
+     */
+    virtual EncodedKmer operator()(uint64_t kmer) const override;
+
+    /**
+     * Encodes some given batch of packed k-mers into prefix/suffix
+     * codes (see Transformer::transformBatch()).
+     *
+     * Runs of consecutive k-mers (i.e., each k-mer is the successor of
+     * the previous one in some sequence) go through a Stream, thus
+     * each k-mer costs a single new candidate ranking instead of \f$k -
+     * p + 1\f$.
+     *
+     * \param packed The packed k-mers to encode.
+     *
+     * \param n The number of k-mers to encode.
+     *
+     * \param out The array of (at least n) encodings to fill.
+     */
+    virtual void transformBatch(const uint64_t *packed, size_t n, EncodedKmer *out) const override;
+
     /**
      * Decodes a given encoded k-mer back to its original string representation.
      *
@@ -91,16 +323,36 @@ namespace bijecthash {
      */
     virtual std::string operator()(const EncodedKmer &e) const override;
 
-  private:
+    /**
+     * Get the arguments allowing to build a transformer identical to
+     * this one.
+     *
+     * \return Returns the ordering name (followed by the seed for the
+     * random tables ordering).
+     */
+    virtual std::string getParameters() const override;
 
     /**
-     * Internal method to calculate the xorshift hash of a substring.
+     * Get the name of the given ordering.
      *
-     * \param x The value to hash hash.
+     * \param ordering The ordering.
      *
-     * \return The hash of the given value.
+     * \return Returns the name of the given ordering.
      */
-    uint64_t xorshift(uint64_t x) const;
+    static std::string ordering2string(Ordering ordering);
+
+    /**
+     * Get the ordering having the given name.
+     *
+     * \param name The ordering name (either "xorshift",
+     * "lexicographic" or "random").
+     *
+     * \param ordering The ordering to set.
+     *
+     * \return Returns true if the name corresponds to some ordering
+     * (then the ordering parameter is updated) and false otherwise.
+     */
+    static bool string2ordering(const std::string &name, Ordering &ordering);
 
   };
 
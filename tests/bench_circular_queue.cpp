@@ -0,0 +1,144 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "circular_queue.hpp"
+#include "spinlock_circular_queue.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+/*
+ * Throughput comparison between the lock-free circular queue and the
+ * spinlocked one as the number of producers (the k-mer collectors)
+ * and consumers (the k-mer processors) grows.
+ *
+ * Usage: bench_circular_queue [<nb_items_per_producer> [<max_threads> [<queue_size>]]]
+ */
+
+template <typename Queue>
+double run(size_t nb_producers, size_t nb_consumers, size_t nb_items, size_t queue_size) {
+
+  Queue q(queue_size);
+  atomic_size_t running_producers(nb_producers);
+  atomic_size_t checksum(0);
+  vector<thread> threads;
+  threads.reserve(nb_producers + nb_consumers);
+
+  auto start = chrono::steady_clock::now();
+
+  for (size_t p = 0; p < nb_producers; ++p) {
+    threads.emplace_back([&]() {
+      // k-mer like payload, as in the collectors.
+      string kmer(31, 'A');
+      for (size_t i = 0; i < nb_items; ++i) {
+        kmer[i % kmer.size()] = "ACGT"[i & 3];
+        while (!q.push(kmer)) {
+          this_thread::yield();
+        }
+      }
+      --running_producers;
+    });
+  }
+
+  for (size_t c = 0; c < nb_consumers; ++c) {
+    threads.emplace_back([&]() {
+      string kmer;
+      size_t nb = 0;
+      while ((running_producers > 0) || !q.empty()) {
+        if (q.pop(kmer)) {
+          ++nb;
+        } else {
+          this_thread::yield();
+        }
+      }
+      checksum += nb;
+    });
+  }
+
+  for (auto &t: threads) {
+    t.join();
+  }
+
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+  if (checksum != nb_producers * nb_items) {
+    cerr << "Error: " << checksum << " items were dequeued"
+         << " but " << nb_producers * nb_items << " were enqueued." << endl;
+    exit(1);
+  }
+
+  // Millions of k-mers transferred per second.
+  return (nb_producers * nb_items) / elapsed.count() / 1e6;
+
+}
+
+int main(int argc, char **argv) {
+
+  size_t nb_items = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+  size_t max_threads = (argc > 2) ? strtoul(argv[2], NULL, 10) : 2 * thread::hardware_concurrency();
+  size_t queue_size = (argc > 3) ? strtoul(argv[3], NULL, 10) : 1024;
+
+  cout << "# Queue size: " << queue_size << ", " << nb_items << " k-mers per producer" << endl;
+  cout << "#Producers\tConsumers\tSpinlock(Mkmers/s)\tLockFree(Mkmers/s)\tSpeedup" << endl;
+  for (size_t p = 1; p <= max_threads; p <<= 1) {
+    for (size_t c = 1; p + c <= max_threads + 1; c <<= 1) {
+      double t_spin = run<SpinlockCircularQueue<string> >(p, c, nb_items, queue_size);
+      double t_free = run<CircularQueue<string> >(p, c, nb_items, queue_size);
+      cout << p << '\t' << c
+           << '\t' << fixed << setprecision(3) << t_spin
+           << '\t' << t_free
+           << '\t' << (t_free / t_spin) << endl;
+    }
+  }
+
+  return 0;
+}
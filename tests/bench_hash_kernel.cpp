@@ -0,0 +1,166 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "hash_kernel.hpp"
+
+// The scalar IntHash functions (hash_64() and hash_64i()).
+#include "inthash.c"
+
+using namespace std;
+using namespace bijecthash;
+
+/*
+ * Throughput comparison between the word by word evaluation of the
+ * GaB and IntHash functions (as done by the transformers before the
+ * batch kernels) and the hash kernel implementations, on batches of
+ * 256 packed k-mers (as done by the transformers).
+ *
+ * Usage: bench_hash_kernel [<nb_millions_of_kmers> [<k>]]
+ */
+
+template <typename F>
+double measure(F f, size_t nb_words, uint64_t &checksum) {
+  auto start = chrono::steady_clock::now();
+  checksum = f();
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  // Millions of words per second.
+  return nb_words / elapsed.count() / 1e6;
+}
+
+// Apply the given batch function on chunks of 256 words and sum the
+// results.
+template <typename F>
+uint64_t run(const vector<uint64_t> &words, F f) {
+  uint64_t chunk[256];
+  uint64_t sum = 0;
+  for (size_t first = 0; first < words.size(); first += 256) {
+    const size_t m = min<size_t>(words.size() - first, 256);
+    f(words.data() + first, m, chunk);
+    for (size_t i = 0; i < m; ++i) {
+      sum += chunk[i];
+    }
+  }
+  return sum;
+}
+
+int main(int argc, char **argv) {
+
+  const size_t nb_words = ((argc > 1) ? strtoul(argv[1], NULL, 10) : 64) * 1000000;
+  const size_t k = (argc > 2) ? strtoul(argv[2], NULL, 10) : 31;
+  if ((k == 0) || (k > 32)) {
+    cerr << "The k-mer length must be between 1 and 32." << endl;
+    return 1;
+  }
+  const uint64_t mask = (k == 32) ? uint64_t(-1) : ((1ull << (2 * k)) - 1);
+  const uint64_t a = 0x9E3779B97F4A7C15ull, b = 0x5851F42D4C957F2Dull & mask;
+
+  // Cheap deterministic pseudo random generator.
+  vector<uint64_t> words(nb_words);
+  uint64_t x = 88172645463325252ull;
+  for (uint64_t &w: words) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    w = x & mask;
+  }
+
+  cout << "# " << (nb_words / 1000000) << "M k-mers, k = " << k
+       << " (best available implementation: " << HashKernel::level2string(HashKernel::bestLevel()) << ")" << endl;
+  cout << "#Implementation\tGaB(Mkmers/s)\tIntHash(Mkmers/s)\tSpeedup(GaB)\tSpeedup(IntHash)" << endl;
+
+  uint64_t gab_checksum, inthash_checksum;
+  const double ref_gab = measure([&]() {
+    return run(words, [&](const uint64_t *in, size_t n, uint64_t *out) {
+      for (size_t i = 0; i < n; ++i) {
+        const uint64_t rotated = ((in[i] << k) | (in[i] >> k)) & mask;
+        out[i] = (a * (rotated ^ b)) & mask;
+      }
+    });
+  }, nb_words, gab_checksum);
+  const double ref_inthash = measure([&]() {
+    return run(words, [&](const uint64_t *in, size_t n, uint64_t *out) {
+      for (size_t i = 0; i < n; ++i) {
+        out[i] = hash_64(in[i], mask);
+      }
+    });
+  }, nb_words, inthash_checksum);
+  cout << "word" << '\t' << fixed << setprecision(1) << ref_gab << '\t' << ref_inthash
+       << '\t' << setprecision(2) << 1.0 << '\t' << 1.0 << endl;
+
+  for (HashKernel::Level level: { HashKernel::SCALAR, HashKernel::AVX2, HashKernel::AVX512 }) {
+    if (level > HashKernel::bestLevel()) {
+      continue;
+    }
+    uint64_t checksum;
+    const double gab = measure([&]() {
+      return run(words, [&](const uint64_t *in, size_t n, uint64_t *out) {
+        HashKernel::gab(in, n, out, a, b, k, mask, level);
+      });
+    }, nb_words, checksum);
+    if (checksum != gab_checksum) {
+      cerr << "Unexpected GaB hash values." << endl;
+      return 1;
+    }
+    const double inthash = measure([&]() {
+      return run(words, [&](const uint64_t *in, size_t n, uint64_t *out) {
+        HashKernel::intHash(in, n, out, mask, level);
+      });
+    }, nb_words, checksum);
+    if (checksum != inthash_checksum) {
+      cerr << "Unexpected IntHash values." << endl;
+      return 1;
+    }
+    cout << HashKernel::level2string(level)
+         << '\t' << setprecision(1) << gab << '\t' << inthash
+         << '\t' << setprecision(2) << (gab / ref_gab) << '\t' << (inthash / ref_inthash) << endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,194 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "locker.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+/*
+ * Throughput comparison between the busy-waiting reader-writer lock
+ * (formerly used by the sub-indexes), the parking one and the
+ * distributed one as the number of threads grows (beyond the number
+ * of cores) for several ratios of read accesses.
+ *
+ * Usage: bench_locker [<nb_accesses_per_thread> [<max_threads>]]
+ */
+
+/*
+ * The busy-waiting reader-writer lock formerly used by the
+ * sub-indexes (kept here for comparison purpose only). Waiting
+ * threads spin without any backoff and are never parked, thus
+ * oversubscribed runs waste whole cores.
+ */
+class SpinReadWriteLock {
+
+private:
+
+  SpinlockMutex _mutex;
+  atomic_bool _writer;
+  atomic_size_t _nb_readers;
+  atomic_size_t _nb_pending_readers;
+  atomic_size_t _nb_pending_writers;
+
+public:
+
+  SpinReadWriteLock():
+    _mutex(),
+    _writer(false), _nb_readers(0),
+    _nb_pending_readers(0), _nb_pending_writers(0)
+  {}
+
+  void requestReadAccess() {
+    ++_nb_pending_readers;
+    // Give priority to pending writers (while they are the most abundant)
+    while (_nb_pending_writers.load() > _nb_pending_readers.load());
+    _mutex.lock();
+    while (_writer.load()); // wait until no more writer is working
+    ++_nb_readers;
+    --_nb_pending_readers;
+    _mutex.unlock();
+  }
+
+  void releaseReadAccess() {
+    --_nb_readers;
+  }
+
+  void requestWriteAccess() {
+    ++_nb_pending_writers;
+    // Give priority to pending readers (while they are the most abundant)
+    while (_nb_pending_readers.load() > _nb_pending_writers.load());
+    _mutex.lock();
+    // wait for readers to end their tasks
+    while (_nb_readers.load() > 0);
+    // wait for writers to end their tasks
+    while (_writer.exchange(true, memory_order_acquire));
+    --_nb_pending_writers;
+    _mutex.unlock();
+  }
+
+  void releaseWriteAccess() {
+    _writer.store(false, memory_order_release);
+  }
+
+};
+
+template <typename Lock>
+double run(size_t nb_threads, size_t nb_accesses, unsigned int read_percent) {
+
+  Lock lock;
+  // Some tiny shared data (as a sub-index lookup or insertion would do).
+  volatile size_t data[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  atomic_size_t checksum(0);
+  vector<thread> threads;
+  threads.reserve(nb_threads);
+
+  auto start = chrono::steady_clock::now();
+
+  for (size_t t = 0; t < nb_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      size_t nb = 0;
+      // Cheap deterministic pseudo random generator.
+      uint32_t x = 2463534242u + t;
+      for (size_t i = 0; i < nb_accesses; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        if ((x % 100) < read_percent) {
+          lock.requestReadAccess();
+          nb += data[x & 7];
+          lock.releaseReadAccess();
+        } else {
+          lock.requestWriteAccess();
+          data[x & 7] = data[x & 7] + 1;
+          lock.releaseWriteAccess();
+        }
+      }
+      checksum += nb;
+    });
+  }
+
+  for (auto &t: threads) {
+    t.join();
+  }
+
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+  // Millions of lock accesses per second.
+  return (nb_threads * nb_accesses) / elapsed.count() / 1e6;
+
+}
+
+int main(int argc, char **argv) {
+
+  size_t nb_accesses = (argc > 1) ? strtoul(argv[1], NULL, 10) : 100000;
+  size_t max_threads = (argc > 2) ? strtoul(argv[2], NULL, 10) : 2 * thread::hardware_concurrency();
+
+  cout << "# " << nb_accesses << " lock accesses per thread"
+       << " (" << thread::hardware_concurrency() << " hardware threads)" << endl;
+  cout << "#Threads\tRead(%)\tSpin(Macc/s)\tParking(Macc/s)\tDistributed(Macc/s)\tSpeedup(Parking)\tSpeedup(Distributed)" << endl;
+  for (unsigned int read_percent: { 50u, 90u, 99u }) {
+    for (size_t t = 1; t <= max_threads; t <<= 1) {
+      double t_spin = run<SpinReadWriteLock>(t, nb_accesses, read_percent);
+      double t_park = run<ReadWriteLock>(t, nb_accesses, read_percent);
+      double t_dist = run<DistributedReadWriteLock>(t, nb_accesses, read_percent);
+      cout << t << '\t' << read_percent
+           << '\t' << fixed << setprecision(3) << t_spin
+           << '\t' << t_park
+           << '\t' << t_dist
+           << '\t' << (t_park / t_spin)
+           << '\t' << (t_dist / t_spin) << endl;
+    }
+  }
+
+  return 0;
+}
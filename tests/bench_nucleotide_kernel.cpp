@@ -0,0 +1,216 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef RESOURCES_DIR
+#  define RESOURCES_DIR "../resources/"
+#endif
+
+#include "nucleotide_kernel.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+/*
+ * Throughput comparison between the former character by character
+ * validation and encoding (a switch per symbol) and the nucleotide
+ * kernel implementations, both on large blocks and on k-mers (as
+ * done by the transformers), using the sequences of the
+ * resources/example*.fa files (scaled up).
+ *
+ * Usage: bench_nucleotide_kernel [<size_in_MB> [<k>]]
+ */
+
+string load_sequences(size_t size) {
+  string content;
+  for (const char *fname: { "example1.fa", "example2.fa" }) {
+    ifstream ifs(string(RESOURCES_DIR) + fname);
+    string line;
+    while (getline(ifs, line)) {
+      if (!line.empty() && (line[0] != '>') && (line[0] != ';')) {
+        content += line;
+      }
+    }
+  }
+  string sequences;
+  sequences.reserve(size + content.size());
+  while (sequences.size() < size) {
+    sequences += content;
+  }
+  sequences.resize(size);
+  return sequences;
+}
+
+// The former implementation (see Transformer::_encode()).
+size_t switch_encode(const char *bases, size_t n, uint64_t *packed, uint64_t *invalid) {
+  size_t nb_invalid = 0;
+  uint64_t p = 0, m = 0;
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t v = 0;
+    switch (bases[i]) {
+    case 'A': v = 0; break;
+    case 'C': v = 1; break;
+    case 'G': v = 2; break;
+    case 'T': v = 3; break;
+    default:
+      m |= 1ull << (i & 63);
+      ++nb_invalid;
+    }
+    p = (p << 2) | v;
+    if ((i & 31) == 31) {
+      *packed++ = p;
+      p = 0;
+    }
+    if ((i & 63) == 63) {
+      *invalid++ = m;
+      m = 0;
+    }
+  }
+  if (n & 31) {
+    *packed = p;
+  }
+  if (n & 63) {
+    *invalid = m;
+  }
+  return nb_invalid;
+}
+
+uint64_t switch_encode_kmer(const char *bases, size_t k, bool &ok) {
+  uint64_t p = 0;
+  for (size_t i = 0; i < k; ++i) {
+    uint64_t v = 0;
+    switch (bases[i]) {
+    case 'A': v = 0; break;
+    case 'C': v = 1; break;
+    case 'G': v = 2; break;
+    case 'T': v = 3; break;
+    default: ok = false;
+    }
+    p = (p << 2) | v;
+  }
+  return p;
+}
+
+template <typename F>
+double measure(F f, size_t nb_bytes, uint64_t &checksum) {
+  auto start = chrono::steady_clock::now();
+  checksum = f();
+  chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  // Millions of nucleotides per second.
+  return nb_bytes / elapsed.count() / 1e6;
+}
+
+int main(int argc, char **argv) {
+
+  const size_t size = ((argc > 1) ? strtoul(argv[1], NULL, 10) : 64) << 20;
+  const size_t k = (argc > 2) ? strtoul(argv[2], NULL, 10) : 31;
+  if ((k == 0) || (k > 32)) {
+    cerr << "The k-mer length must be between 1 and 32." << endl;
+    return 1;
+  }
+
+  const string sequences = load_sequences(size);
+  vector<uint64_t> packed((size + 31) / 32), invalid((size + 63) / 64);
+
+  cout << "# " << (size >> 20) << "MB of nucleotides, k = " << k
+       << " (best available implementation: " << NucleotideKernel::level2string(NucleotideKernel::bestLevel()) << ")" << endl;
+  cout << "#Implementation\tBlocks(Mnt/s)\tK-mers(Mnt/s)\tSpeedup(Blocks)\tSpeedup(K-mers)" << endl;
+
+  uint64_t block_checksum, kmer_checksum;
+  const double ref_blocks = measure([&]() {
+    return switch_encode(sequences.data(), size, packed.data(), invalid.data());
+  }, size, block_checksum);
+  const double ref_kmers = measure([&]() {
+    uint64_t sum = 0;
+    for (size_t i = 0; i + k <= size; i += k) {
+      bool ok = true;
+      const uint64_t v = switch_encode_kmer(sequences.data() + i, k, ok);
+      sum += ok ? v : 0;
+    }
+    return sum;
+  }, size, kmer_checksum);
+  cout << "switch" << '\t' << fixed << setprecision(1) << ref_blocks << '\t' << ref_kmers
+       << '\t' << setprecision(2) << 1.0 << '\t' << 1.0 << endl;
+
+  for (NucleotideKernel::Level level: { NucleotideKernel::SCALAR, NucleotideKernel::SSE4, NucleotideKernel::AVX2 }) {
+    if (level > NucleotideKernel::bestLevel()) {
+      continue;
+    }
+    uint64_t checksum;
+    const double blocks = measure([&]() {
+      return NucleotideKernel::encode(sequences.data(), size, packed.data(), invalid.data(),
+                                      NucleotideKernel::UPPER_ACGT, level);
+    }, size, checksum);
+    if (checksum != block_checksum) {
+      cerr << "Unexpected number of invalid symbols." << endl;
+      return 1;
+    }
+    const double kmers = measure([&]() {
+      uint64_t sum = 0;
+      for (size_t i = 0; i + k <= size; i += k) {
+        const char *kmer = sequences.data() + i;
+        sum += NucleotideKernel::invalidMask(kmer, k, NucleotideKernel::UPPER_ACGT, level)
+          ? 0
+          : NucleotideKernel::pack(kmer, k, level);
+      }
+      return sum;
+    }, size, checksum);
+    if (checksum != kmer_checksum) {
+      cerr << "Unexpected k-mer encodings." << endl;
+      return 1;
+    }
+    cout << NucleotideKernel::level2string(level)
+         << '\t' << setprecision(1) << blocks << '\t' << kmers
+         << '\t' << setprecision(2) << (blocks / ref_blocks) << '\t' << (kmers / ref_kmers) << endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,263 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "circular_queue.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+void test_sequential() {
+
+  cout << "*** Sequential test ***" << endl << endl;
+
+  CircularQueue<size_t> q1(1);
+  cout << "Queue of capacity 1 has capacity " << q1.capacity << " (expecting 2)" << endl;
+  assert(q1.capacity == 2);
+
+  CircularQueue<size_t> q(5);
+  cout << "Queue of capacity 5 has capacity " << q.capacity << " (expecting 8)" << endl;
+  assert(q.capacity == 8);
+  assert(q.empty());
+  assert(!q.full());
+
+  size_t v;
+  assert(!q.pop(v));
+
+  for (size_t round = 0; round < 3; ++round) {
+    for (size_t i = 0; i < q.capacity; ++i) {
+      assert(q.size() == i);
+      assert(q.push(round * 100 + i));
+    }
+    cout << "Round " << round << ": queue is " << (q.full() ? "" : "not ") << "full (expecting full)" << endl;
+    assert(q.full());
+    assert(!q.push(0));
+    assert(!q.emplace(0));
+    for (size_t i = 0; i < q.capacity; ++i) {
+      assert(q.pop(v));
+      assert(v == round * 100 + i);
+    }
+    cout << "Round " << round << ": queue is " << (q.empty() ? "" : "not ") << "empty (expecting empty)" << endl;
+    assert(q.empty());
+    assert(!q.pop(v));
+  }
+  cout << endl;
+
+}
+
+void test_concurrent(size_t nb_producers, size_t nb_consumers, size_t nb_values) {
+
+  cout << "*** Concurrent test with " << nb_producers << " producer(s) and "
+       << nb_consumers << " consumer(s) ***" << endl;
+
+  CircularQueue<size_t> q(64);
+  atomic_size_t running_producers(nb_producers);
+  vector<vector<size_t> > popped(nb_consumers);
+  vector<thread> threads;
+
+  for (size_t p = 0; p < nb_producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (size_t i = 0; i < nb_values; ++i) {
+        while (!q.push(p * nb_values + i)) {
+          this_thread::yield();
+        }
+      }
+      --running_producers;
+    });
+  }
+
+  for (size_t c = 0; c < nb_consumers; ++c) {
+    threads.emplace_back([&, c]() {
+      size_t v;
+      while ((running_producers > 0) || !q.empty()) {
+        if (q.pop(v)) {
+          popped[c].push_back(v);
+        } else {
+          this_thread::yield();
+        }
+      }
+    });
+  }
+
+  for (auto &t: threads) {
+    t.join();
+  }
+
+  // Each value must be popped exactly once and the values pushed by
+  // some producer must be popped in order by each consumer.
+  vector<bool> seen(nb_producers * nb_values, false);
+  size_t nb = 0;
+  for (auto &values: popped) {
+    vector<size_t> last(nb_producers, 0);
+    vector<bool> first(nb_producers, true);
+    for (size_t v: values) {
+      assert(v < seen.size());
+      assert(!seen[v]);
+      seen[v] = true;
+      size_t p = v / nb_values;
+      assert(first[p] || (last[p] < v));
+      first[p] = false;
+      last[p] = v;
+      ++nb;
+    }
+  }
+  cout << "Number of popped values: " << nb << " (expecting " << seen.size() << ")" << endl << endl;
+  assert(nb == seen.size());
+  assert(q.empty());
+
+}
+
+void test_blocking(size_t nb_producers, size_t nb_consumers, size_t nb_values) {
+
+  cout << "*** Blocking test with " << nb_producers << " producer(s) and "
+       << nb_consumers << " consumer(s) ***" << endl;
+
+  // A tiny queue makes both producers and consumers wait.
+  CircularQueue<size_t> q(2);
+  atomic_size_t nb_popped(0), sum(0);
+  vector<thread> producers, consumers;
+
+  for (size_t c = 0; c < nb_consumers; ++c) {
+    consumers.emplace_back([&]() {
+      size_t v;
+      while (q.waitPop(v)) {
+        ++nb_popped;
+        sum += v;
+      }
+    });
+  }
+
+  for (size_t p = 0; p < nb_producers; ++p) {
+    producers.emplace_back([&, p]() {
+      for (size_t i = 0; i < nb_values; ++i) {
+        size_t v = p * nb_values + i;
+        if (p & 1) {
+          assert(q.waitPush(v));
+        } else {
+          assert(q.waitEmplace(std::move(v)));
+        }
+      }
+    });
+  }
+
+  for (auto &t: producers) {
+    t.join();
+  }
+  assert(!q.closed());
+  q.close();
+  assert(q.closed());
+  for (auto &t: consumers) {
+    t.join();
+  }
+
+  const size_t n = nb_producers * nb_values;
+  cout << "Number of popped values: " << nb_popped << " (expecting " << n << ")" << endl;
+  assert(nb_popped == n);
+  assert(sum == n * (n - 1) / 2);
+  assert(q.empty());
+
+  // Once closed and empty, nothing can be popped anymore.
+  size_t v = 0;
+  assert(!q.waitPop(v));
+
+  // Producers waiting for room in a closed queue give up.
+  CircularQueue<size_t> full_queue(2);
+  while (full_queue.push(v));
+  full_queue.close();
+  assert(!full_queue.waitPush(v));
+  assert(!full_queue.waitEmplace(std::move(v)));
+  assert(full_queue.waitPop(v) && full_queue.waitPop(v));
+  assert(!full_queue.waitPop(v));
+  cout << "Closed queue doesn't block anymore" << endl << endl;
+
+}
+
+void test_wake_up_on_close() {
+
+  cout << "*** Waiting consumers are woken up when closing the queue ***" << endl;
+
+  CircularQueue<size_t> q(4);
+  atomic_size_t nb_done(0);
+  vector<thread> consumers;
+  for (size_t c = 0; c < 4; ++c) {
+    consumers.emplace_back([&]() {
+      size_t v;
+      assert(!q.waitPop(v));
+      ++nb_done;
+    });
+  }
+  this_thread::sleep_for(chrono::milliseconds(10));
+  assert(nb_done == 0);
+  q.close();
+  for (auto &t: consumers) {
+    t.join();
+  }
+  cout << "Number of woken up consumers: " << nb_done << " (expecting 4)" << endl << endl;
+  assert(nb_done == 4);
+
+}
+
+int main() {
+
+  test_sequential();
+
+  for (size_t p = 1; p <= 4; p <<= 1) {
+    for (size_t c = 1; c <= 4; c <<= 1) {
+      test_concurrent(p, c, 20000);
+      test_blocking(p, c, 5000);
+    }
+  }
+
+  test_wake_up_on_close();
+
+  return 0;
+}
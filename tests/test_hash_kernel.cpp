@@ -0,0 +1,162 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "hash_kernel.hpp"
+
+// The scalar IntHash functions (hash_64() and hash_64i()) are both
+// used by the kernel and as reference.
+#include "inthash.c"
+
+using namespace std;
+using namespace bijecthash;
+
+/*
+ * Reference (word by word) implementation of the GaB function.
+ */
+
+uint64_t gab(uint64_t s, uint64_t a, uint64_t b, size_t rotation, uint64_t mask) {
+  const uint64_t rotated = ((s << rotation) | (s >> rotation)) & mask;
+  return (a * (rotated ^ b)) & mask;
+}
+
+// The inverse of some odd value modulo 2^64 (Newton's iterations,
+// each one doubles the number of correct bits).
+uint64_t inverse(uint64_t a) {
+  uint64_t x = a;
+  for (size_t i = 0; i < 5; ++i) {
+    x *= 2 - a * x;
+  }
+  assert(a * x == 1);
+  return x;
+}
+
+vector<HashKernel::Level> supported_levels() {
+  vector<HashKernel::Level> levels;
+  for (HashKernel::Level level: { HashKernel::SCALAR, HashKernel::AVX2, HashKernel::AVX512 }) {
+    if (level <= HashKernel::bestLevel()) {
+      levels.push_back(level);
+    }
+  }
+  return levels;
+}
+
+void test_hashes(const vector<uint64_t> &words, size_t rotation, uint64_t mask, uint64_t a, uint64_t b) {
+  const size_t n = words.size();
+  const uint64_t rev_a = inverse(a) & mask;
+  vector<uint64_t> hashed(n), unhashed(n), in_place;
+  for (HashKernel::Level level: supported_levels()) {
+
+    HashKernel::gab(words.data(), n, hashed.data(), a, b, rotation, mask, level);
+    for (size_t i = 0; i < n; ++i) {
+      assert(hashed[i] == gab(words[i], a, b, rotation, mask));
+    }
+    HashKernel::gabInverse(hashed.data(), n, unhashed.data(), rev_a, b, rotation, mask, level);
+    assert(unhashed == words);
+    in_place = words;
+    HashKernel::gab(in_place.data(), n, in_place.data(), a, b, rotation, mask, level);
+    assert(in_place == hashed);
+    HashKernel::gabInverse(in_place.data(), n, in_place.data(), rev_a, b, rotation, mask, level);
+    assert(in_place == words);
+
+    HashKernel::intHash(words.data(), n, hashed.data(), mask, level);
+    for (size_t i = 0; i < n; ++i) {
+      assert(hashed[i] == hash_64(words[i], mask));
+    }
+    HashKernel::intHashInverse(hashed.data(), n, unhashed.data(), mask, level);
+    assert(unhashed == words);
+    in_place = words;
+    HashKernel::intHash(in_place.data(), n, in_place.data(), mask, level);
+    assert(in_place == hashed);
+    HashKernel::intHashInverse(in_place.data(), n, in_place.data(), mask, level);
+    assert(in_place == words);
+  }
+}
+
+int main() {
+
+  cout << "Best available implementation: "
+       << HashKernel::level2string(HashKernel::bestLevel()) << endl << endl;
+
+  // Cheap deterministic pseudo random generator.
+  uint64_t x = 88172645463325252ull;
+  auto next_random = [&x]() {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+  };
+
+  // The GaB transformer hashes 2k bits words (rotated by k bits) for
+  // k <= 32. The word counts include tails which are not multiple of
+  // the vector widths.
+  size_t nb = 0;
+  for (size_t k = 1; k <= 32; ++k) {
+    const uint64_t mask = (k == 32) ? uint64_t(-1) : ((1ull << (2 * k)) - 1);
+    for (size_t n: { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1000 }) {
+      vector<uint64_t> words(n);
+      for (uint64_t &w: words) {
+        w = next_random() & mask;
+      }
+      // Some extreme values.
+      if (n > 1) {
+        words[0] = 0;
+        words[n - 1] = mask;
+      }
+      for (uint64_t a: { uint64_t(1), uint64_t(12345), next_random() | 1, uint64_t(-1) }) {
+        test_hashes(words, k, mask, a, next_random() & mask);
+        ++nb;
+      }
+    }
+  }
+  cout << "All the implementations give the expected results (" << nb << " batches)." << endl;
+
+  return 0;
+}
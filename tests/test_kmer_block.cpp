@@ -0,0 +1,124 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "kmer_block.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+string randomKmer(size_t k) {
+  string kmer(k, '?');
+  for (auto &c: kmer) {
+    c = "ACGT"[rand() & 3];
+  }
+  return kmer;
+}
+
+void test_kmer_block(size_t k, size_t capacity) {
+
+  cout << "Test of a block of " << capacity << " " << k << "-mers" << endl;
+
+  KmerBlock block(k, capacity);
+  assert(block.k() == k);
+  assert(block.capacity() == capacity);
+  assert(block.empty());
+  assert(!block.full());
+
+  vector<string> kmers;
+  for (size_t i = 0; i < capacity; ++i) {
+    kmers.push_back(randomKmer(k));
+    block.add(kmers.back());
+    assert(block.size() == i + 1);
+  }
+  assert(block.full());
+
+  // The encoding must be the one of the transformers for the first word.
+  uint64_t expected = 0;
+  for (size_t i = 0; (i < k) && (i < 32); ++i) {
+    expected = (expected << 2) | string("ACGT").find(kmers[0][i]);
+  }
+  assert(block.word(0) == expected);
+
+  // Moving the block (as the queue does) must preserve its content.
+  KmerBlock moved(std::move(block));
+  string kmer;
+  for (size_t i = 0; i < capacity; ++i) {
+    moved.get(i, kmer);
+    assert(kmer == kmers[i]);
+  }
+
+  // The moved block must be reusable once cleared.
+  block.clear();
+  assert(block.empty());
+  string u_kmer = kmers[0];
+  for (auto &c: u_kmer) {
+    if (c == 'T') c = 'U';
+  }
+  block.add(u_kmer);
+  block.get(0, kmer);
+  assert(kmer == kmers[0]);
+
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+int main() {
+
+  srand(42);
+  for (size_t k: { 1, 5, 21, 31, 32, 33, 45, 64, 65 }) {
+    test_kmer_block(k, 1);
+    test_kmer_block(k, 100);
+  }
+  return 0;
+
+}
@@ -0,0 +1,193 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef PLUGINS_DIR
+#  define PLUGINS_DIR "../src/transformers/"
+#endif
+
+#include "bh_kmer_index.hpp"
+#include "exception.hpp"
+#include "settings.hpp"
+#include "transformer.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+const string tmp_fname = "test_kmer_index.tmp";
+
+// The offsets of the index file header fields (see BhKmerIndex::save()).
+const size_t nb_kmers_offset = 32;
+const size_t method_length_offset = 40;
+const size_t description_length_offset = 48;
+const size_t header_size = 56;
+
+uint64_t read_field(const string &content, size_t offset) {
+  uint64_t v;
+  memcpy(&v, content.data() + offset, sizeof(v));
+  return v;
+}
+
+void write_field(string &content, size_t offset, uint64_t v) {
+  memcpy(&content[offset], &v, sizeof(v));
+}
+
+// Check that loading the given (corrupted) index file content throws
+// an exception.
+void check_corrupted(const Settings &s, const string &content, const string &what) {
+  ofstream(tmp_fname, ios::binary) << content;
+  bool thrown = false;
+  try {
+    BhKmerIndex index(s, tmp_fname);
+  } catch (const Exception &e) {
+    cout << "- " << what << ": " << e.what();
+    thrown = true;
+  }
+  if (!thrown) {
+    cerr << "The index file having " << what << " was loaded." << endl;
+  }
+  assert(thrown);
+}
+
+void test_index_file(size_t k, size_t p, size_t nb_kmers) {
+
+  cout << "*** Test of the index file of " << nb_kmers << " " << k << "-mers using prefix length " << p << " ***" << endl;
+
+  Settings s(k, p, "identity-check");
+  s.verbose = false;
+  assert(s.setMethod("identity-check"));
+
+  // Cheap deterministic pseudo random generator.
+  uint64_t x = 88172645463325252ull;
+  const uint64_t mask = (1ull << (2 * k)) - 1;
+  vector<uint64_t> kmers(nb_kmers);
+  BhKmerIndex index(s);
+  for (uint64_t &kmer: kmers) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    kmer = x & mask;
+    index.insert(kmer);
+  }
+  index.freeze();
+  index.save(tmp_fname);
+
+  ifstream ifs(tmp_fname, ios::binary);
+  const string content((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+  ifs.close();
+
+  {
+    BhKmerIndex loaded(s, tmp_fname);
+    assert(loaded.size() == index.size());
+    for (uint64_t kmer: kmers) {
+      assert(loaded.contains(kmer));
+    }
+  }
+
+  const size_t nb_subindexes = 1ul << (2 * p);
+  const uint64_t size = read_field(content, nb_kmers_offset);
+  const size_t strings_size = read_field(content, method_length_offset) + read_field(content, description_length_offset);
+  const size_t offsets_offset = header_size + ((strings_size + 7) & ~size_t(7));
+  auto offset = [&](size_t i) {
+    return offsets_offset + i * sizeof(uint64_t);
+  };
+  string corrupted;
+
+  corrupted = content.substr(0, content.size() - 1);
+  check_corrupted(s, corrupted, "a truncated file");
+
+  corrupted = content;
+  write_field(corrupted, method_length_offset, uint64_t(-8));
+  check_corrupted(s, corrupted, "a huge method length");
+
+  // The expected file size is the same modulo 2^64.
+  corrupted = content;
+  write_field(corrupted, nb_kmers_offset, size + (1ull << 61));
+  check_corrupted(s, corrupted, "an overflowing number of k-mers");
+
+  corrupted = content;
+  write_field(corrupted, offset(0), 1);
+  check_corrupted(s, corrupted, "a non zero first offset");
+
+  corrupted = content;
+  write_field(corrupted, offset(nb_subindexes), size - 1);
+  check_corrupted(s, corrupted, "a last offset differing from the number of k-mers");
+
+  corrupted = content;
+  write_field(corrupted, offset(nb_subindexes / 2), size + 1);
+  check_corrupted(s, corrupted, "an offset beyond the number of k-mers");
+
+  corrupted = content;
+  write_field(corrupted, offset(nb_subindexes / 2), read_field(content, offset(nb_subindexes / 2 - 1)) - 1);
+  check_corrupted(s, corrupted, "decreasing offsets");
+
+  remove(tmp_fname.c_str());
+  cout << endl;
+
+}
+
+int main() {
+
+  // The identity transformer is provided by the basic plugin compiled
+  // with assertion checkings.
+  const bool loaded = Transformer::addPlugin(PLUGINS_DIR "basic/.libs/kmer-transformers-basic-plugin-debug.so");
+  assert(loaded);
+
+  test_index_file(15, 3, 1000);
+  test_index_file(21, 5, 10000);
+  test_index_file(31, 1, 100);
+
+  return 0;
+}
@@ -44,16 +44,29 @@
 #ifdef NDEBUG
 #  undef NDEBUG
 #endif
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <sys/stat.h>
 
 #ifndef RESOURCES_DIR
 #  define RESOURCES_DIR "../resources/"
 #endif
 
+#include "common.hpp"
+#include "decompressor.hpp"
+#include "exception.hpp"
 #include "file_reader.hpp"
+#include "mapped_file_reader.hpp"
+
+#ifdef HAVE_ZLIB
+#  include <zlib.h>
+#endif
 
 using namespace std;
 using namespace bijecthash;
@@ -72,8 +85,9 @@ ostream &operator<<(ostream &os, FileReader::Format f) {
   return os;
 }
 
+template <typename Reader>
 struct FileReaderTester {
-  FileReader &reader;
+  Reader &reader;
   bool expected_open_status;
   string expected_filename;
   size_t expected_line_number;
@@ -84,7 +98,7 @@ struct FileReaderTester {
   size_t expected_kmer_id;
   string expected_kmer;
 
-  FileReaderTester(FileReader &r):
+  FileReaderTester(Reader &r):
     reader(r),
     expected_open_status(false),
     expected_filename(),
@@ -174,10 +188,13 @@ struct FileReaderTester {
 
 };
 
-int main() {
+template <typename Reader>
+void test_reader(const string &reader_name) {
+
+  cout << "===== Tests of the " << reader_name << " =====" << endl << endl;
 
-  FileReader reader(5);
-  FileReaderTester t(reader);
+  Reader reader(5);
+  FileReaderTester<Reader> t(reader);
 
 
   //////////////////////////////
@@ -528,5 +545,287 @@ int main() {
 
   cout << "End of file '" << fname << "'" << endl << endl;
 
+}
+
+uint64_t pack(const string &kmer) {
+  uint64_t v = 0;
+  for (char c: kmer) {
+    v = (v << 2) | FileReader::encodeNucleotide(c);
+  }
+  return v;
+}
+
+void compare_readers(const string &fname, size_t k) {
+  cout << "*** Comparison of both readers on file '" << fname << "' for k = " << k << " ***" << endl;
+  FileReader reader(k, fname, false);
+  MappedFileReader mapped_reader(k, fname, false);
+  assert(reader.isOpen() == mapped_reader.isOpen());
+  assert(reader.getFormat() == mapped_reader.getFormat());
+  size_t nb = 0;
+  bool ok;
+  do {
+    ok = reader.nextKmer();
+    assert(mapped_reader.nextKmer() == ok);
+    assert(reader.getCurrentKmer() == mapped_reader.getCurrentKmerView());
+    assert(reader.getCurrentKmerID() == mapped_reader.getCurrentKmerID());
+    assert(reader.getCurrentKmerID(false) == mapped_reader.getCurrentKmerID(false));
+    assert(reader.getCurrentSequenceDescription() == mapped_reader.getCurrentSequenceDescription());
+    assert(reader.getLineNumber() == mapped_reader.getLineNumber());
+    assert(reader.getColumnNumber() == mapped_reader.getColumnNumber());
+    if (ok && (k <= 32)) {
+      const string &kmer = reader.getCurrentKmer();
+      assert(reader.getCurrentKmerPacked() == pack(kmer));
+      assert(mapped_reader.getCurrentKmerPacked() == pack(kmer));
+    }
+    nb += ok;
+  } while (ok);
+  cout << "Both readers extracted the same " << nb << " k-mers." << endl << endl;
+}
+
+void compare_chunks(const string &fname, size_t k, size_t nb_chunks) {
+  cout << "*** Comparison of the whole file '" << fname << "' with its " << nb_chunks << " chunks for k = " << k << " ***" << endl;
+  MappedFileReader reader(k, fname, false);
+  assert(reader.isOpen());
+  struct stat st;
+  assert(stat(fname.c_str(), &st) == 0);
+  const size_t size = st.st_size;
+  size_t nb = 0;
+  size_t nb_kmer_ids = 0;
+  size_t expected_chunk_begin = 0;
+  for (size_t i = 0; i < nb_chunks; ++i) {
+    MappedFileReader chunk_reader(k, "", false);
+    assert(chunk_reader.open(fname, size * i / nb_chunks, size * (i + 1) / nb_chunks));
+    assert(chunk_reader.getFormat() == reader.getFormat());
+    // The chunks are a partition of the file.
+    assert(chunk_reader.getChunkBegin() == expected_chunk_begin);
+    expected_chunk_begin = chunk_reader.getChunkEnd();
+    while (chunk_reader.nextKmer()) {
+      assert(reader.nextKmer());
+      assert(reader.getCurrentKmerView() == chunk_reader.getCurrentKmerView());
+      // The absolute IDs are fixed up using the number of k-mer IDs
+      // of the previous chunks.
+      assert(reader.getCurrentKmerID() == nb_kmer_ids + chunk_reader.getCurrentKmerID());
+      assert(reader.getCurrentKmerID(false) == chunk_reader.getCurrentKmerID(false));
+      assert(reader.getCurrentSequenceDescription() == chunk_reader.getCurrentSequenceDescription());
+      assert(reader.getLineNumber() == chunk_reader.getLineNumber());
+      assert(reader.getColumnNumber() == chunk_reader.getColumnNumber());
+      if (k <= 32) {
+        assert(reader.getCurrentKmerPacked() == chunk_reader.getCurrentKmerPacked());
+      }
+      ++nb;
+    }
+    nb_kmer_ids += chunk_reader.getNbKmerIDs();
+  }
+  assert(expected_chunk_begin == size);
+  assert(!reader.nextKmer());
+  assert(reader.getNbKmerIDs() == nb_kmer_ids);
+  cout << "The chunks have the same " << nb << " k-mers than the whole file." << endl << endl;
+}
+
+#ifdef HAVE_ZLIB
+string read_file(const string &fname) {
+  ifstream ifs(fname, ios::binary);
+  ostringstream oss;
+  oss << ifs.rdbuf();
+  return oss.str();
+}
+
+// Append the given content as a single gzip member (if bgzf is true,
+// the member is a BGZF one, thus content must be small enough).
+void write_gzip_member(FILE *f, const char *data, size_t size, bool bgzf) {
+  z_stream zs = z_stream();
+  assert(deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+  string compressed(deflateBound(&zs, size), '\0');
+  zs.next_in = (Bytef *) data;
+  zs.avail_in = size;
+  zs.next_out = (Bytef *) &compressed[0];
+  zs.avail_out = compressed.size();
+  assert(deflate(&zs, Z_FINISH) == Z_STREAM_END);
+  compressed.resize(zs.total_out);
+  deflateEnd(&zs);
+  unsigned char header[18] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+  size_t header_size = 10;
+  if (bgzf) {
+    const size_t bsize = 18 + compressed.size() + 8 - 1;
+    assert(bsize < 65536);
+    const unsigned char extra[8] = { 6, 0, 'B', 'C', 2, 0, (unsigned char) (bsize & 0xFF), (unsigned char) (bsize >> 8) };
+    header[3] = 4;
+    copy(extra, extra + 8, header + 10);
+    header_size = 18;
+  }
+  const uint32_t crc = crc32(0, (const Bytef *) data, size);
+  const unsigned char trailer[8] = {
+    (unsigned char) crc, (unsigned char) (crc >> 8), (unsigned char) (crc >> 16), (unsigned char) (crc >> 24),
+    (unsigned char) size, (unsigned char) (size >> 8), (unsigned char) (size >> 16), (unsigned char) (size >> 24)
+  };
+  fwrite(header, 1, header_size, f);
+  fwrite(compressed.data(), 1, compressed.size(), f);
+  fwrite(trailer, 1, 8, f);
+}
+
+// Write the given content as a gzip file (made of several members) or
+// as a BGZF file.
+void write_compressed(const string &fname, const string &content, Decompressor::Codec codec) {
+  FILE *f = fopen(fname.c_str(), "wb");
+  assert(f);
+  const size_t member_size = (codec == Decompressor::BGZF) ? 60000 : (content.size() / 3 + 1);
+  for (size_t p = 0; p < content.size(); p += member_size) {
+    write_gzip_member(f, content.data() + p, min(member_size, content.size() - p), codec == Decompressor::BGZF);
+  }
+  if (codec == Decompressor::BGZF) {
+    // End of file marker.
+    write_gzip_member(f, NULL, 0, true);
+  }
+  fclose(f);
+}
+
+void compare_compressed(const string &fname, const string &compressed_fname, size_t k, Decompressor::Codec codec,
+                        size_t nb_threads = 1) {
+  cout << "*** Comparison of the file '" << fname << "' with its " << Decompressor::codec2string(codec)
+       << " compressed version for k = " << k << " (using " << nb_threads << " decompression thread(s)) ***" << endl;
+  assert(MappedFileReader::detectCodec(fname) == Decompressor::NONE);
+  assert(MappedFileReader::detectCodec(compressed_fname) == codec);
+  MappedFileReader reader(k, fname, false);
+  MappedFileReader compressed_reader(k, compressed_fname, false);
+  assert(reader.isOpen());
+  assert(compressed_reader.isOpen());
+  assert(compressed_reader.getCodec() == codec);
+  assert(compressed_reader.getNbDecompressionThreads() == 1);
+  compressed_reader.setNbDecompressionThreads(nb_threads);
+  assert(compressed_reader.getNbDecompressionThreads() == nb_threads);
+  assert(compressed_reader.getFormat() == reader.getFormat());
+  size_t nb = 0;
+  while (reader.nextKmer()) {
+    assert(compressed_reader.nextKmer());
+    assert(reader.getCurrentKmerView() == compressed_reader.getCurrentKmerView());
+    assert(reader.getCurrentKmerID() == compressed_reader.getCurrentKmerID());
+    assert(reader.getCurrentKmerID(false) == compressed_reader.getCurrentKmerID(false));
+    assert(reader.getCurrentSequenceDescription() == compressed_reader.getCurrentSequenceDescription());
+    assert(reader.getLineNumber() == compressed_reader.getLineNumber());
+    assert(reader.getColumnNumber() == compressed_reader.getColumnNumber());
+    if (k <= 32) {
+      assert(reader.getCurrentKmerPacked() == compressed_reader.getCurrentKmerPacked());
+    }
+    ++nb;
+  }
+  assert(!compressed_reader.nextKmer());
+  assert(reader.getNbKmerIDs() == compressed_reader.getNbKmerIDs());
+  // Compressed files are not split (the whole content belongs to the
+  // first chunk).
+  struct stat st;
+  assert(stat(compressed_fname.c_str(), &st) == 0);
+  MappedFileReader chunk_reader(k, "", false);
+  assert(chunk_reader.open(compressed_fname, 0, st.st_size / 2));
+  assert(chunk_reader.getChunkBegin() == 0);
+  assert(chunk_reader.getChunkEnd() == size_t(st.st_size));
+  assert(chunk_reader.open(compressed_fname, st.st_size / 2, st.st_size));
+  assert(chunk_reader.getChunkBegin() == size_t(st.st_size));
+  assert(!chunk_reader.nextKmer());
+  cout << "The compressed file has the same " << nb << " k-mers than the original file." << endl << endl;
+}
+
+void test_compressed_files() {
+  const string tmp_fname = "test_kmer_reader.tmp";
+  const string tmp_compressed_fname = "test_kmer_reader.tmp.gz";
+  for (const char *fname: { "example1.fa", "example2.fa", "example1.fq", "example2.fq" }) {
+    const string content = read_file(string(RESOURCES_DIR) + fname);
+    for (Decompressor::Codec codec: { Decompressor::GZIP, Decompressor::BGZF }) {
+      write_compressed(tmp_compressed_fname, content, codec);
+      for (size_t k: { 1, 5, 21, 40 }) {
+        compare_compressed(string(RESOURCES_DIR) + fname, tmp_compressed_fname, k, codec);
+      }
+    }
+  }
+  // Large enough files to be decompressed in several blocks (the
+  // example2.fq file can't be repeated since its trailing read ends
+  // with empty lines which are not separators).
+  for (const char *fname: { "example1.fa", "example2.fa", "example1.fq" }) {
+    const string content = read_file(string(RESOURCES_DIR) + fname);
+    string large_content;
+    while (large_content.size() < 5 * Decompressor::block_size / 2) {
+      large_content += content;
+    }
+    ofstream(tmp_fname, ios::binary) << large_content;
+    for (Decompressor::Codec codec: { Decompressor::GZIP, Decompressor::BGZF }) {
+      write_compressed(tmp_compressed_fname, large_content, codec);
+      for (size_t nb_threads: { 1, 4 }) {
+        compare_compressed(tmp_fname, tmp_compressed_fname, 21, codec, nb_threads);
+      }
+    }
+  }
+  remove(tmp_fname.c_str());
+  remove(tmp_compressed_fname.c_str());
+}
+
+// Check that parsing the given corrupted compressed file throws an
+// exception.
+void check_corrupted(const string &fname, const string &content) {
+  ofstream(fname, ios::binary) << content;
+  MappedFileReader reader(21, fname, false);
+  assert(reader.isOpen());
+  bool thrown = false;
+  try {
+    while (reader.nextKmer());
+  } catch (const Exception &e) {
+    cout << "Expected exception: " << e.what();
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+void test_corrupted_bgzf_files() {
+  cout << "*** Corrupted BGZF files ***" << endl;
+  const string tmp_compressed_fname = "test_kmer_reader.tmp.gz";
+  const string content = read_file(string(RESOURCES_DIR) + "example1.fa");
+  write_compressed(tmp_compressed_fname, content, Decompressor::BGZF);
+  const string compressed = read_file(tmp_compressed_fname);
+  // The first member is followed by the (28 bytes) end of file marker,
+  // thus its CRC32 and its ISIZE are the 8 bytes before.
+  const size_t crc_pos = compressed.size() - 28 - 8;
+  const size_t isize_pos = compressed.size() - 28 - 4;
+  string corrupted = compressed;
+  corrupted[crc_pos] ^= 1;
+  check_corrupted(tmp_compressed_fname, corrupted);
+  corrupted = compressed;
+  corrupted[isize_pos] ^= 1;
+  check_corrupted(tmp_compressed_fname, corrupted);
+  corrupted = compressed;
+  // Corrupt the CRC of the end of file marker (which must be 0).
+  corrupted[compressed.size() - 8] ^= 1;
+  check_corrupted(tmp_compressed_fname, corrupted);
+  remove(tmp_compressed_fname.c_str());
+  cout << endl;
+}
+#endif
+
+int main() {
+
+  test_reader<FileReader>("FileReader");
+  test_reader<MappedFileReader>("MappedFileReader");
+
+  for (const char *fname: { "example1.fa", "example2.fa", "example1.fq", "example2.fq" }) {
+    for (size_t k = 1; k <= 40; ++k) {
+      compare_readers(string(RESOURCES_DIR) + fname, k);
+    }
+  }
+
+  for (const char *fname: { "example1.fa", "example2.fa", "example1.fq", "example2.fq" }) {
+    // Every chunking is checked for the usual k-mer length (the
+    // other ones only use a few chunkings to keep the test short).
+    for (size_t nb_chunks = 1; nb_chunks <= 1000; ++nb_chunks) {
+      compare_chunks(string(RESOURCES_DIR) + fname, 21, nb_chunks);
+    }
+    for (size_t k: { 1, 5, 40 }) {
+      for (size_t nb_chunks: { 1, 2, 3, 7, 16, 100, 1000 }) {
+        compare_chunks(string(RESOURCES_DIR) + fname, k, nb_chunks);
+      }
+    }
+  }
+
+#ifdef HAVE_ZLIB
+  test_compressed_files();
+  test_corrupted_bgzf_files();
+#endif
+
   return 0;
 }
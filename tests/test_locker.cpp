@@ -0,0 +1,172 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "locker.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+void test_backoff() {
+
+  cout << "*** Backoff test ***" << endl << endl;
+
+  Backoff backoff;
+  size_t nb = 0;
+  while (backoff.spin()) {
+    ++nb;
+  }
+  cout << "Backoff has spinned " << nb << " times before advising to park"
+       << " (expecting " << (Backoff::spin_rounds + Backoff::yield_rounds) << ")" << endl;
+  assert(nb == Backoff::spin_rounds + Backoff::yield_rounds);
+  assert(!backoff.spin());
+  backoff.reset();
+  assert(backoff.spin());
+  cout << endl;
+
+}
+
+template <typename Lock>
+void test_sequential(const string &name) {
+
+  cout << "*** Sequential test of the " << name << " ***" << endl << endl;
+
+  Lock lock;
+  for (size_t i = 0; i < 3; ++i) {
+    lock.requestReadAccess();
+    lock.requestReadAccess();
+    lock.releaseReadAccess();
+    lock.releaseReadAccess();
+    lock.requestWriteAccess();
+    lock.releaseWriteAccess();
+  }
+  cout << "The lock can be acquired and released several times." << endl << endl;
+
+}
+
+template <typename Lock>
+void test_concurrent(const string &name, size_t nb_readers, size_t nb_writers, size_t nb_iterations) {
+
+  cout << "*** Concurrent test of the " << name << " with "
+       << nb_readers << " reader(s) and " << nb_writers << " writer(s) ***" << endl;
+
+  Lock lock;
+  // The writers keep both values equal (outside of the critical
+  // section) and must be alone, the readers must see equal values.
+  size_t a = 0, b = 0;
+  atomic_size_t nb_inside_writers(0);
+  atomic_size_t nb_inside_readers(0);
+  atomic_size_t nb_errors(0);
+  vector<thread> threads;
+
+  for (size_t w = 0; w < nb_writers; ++w) {
+    threads.emplace_back([&]() {
+      for (size_t i = 0; i < nb_iterations; ++i) {
+        lock.requestWriteAccess();
+        if ((++nb_inside_writers != 1) || (nb_inside_readers != 0)) {
+          ++nb_errors;
+        }
+        ++a;
+        this_thread::yield();
+        ++b;
+        --nb_inside_writers;
+        lock.releaseWriteAccess();
+      }
+    });
+  }
+
+  for (size_t r = 0; r < nb_readers; ++r) {
+    threads.emplace_back([&]() {
+      for (size_t i = 0; i < nb_iterations; ++i) {
+        lock.requestReadAccess();
+        ++nb_inside_readers;
+        if ((nb_inside_writers != 0) || (a != b)) {
+          ++nb_errors;
+        }
+        --nb_inside_readers;
+        lock.releaseReadAccess();
+      }
+    });
+  }
+
+  for (auto &t: threads) {
+    t.join();
+  }
+
+  cout << "Number of writes: " << a << " (expecting " << nb_writers * nb_iterations << ")" << endl;
+  cout << "Number of errors: " << nb_errors << " (expecting 0)" << endl << endl;
+  assert(a == nb_writers * nb_iterations);
+  assert(a == b);
+  assert(nb_errors == 0);
+
+}
+
+template <typename Lock>
+void test_lock(const string &name) {
+  test_sequential<Lock>(name);
+  for (size_t r = 0; r <= 4; r += 2) {
+    for (size_t w = 1; w <= 4; w <<= 1) {
+      test_concurrent<Lock>(name, r, w, 2000);
+    }
+  }
+  // Oversubscribed run (which should not take forever).
+  test_concurrent<Lock>(name, 4 * thread::hardware_concurrency(), 2 * thread::hardware_concurrency(), 500);
+}
+
+int main() {
+
+  test_backoff();
+  test_lock<ReadWriteLock>("ReadWriteLock");
+  test_lock<DistributedReadWriteLock>("DistributedReadWriteLock");
+
+  return 0;
+}
@@ -0,0 +1,173 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "nucleotide_kernel.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+/*
+ * Reference (character by character) implementations.
+ */
+
+bool is_valid(char c, NucleotideKernel::Alphabet alphabet) {
+  switch (c) {
+  case 'A':
+  case 'C':
+  case 'G':
+  case 'T': return true;
+  case 'U': return alphabet != NucleotideKernel::UPPER_ACGT;
+  case 'a':
+  case 'c':
+  case 'g':
+  case 't':
+  case 'u': return alphabet == NucleotideKernel::ACGTU;
+  default: return false;
+  }
+}
+
+uint64_t code(char c) {
+  switch (c) {
+  case 'A': case 'a': return 0;
+  case 'C': case 'c': return 1;
+  case 'G': case 'g': return 2;
+  default: return 3;
+  }
+}
+
+vector<NucleotideKernel::Level> supported_levels() {
+  vector<NucleotideKernel::Level> levels;
+  for (NucleotideKernel::Level level: { NucleotideKernel::SCALAR, NucleotideKernel::SSE4, NucleotideKernel::AVX2 }) {
+    if (level <= NucleotideKernel::bestLevel()) {
+      levels.push_back(level);
+    }
+  }
+  return levels;
+}
+
+void test_validation(const string &s) {
+  for (NucleotideKernel::Alphabet alphabet: { NucleotideKernel::UPPER_ACGT, NucleotideKernel::UPPER_ACGTU, NucleotideKernel::ACGTU }) {
+    size_t first_invalid = s.size();
+    for (size_t i = s.size(); i--;) {
+      if (!is_valid(s[i], alphabet)) {
+        first_invalid = i;
+      }
+    }
+    for (NucleotideKernel::Level level: supported_levels()) {
+      assert(NucleotideKernel::findInvalid(s.data(), s.size(), alphabet, level) == first_invalid);
+      for (size_t n = 0; n <= 64 && n <= s.size(); ++n) {
+        uint64_t expected = 0;
+        for (size_t i = 0; i < n; ++i) {
+          expected |= uint64_t(!is_valid(s[i], alphabet)) << i;
+        }
+        assert(NucleotideKernel::invalidMask(s.data(), n, alphabet, level) == expected);
+      }
+    }
+  }
+}
+
+void test_encoding(const string &s) {
+  for (NucleotideKernel::Level level: supported_levels()) {
+    // The packed encoding is only relevant for valid nucleotides.
+    const size_t nb_valid = NucleotideKernel::findInvalid(s.data(), s.size(), NucleotideKernel::ACGTU, level);
+    for (size_t n = 1; n <= 32 && n <= nb_valid; ++n) {
+      uint64_t expected = 0, expected_rev = 0, expected_rc = 0;
+      for (size_t i = 0; i < n; ++i) {
+        expected = (expected << 2) | code(s[i]);
+        expected_rev = (expected_rev >> 2) | (code(s[i]) << (2 * (n - 1)));
+        expected_rc = (expected_rc >> 2) | ((3 ^ code(s[i])) << (2 * (n - 1)));
+      }
+      assert(NucleotideKernel::pack(s.data(), n, level) == expected);
+      assert(NucleotideKernel::reverse(expected, n) == expected_rev);
+      assert(NucleotideKernel::reverseComplement(expected, n) == expected_rc);
+    }
+    vector<uint64_t> packed((s.size() + 31) / 32), invalid((s.size() + 63) / 64);
+    size_t nb_invalid = NucleotideKernel::encode(s.data(), s.size(), packed.data(), invalid.data(),
+                                                 NucleotideKernel::UPPER_ACGT, level);
+    size_t expected_nb_invalid = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+      const bool is_invalid = !is_valid(s[i], NucleotideKernel::UPPER_ACGT);
+      expected_nb_invalid += is_invalid;
+      assert(bool((invalid[i / 64] >> (i % 64)) & 1) == is_invalid);
+      if (!is_invalid) {
+        const size_t n = min(size_t(32), s.size() - (i / 32) * 32);
+        assert(((packed[i / 32] >> (2 * (n - 1 - i % 32))) & 3) == code(s[i]));
+      }
+    }
+    assert(nb_invalid == expected_nb_invalid);
+  }
+}
+
+int main() {
+
+  cout << "Best available implementation: "
+       << NucleotideKernel::level2string(NucleotideKernel::bestLevel()) << endl << endl;
+
+  // Cheap deterministic pseudo random generator.
+  uint32_t x = 2463534242u;
+  const string symbols = "ACGTUacgtuNnRYWSKMBDHV-. \n>@;+X";
+  for (size_t nb = 0; nb < 2000; ++nb) {
+    string s(nb % 300, 'A');
+    for (auto &c: s) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      // Mostly valid nucleotides (with runs of various lengths).
+      c = ((x >> 8) % (1 + nb % 50)) ? "ACGT"[x & 3] : symbols[(x >> 16) % symbols.size()];
+    }
+    test_validation(s);
+    test_encoding(s);
+  }
+  cout << "All the implementations give the expected results." << endl;
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <utility>
+
+#include "suffix_hash_set.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+uint64_t randomValue(uint64_t mask) {
+  uint64_t v = (uint64_t(rand()) << 32) ^ uint64_t(rand());
+  return v & mask;
+}
+
+void check_same(const SuffixHashSet &s, const set<uint64_t> &expected) {
+  assert(s.size() == expected.size());
+  assert(s.empty() == expected.empty());
+  assert(8 * s.size() <= 7 * s.capacity());
+  set<uint64_t> values;
+  for (uint64_t v: s) {
+    assert(values.insert(v).second);
+  }
+  assert(values == expected);
+  for (uint64_t v: expected) {
+    assert(s.contains(v));
+  }
+}
+
+void test_suffix_hash_set(size_t n, uint64_t mask) {
+
+  cout << "Test of a suffix hash set of (at most) " << n << " values using mask " << hex << mask << dec << endl;
+
+  SuffixHashSet s;
+  set<uint64_t> expected;
+  assert(s.empty());
+  assert(s.capacity() == 0);
+  assert(s.begin() == s.end());
+  assert(!s.contains(0));
+
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t v = randomValue(mask);
+    bool inserted = expected.insert(v).second;
+    assert(s.contains(v) == !inserted);
+    assert(s.insert(v) == inserted);
+    assert(!s.insert(v));
+    assert(s.contains(v));
+  }
+  check_same(s, expected);
+  cout << "- " << s.size() << " values in " << s.capacity() << " slots (" << s.memory() << " bytes)" << endl;
+
+  // Values that were never inserted must not be found.
+  size_t nb_absent = 0;
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t v = randomValue(mask);
+    if (!expected.count(v)) {
+      assert(!s.contains(v));
+      ++nb_absent;
+    }
+  }
+  cout << "- " << nb_absent << " absent values correctly not found" << endl;
+
+  // Copies and moves must preserve the content.
+  SuffixHashSet copy(s);
+  check_same(copy, expected);
+  SuffixHashSet moved(std::move(copy));
+  check_same(moved, expected);
+  assert(copy.empty());
+  copy = moved;
+  check_same(copy, expected);
+  check_same(moved, expected);
+
+  s.clear();
+  assert(s.empty());
+  assert(s.capacity() == 0);
+  assert(moved.empty() || !s.contains(*moved.begin()));
+
+  cout << "================================" << endl;
+  cout << endl;
+}
+
+int main() {
+
+  srand(42);
+  for (size_t n: { 0, 1, 14, 15, 16, 1000, 100000 }) {
+    // The small mask produces a lot of duplicates.
+    for (uint64_t mask: { 0xFFull, 0xFFFFFull, ~0ull }) {
+      test_suffix_hash_set(n, mask);
+    }
+  }
+  return 0;
+
+}
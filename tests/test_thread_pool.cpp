@@ -0,0 +1,257 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "threaded_reader_writer.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+void test_independent_tasks(size_t nb_workers, size_t nb_tasks) {
+
+  cout << "*** Test of " << nb_tasks << " independent tasks using "
+       << nb_workers << " worker(s) ***" << endl;
+
+  ThreadPool pool(nb_workers);
+  assert(pool.size() == nb_workers);
+  assert(pool.currentWorker() == ThreadPool::npos);
+  vector<atomic_size_t> nb_runs(nb_tasks);
+  atomic_size_t nb_errors(0);
+  for (size_t i = 0; i < nb_tasks; ++i) {
+    nb_runs[i] = 0;
+    pool.submit([&, i]() {
+      if (pool.currentWorker() >= pool.size()) {
+        ++nb_errors;
+      }
+      ++nb_runs[i];
+    });
+  }
+  pool.wait();
+  for (size_t i = 0; i < nb_tasks; ++i) {
+    assert(nb_runs[i] == 1);
+  }
+  cout << "Number of errors: " << nb_errors << " (expecting 0)" << endl << endl;
+  assert(nb_errors == 0);
+
+}
+
+void test_work_stealing(size_t nb_workers, size_t nb_tasks) {
+
+  cout << "*** Test of " << nb_tasks << " tasks submitted by a single task using "
+       << nb_workers << " worker(s) ***" << endl;
+
+  ThreadPool pool(nb_workers);
+  vector<atomic_size_t> nb_tasks_per_worker(nb_workers);
+  for (auto &n: nb_tasks_per_worker) {
+    n = 0;
+  }
+  atomic_size_t sum(0);
+  // All the subtasks are pushed to the deque of a single worker, so
+  // the other ones can only run them by stealing.
+  pool.submit([&]() {
+    for (size_t i = 1; i <= nb_tasks; ++i) {
+      pool.submit([&, i]() {
+        ++nb_tasks_per_worker[pool.currentWorker()];
+        sum += i;
+        this_thread::sleep_for(chrono::microseconds(50));
+      });
+    }
+  });
+  pool.wait();
+  size_t nb_busy_workers = 0;
+  for (auto &n: nb_tasks_per_worker) {
+    nb_busy_workers += (n > 0);
+  }
+  cout << "Sum: " << sum << " (expecting " << (nb_tasks * (nb_tasks + 1) / 2) << ")" << endl;
+  cout << "Number of workers having run some task: " << nb_busy_workers << "/" << nb_workers << endl << endl;
+  assert(sum == nb_tasks * (nb_tasks + 1) / 2);
+  assert((nb_workers == 1) || (nb_busy_workers > 1));
+
+}
+
+void test_recursive_tasks(size_t nb_workers, size_t depth) {
+
+  cout << "*** Test of a binary tree of tasks of depth " << depth << " using "
+       << nb_workers << " worker(s) ***" << endl;
+
+  ThreadPool pool(nb_workers);
+  atomic_size_t nb_leaves(0);
+  function<void(size_t)> split = [&](size_t d) {
+    if (d == 0) {
+      ++nb_leaves;
+    } else {
+      pool.submit([&, d]() { split(d - 1); });
+      pool.submit([&, d]() { split(d - 1); });
+    }
+  };
+  pool.submit([&]() { split(depth); });
+  pool.wait();
+  cout << "Number of leaves: " << nb_leaves << " (expecting " << (size_t(1) << depth) << ")" << endl << endl;
+  assert(nb_leaves == (size_t(1) << depth));
+
+}
+
+void test_exception(size_t nb_workers) {
+
+  cout << "*** Test of exception propagation using " << nb_workers << " worker(s) ***" << endl;
+
+  ThreadPool pool(nb_workers);
+  atomic_size_t nb_runs(0);
+  for (size_t i = 0; i < 100; ++i) {
+    pool.submit([&, i]() {
+      ++nb_runs;
+      if (i % 10 == 3) {
+        throw runtime_error("expected failure");
+      }
+    });
+  }
+  bool thrown = false;
+  try {
+    pool.wait();
+  } catch (const runtime_error &e) {
+    thrown = true;
+  }
+  cout << "Exception rethrown: " << (thrown ? "yes" : "no") << " (expecting yes)" << endl;
+  assert(thrown);
+  assert(nb_runs == 100);
+  // The exception is reported once and the pool is still usable.
+  pool.submit([&]() { ++nb_runs; });
+  pool.wait();
+  cout << "Number of runs: " << nb_runs << " (expecting 101)" << endl << endl;
+  assert(nb_runs == 101);
+
+}
+
+// Counts the number of times each block (identified by its index) is
+// processed.
+struct BlockCounter {
+  vector<atomic_size_t> *nb_processed;
+  void process(size_t &block) {
+    ++(*nb_processed)[block];
+  }
+};
+
+// Produces the blocks of indices first, first + step, first + 2 *
+// step, ... up to nb_blocks.
+struct BlockProducer {
+  size_t next, step, nb_blocks;
+  bool nextBlock(size_t &block) {
+    if (next >= nb_blocks) {
+      return false;
+    }
+    block = next;
+    next += step;
+    return true;
+  }
+};
+
+class TestReaderWriter: public ThreadedReaderWriter<BlockCounter, BlockProducer, size_t> {
+public:
+  TestReaderWriter(size_t queue_size, size_t nb_readers, size_t nb_writers,
+                   size_t nb_blocks, vector<atomic_size_t> &nb_processed):
+    ThreadedReaderWriter<BlockCounter, BlockProducer, size_t>(queue_size, nb_readers, nb_writers) {
+    for (size_t i = 0; i < nb_readers; ++i) {
+      _readers.push_back(BlockCounter { &nb_processed });
+    }
+    for (size_t i = 0; i < nb_writers; ++i) {
+      _writers.push_back(BlockProducer { i, nb_writers, nb_blocks });
+    }
+  }
+  bool queueEmpty() const {
+    return _queue.empty();
+  }
+};
+
+void test_reader_writer(size_t nb_workers, size_t nb_writers, size_t queue_size, size_t nb_blocks) {
+
+  cout << "*** Test of " << nb_writers << " writer(s) of " << nb_blocks << " blocks through a queue of size "
+       << queue_size << " using " << nb_workers << " worker(s) ***" << endl;
+
+  ThreadPool pool(nb_workers);
+  vector<atomic_size_t> nb_processed(nb_blocks);
+  for (auto &n: nb_processed) {
+    n = 0;
+  }
+  TestReaderWriter rw(queue_size, nb_workers, nb_writers, nb_blocks, nb_processed);
+  rw.run(pool);
+  size_t nb_errors = 0;
+  for (auto &n: nb_processed) {
+    nb_errors += (n != 1);
+  }
+  cout << "Number of blocks not processed exactly once: " << nb_errors << " (expecting 0)" << endl << endl;
+  assert(nb_errors == 0);
+  assert(rw.queueEmpty());
+
+}
+
+int main() {
+
+  for (size_t nb_workers: { 1, 2, 4, 8 }) {
+    test_independent_tasks(nb_workers, 10000);
+    test_work_stealing(nb_workers, 1000);
+    test_recursive_tasks(nb_workers, 12);
+    test_exception(nb_workers);
+  }
+
+  // Having more workers than writers makes some tasks fail to pop
+  // their block while it is being published.
+  for (size_t nb_workers: { 1, 2, 8 }) {
+    for (size_t nb_writers: { 1, 3 }) {
+      for (size_t queue_size: { 4, 64 }) {
+        test_reader_writer(nb_workers, nb_writers, queue_size, 6000);
+      }
+    }
+  }
+
+  return 0;
+}
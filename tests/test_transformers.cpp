@@ -0,0 +1,639 @@
+/******************************************************************************
+*                                                                             *
+*  Copyright © 2024-2025 -- LIRMM/CNRS/UM                                     *
+*                           (Laboratoire d'Informatique, de Robotique et de   *
+*                           Microélectronique de Montpellier /                *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Montpellier)                        *
+*                           CRIStAL/CNRS/UL                                   *
+*                           (Centre de Recherche en Informatique, Signal et   *
+*                           Automatique de Lille /                            *
+*                           Centre National de la Recherche Scientifique /    *
+*                           Université de Lille)                              *
+*                                                                             *
+*  Auteurs/Authors:                                                           *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Annie   CHATEAU    <annie.chateau@lirmm.fr>               *
+*                   Antoine LIMASSET   <antoine.limasset@univ-lille.fr>       *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                   Camille MARCHET    <camille.marchet@univ-lille.fr>        *
+*                                                                             *
+*  Programmeurs/Programmers:                                                  *
+*                   Clément AGRET      <cagret@mailo.com>                     *
+*                   Alban   MANCHERON  <alban.mancheron@lirmm.fr>             *
+*                                                                             *
+*  -------------------------------------------------------------------------  *
+*                                                                             *
+*  This file is part of BijectHash.                                           *
+*                                                                             *
+*  BijectHash is free software: you can redistribute it and/or modify it      *
+*  under the terms of the GNU General Public License as published by the      *
+*  Free Software Foundation, either version 3 of the License, or (at your     *
+*  option) any later version.                                                 *
+*                                                                             *
+*  BijectHash is distributed in the hope that it will be useful, but WITHOUT  *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      *
+*  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for   *
+*  more details.                                                              *
+*                                                                             *
+*  You should have received a copy of the GNU General Public License along    *
+*  with BijectHash. If not, see <https://www.gnu.org/licenses/>.              *
+*                                                                             *
+******************************************************************************/
+
+#ifdef NDEBUG
+#  undef NDEBUG
+#endif
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef PLUGINS_DIR
+#  define PLUGINS_DIR "../src/transformers/"
+#endif
+
+#include "exception.hpp"
+#include "static_transformer.hpp"
+#include "transformer.hpp"
+
+using namespace std;
+using namespace bijecthash;
+
+/*
+ * The transformers are provided by the plugins compiled with
+ * assertion checkings (thus their labels have the "-check" suffix).
+ */
+const string suffix = "-check";
+
+void load_plugins() {
+  for (const char *plugin: {
+      "basic/.libs/kmer-transformers-basic-plugin-debug.so",
+      "extra/.libs/kmer-transformers-extra-plugin-debug.so" }) {
+    const bool loaded = Transformer::addPlugin(string(PLUGINS_DIR) + plugin);
+    if (!loaded) {
+      cerr << "Unable to load the plugin '" << PLUGINS_DIR << plugin << "'" << endl;
+    }
+    assert(loaded);
+  }
+}
+
+shared_ptr<const Transformer> build(size_t k, size_t p, const string &label, const string &extra = "") {
+  return Transformer::string2transformer(k, p, label + suffix + extra);
+}
+
+// Cheap deterministic pseudo random generator.
+uint64_t next_random() {
+  static uint64_t x = 88172645463325252ull;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return x;
+}
+
+uint64_t pack(const string &kmer) {
+  assert(kmer.size() <= 32);
+  uint64_t v = 0;
+  for (char c: kmer) {
+    v = (v << 2) | ((c == 'A') ? 0 : ((c == 'C') ? 1 : ((c == 'G') ? 2 : 3)));
+  }
+  return v;
+}
+
+string unpack(uint64_t v, size_t k) {
+  string kmer(k, 'A');
+  for (size_t i = k; i--; v >>= 2) {
+    kmer[i] = "ACGT"[v & 3];
+  }
+  return kmer;
+}
+
+string reverse_complement(const string &kmer) {
+  string rc(kmer.rbegin(), kmer.rend());
+  for (char &c: rc) {
+    c = (c == 'A') ? 'T' : ((c == 'C') ? 'G' : ((c == 'G') ? 'C' : 'A'));
+  }
+  return rc;
+}
+
+string periodic(const string &pattern, size_t k) {
+  string kmer;
+  while (kmer.size() < k) {
+    kmer += pattern;
+  }
+  return kmer.substr(0, k);
+}
+
+// Some random k-mers, some periodic ones and some palindromes (which
+// are their own reverse complement).
+vector<string> test_kmers(size_t k) {
+  vector<string> kmers;
+  for (const char *pattern: { "A", "T", "AC", "CA", "ACG", "ACGT", "TGCA", "AACC" }) {
+    kmers.push_back(periodic(pattern, k));
+  }
+  for (size_t i = 0; i < 200; ++i) {
+    string kmer(k, 'A');
+    for (char &c: kmer) {
+      c = "ACGT"[next_random() & 3];
+    }
+    kmers.push_back(kmer);
+    if (!(k & 1)) {
+      const string half = kmer.substr(0, k / 2);
+      kmers.push_back(half + reverse_complement(half));
+    }
+  }
+  return kmers;
+}
+
+// The k-mer lengths to test (the largest ones are only handled as
+// strings).
+const vector<size_t> kmer_lengths = { 2, 3, 4, 5, 8, 11, 15, 16, 21, 25, 31, 32, 33, 40, 47, 63 };
+
+// Some prefix lengths for the given k-mer length (such that the
+// suffix length is at most the given one).
+vector<size_t> prefix_lengths(size_t k, size_t max_suffix_length = 31) {
+  vector<size_t> lengths;
+  for (size_t p: { size_t(1), k / 2, k - max_suffix_length, k - 1 }) {
+    if ((p > 0) && (p < k) && (p <= 32) && (k - p <= max_suffix_length)
+        && (find(lengths.begin(), lengths.end(), p) == lengths.end())) {
+      lengths.push_back(p);
+    }
+  }
+  return lengths;
+}
+
+bool operator==(const Transformer::EncodedKmer &e1, const Transformer::EncodedKmer &e2) {
+  return (e1.prefix == e2.prefix) && (e1.suffix == e2.suffix);
+}
+
+/*
+ * Check that the given transformer:
+ * - decodes the encoding of each k-mer to the k-mer itself;
+ * - gives the same encoding for a k-mer and for its packed version;
+ * - gives the same encodings for a batch of packed k-mers and for
+ *   each k-mer of the batch (including for batches whose length is
+ *   not a multiple of the vector width of some implementation).
+ */
+void check_transformer(const Transformer &t, const vector<string> &kmers) {
+  const size_t k = t.kmer_length;
+  vector<Transformer::EncodedKmer> expected;
+  expected.reserve(kmers.size());
+  for (const string &kmer: kmers) {
+    const Transformer::EncodedKmer e = t(kmer);
+    if (t(e) != kmer) {
+      cerr << t.description << " (k = " << k << ", p = " << t.prefix_length << "):" << endl
+           << "- original kmer: '" << kmer << "'" << endl
+           << "- decoded kmer:  '" << t(e) << "'" << endl;
+    }
+    assert(t(e) == kmer);
+    expected.push_back(e);
+    if (k <= 32) {
+      assert(t(pack(kmer)) == e);
+      // The packed transformed k-mer is the joined encoding.
+      assert(t.transformPacked(pack(kmer)) == pack(t.getTransformedKmer(e)));
+    }
+  }
+  if (k <= 32) {
+    vector<uint64_t> packed;
+    for (const string &kmer: kmers) {
+      packed.push_back(pack(kmer));
+    }
+    vector<Transformer::EncodedKmer> encoded(kmers.size());
+    for (size_t first = 0; first < 9; ++first) {
+      for (size_t n: { size_t(0), size_t(1), size_t(3), size_t(7), size_t(17), kmers.size() - first }) {
+        assert(first + n <= kmers.size());
+        t.transformBatch(packed.data() + first, n, encoded.data());
+        for (size_t i = 0; i < n; ++i) {
+          assert(encoded[i] == expected[first + i]);
+        }
+      }
+    }
+  }
+}
+
+void test_canonical() {
+  cout << "*** Canonical transformer ***" << endl;
+  size_t nb = 0;
+  for (size_t k: kmer_lengths) {
+    const vector<string> kmers = test_kmers(k);
+    for (size_t p: prefix_lengths(k)) {
+      shared_ptr<const Transformer> t = build(k, p, "canonical");
+      check_transformer(*t, kmers);
+      for (const string &kmer: kmers) {
+        // The transformed k-mer is the lowest between the k-mer and
+        // its reverse complement.
+        const string rc = reverse_complement(kmer);
+        assert(t->getTransformedKmer((*t)(kmer)) == min(kmer, rc));
+        // Both give the same transformed k-mer but are distinguished
+        // (except palindromes which are their own reverse complement).
+        assert(t->getTransformedKmer((*t)(rc)) == min(kmer, rc));
+        assert(((*t)(rc) == (*t)(kmer)) == (rc == kmer));
+      }
+      ++nb;
+    }
+  }
+  cout << "The " << nb << " canonical transformers give the expected results." << endl << endl;
+}
+
+// The comma separated list of the given values.
+string join(const vector<size_t> &values) {
+  string s;
+  for (size_t v: values) {
+    s += (s.empty() ? "" : ",") + to_string(v);
+  }
+  return s;
+}
+
+// Apply the given bit permutation (the i-th bit of the result is the
+// p[i]-th bit of the given value).
+uint64_t permute_bits(uint64_t v, const vector<size_t> &p) {
+  uint64_t permuted = 0;
+  for (size_t i = 0; i < p.size(); ++i) {
+    permuted |= ((v >> p[i]) & 1) << i;
+  }
+  return permuted;
+}
+
+void test_permutation_bit() {
+  cout << "*** Bit permutation transformer ***" << endl;
+  size_t nb = 0;
+  for (size_t k: kmer_lengths) {
+    const vector<string> kmers = test_kmers(k);
+    const size_t n = (k <= 32) ? 2 * k : 64;
+    // A random permutation, the identity, the reversal and a
+    // permutation swapping the two bits of each nucleotide.
+    vector<size_t> identity(n), reversal(n), swap(n);
+    for (size_t i = 0; i < n; ++i) {
+      identity[i] = i;
+      reversal[i] = n - 1 - i;
+      swap[i] = i ^ 1;
+    }
+    for (size_t p: prefix_lengths(k)) {
+      shared_ptr<const Transformer> t = build(k, p, "random_bits");
+      check_transformer(*t, kmers);
+      ++nb;
+      for (const vector<size_t> &permutation: { identity, reversal, swap }) {
+        t = build(k, p, "random_bits", "=" + join(permutation));
+        check_transformer(*t, kmers);
+        if (k <= 32) {
+          for (const string &kmer: kmers) {
+            assert(t->transformPacked(pack(kmer)) == permute_bits(pack(kmer), permutation));
+          }
+        }
+        ++nb;
+      }
+    }
+  }
+  cout << "The " << nb << " bit permutation transformers give the expected results." << endl << endl;
+}
+
+void test_permutation() {
+  cout << "*** Nucleotide permutation transformer ***" << endl;
+  size_t nb = 0;
+  for (size_t k: kmer_lengths) {
+    const vector<string> kmers = test_kmers(k);
+    // The reversal, some rotations and some scattering permutations
+    // (the random one being built from the random bit generator).
+    vector<vector<size_t>> permutations;
+    vector<size_t> permutation(k);
+    for (size_t i = 0; i < k; ++i) {
+      permutation[i] = k - 1 - i;
+    }
+    permutations.push_back(permutation);
+    for (size_t shift: { size_t(1), k / 2, k - 1 }) {
+      for (size_t i = 0; i < k; ++i) {
+        permutation[i] = (i + shift) % k;
+      }
+      permutations.push_back(permutation);
+    }
+    for (size_t i = 0; i < k; ++i) {
+      permutation[i] = ((i & 1) ? (k - i - (k & 1)) : i);
+    }
+    permutations.push_back(permutation);
+    for (size_t i = k; i > 1; --i) {
+      std::swap(permutation[i - 1], permutation[next_random() % i]);
+    }
+    permutations.push_back(permutation);
+    for (size_t p: prefix_lengths(k)) {
+      for (const vector<size_t> &permutation: permutations) {
+        shared_ptr<const Transformer> t = build(k, p, "random_nucl", "=" + join(permutation));
+        check_transformer(*t, kmers);
+        for (const string &kmer: kmers) {
+          // The i-th nucleotide of the transformed k-mer is the p[i]-th
+          // nucleotide of the k-mer.
+          string expected(k, 'A');
+          for (size_t i = 0; i < k; ++i) {
+            expected[i] = kmer[permutation[i]];
+          }
+          assert(t->getTransformedKmer((*t)(kmer)) == expected);
+        }
+        ++nb;
+      }
+      // The same permutations built by the dedicated methods.
+      for (const char *method: { "inverse", "cyclic", "zigzag", "random_nucl" }) {
+        check_transformer(*build(k, p, method), kmers);
+        ++nb;
+      }
+      check_transformer(*build(k, p, "cyclic", "=" + to_string(k / 2)), kmers);
+      ++nb;
+    }
+  }
+  cout << "The " << nb << " nucleotide permutation transformers give the expected results." << endl << endl;
+}
+
+// The lowest rotation of the given k-mer.
+string lowest_rotation(const string &kmer) {
+  string lowest = kmer;
+  for (size_t i = 1; i < kmer.size(); ++i) {
+    lowest = min(lowest, kmer.substr(i) + kmer.substr(0, i));
+  }
+  return lowest;
+}
+
+void test_lyndon() {
+  cout << "*** Lyndon transformer ***" << endl;
+  size_t nb = 0;
+  for (size_t k: kmer_lengths) {
+    const vector<string> kmers = test_kmers(k);
+    for (size_t p: prefix_lengths(k, 29)) {
+      shared_ptr<const Transformer> t = build(k, p, "lyndon");
+      check_transformer(*t, kmers);
+      for (const string &kmer: kmers) {
+        // The transformed k-mer is the lowest rotation (which is not
+        // unique for periodic k-mers).
+        assert(t->getTransformedKmer((*t)(kmer)) == lowest_rotation(kmer));
+      }
+      ++nb;
+    }
+  }
+  cout << "The " << nb << " Lyndon transformers give the expected results." << endl << endl;
+}
+
+void test_bwt() {
+  cout << "*** BWT transformer ***" << endl;
+  size_t nb = 0;
+  for (size_t k: kmer_lengths) {
+    const vector<string> kmers = test_kmers(k);
+    for (size_t p: prefix_lengths(k, 29)) {
+      shared_ptr<const Transformer> t = build(k, p, "bwt");
+      check_transformer(*t, kmers);
+      for (const string &kmer: kmers) {
+        // Naive BWT: the last symbols of the sorted rotations. The
+        // stored row is the last one of the k-mer (periodic k-mers
+        // appear on several consecutive rows).
+        vector<string> rotations;
+        for (size_t i = 0; i < k; ++i) {
+          rotations.push_back(kmer.substr(i) + kmer.substr(0, i));
+        }
+        sort(rotations.begin(), rotations.end());
+        string bwt;
+        size_t bwt_pos = 0;
+        for (size_t i = 0; i < k; ++i) {
+          bwt += rotations[i][k - 1];
+          if (rotations[i] == kmer) {
+            bwt_pos = i;
+          }
+        }
+        const Transformer::EncodedKmer e = (*t)(kmer);
+        assert(t->getTransformedKmer(e) == bwt);
+        assert((e.suffix >> 58) == bwt_pos);
+      }
+      ++nb;
+    }
+  }
+  cout << "The " << nb << " BWT transformers give the expected results." << endl << endl;
+}
+
+void test_minimizer() {
+  cout << "*** Minimizer transformer ***" << endl;
+  size_t nb = 0;
+  for (size_t k: kmer_lengths) {
+    const vector<string> kmers = test_kmers(k);
+    for (size_t p: prefix_lengths(k, 29)) {
+      for (const char *extra: { "", "=xorshift", "=lexicographic", "=random", "=random,42" }) {
+        shared_ptr<const Transformer> t = build(k, p, "minimizer", extra);
+        check_transformer(*t, kmers);
+        for (const string &kmer: kmers) {
+          // The transformed k-mer is the minimizer followed by the
+          // nucleotides before and after it.
+          const Transformer::EncodedKmer e = (*t)(kmer);
+          const size_t pos = e.suffix >> 58;
+          assert(pos + p <= k);
+          assert(t->getTransformedKmer(e) == kmer.substr(pos, p) + kmer.substr(0, pos) + kmer.substr(pos + p));
+          if (string(extra) == "=lexicographic") {
+            // The first occurrence of the lowest candidate is kept on
+            // ties (e.g., periodic k-mers).
+            size_t expected = 0;
+            for (size_t i = 1; i + p <= k; ++i) {
+              if (kmer.compare(i, p, kmer, expected, p) < 0) {
+                expected = i;
+              }
+            }
+            assert(pos == expected);
+          }
+        }
+        ++nb;
+      }
+      // The random tables only depend on the seed.
+      shared_ptr<const Transformer> t1 = build(k, p, "minimizer", "=random,42");
+      shared_ptr<const Transformer> t2 = build(k, p, "minimizer", "=random,42");
+      assert(t1->getParameters() == "random,42");
+      for (const string &kmer: kmers) {
+        assert((*t1)(kmer) == (*t2)(kmer));
+      }
+    }
+  }
+  cout << "The " << nb << " minimizer transformers give the expected results." << endl;
+
+  // Only the random ordering accepts a seed, which must be a non
+  // empty unsigned decimal value.
+  for (const char *extra: { "=random,", "=random,abc", "=random,-1", "=random,+1", "=random, 1",
+                            "=random,1a", "=xorshift,1", "=lexicographic,1", "=foo" }) {
+    bool thrown = false;
+    try {
+      build(21, 8, "minimizer", extra);
+    } catch (const Exception &) {
+      thrown = true;
+    }
+    if (!thrown) {
+      cerr << "The minimizer parameters '" << extra << "' should be rejected." << endl;
+    }
+    assert(thrown);
+  }
+  cout << "The invalid minimizer parameters are rejected." << endl << endl;
+}
+
+// Thomas Wang's 64 bits integer hash restricted to the given mask.
+uint64_t int_hash(uint64_t key, uint64_t mask) {
+  key = (~key + (key << 21)) & mask;
+  key = key ^ key >> 24;
+  key = (key * 265) & mask;
+  key = key ^ key >> 14;
+  key = (key * 21) & mask;
+  key = key ^ key >> 28;
+  key = (key + (key << 31)) & mask;
+  return key;
+}
+
+// The GaB function: the halves of the value are swapped, then xored
+// with b and multiplied by a.
+uint64_t gab_hash(uint64_t key, uint64_t a, uint64_t b, size_t half, uint64_t mask) {
+  const uint64_t rotated = ((key << half) | (key >> half)) & mask;
+  return (a * (rotated ^ b)) & mask;
+}
+
+// Apply the given hash function on the 32 first nucleotides of the
+// k-mer (the remaining ones are unchanged).
+template <typename F>
+string hash_kmer(const string &kmer, F hash) {
+  const size_t n = min<size_t>(kmer.size(), 32);
+  return unpack(hash(pack(kmer.substr(0, n))), n) + kmer.substr(n);
+}
+
+void test_hash() {
+  cout << "*** Hash transformers ***" << endl;
+  size_t nb = 0;
+  for (size_t k: kmer_lengths) {
+    const vector<string> kmers = test_kmers(k);
+    const size_t half = min<size_t>(k, 32);
+    const uint64_t mask = (half == 32) ? uint64_t(-1) : ((1ull << (2 * half)) - 1);
+    for (size_t p: prefix_lengths(k)) {
+      shared_ptr<const Transformer> t = build(k, p, "inthash");
+      check_transformer(*t, kmers);
+      for (const string &kmer: kmers) {
+        assert(t->getTransformedKmer((*t)(kmer))
+               == hash_kmer(kmer, [mask](uint64_t v) { return int_hash(v, mask); }));
+      }
+      ++nb;
+      for (const char *extra: { "", "=12345,6789", "=12344,6789", "=1,0" }) {
+        t = build(k, p, "Gab", extra);
+        check_transformer(*t, kmers);
+        // Check the parameters (a is odd and b is masked).
+        const string params = t->getParameters();
+        const uint64_t a = stoull(params);
+        const uint64_t b = stoull(params.substr(params.find(',') + 1));
+        assert(a & 1);
+        assert((b & mask) == b);
+        if (string(extra) == "=12345,6789" || string(extra) == "=12344,6789") {
+          assert(a == 12345);
+          assert(b == (6789 & mask));
+        }
+        for (const string &kmer: kmers) {
+          assert(t->getTransformedKmer((*t)(kmer))
+                 == hash_kmer(kmer, [=](uint64_t v) { return gab_hash(v, a, b, half, mask); }));
+        }
+        ++nb;
+      }
+    }
+  }
+  cout << "The " << nb << " hash transformers give the expected results." << endl << endl;
+}
+
+void test_composition() {
+  cout << "*** Composition transformer ***" << endl;
+  // All the stages but the last one must be bijective on the whole
+  // k-mer (the canonical transformer can only be the last one).
+  const vector<pair<string, string> > operands = {
+    { "identity", "inverse" },
+    { "inverse", "zigzag" },
+    { "zigzag", "canonical" },
+    { "cyclic", "Gab=12345,6789" },
+    { "Gab=3,5", "inthash" },
+    { "inthash", "canonical" },
+    { "inverse", "bwt" },
+    { "Gab=12345,6789", "minimizer=lexicographic" }
+  };
+  size_t nb = 0;
+  for (size_t k: kmer_lengths) {
+    const vector<string> kmers = test_kmers(k);
+    for (size_t p: prefix_lengths(k, 29)) {
+      for (const pair<string, string> &o: operands) {
+        const size_t sep1 = o.first.find('=');
+        const size_t sep2 = o.second.find('=');
+        const string name1 = o.first.substr(0, sep1) + suffix + ((sep1 == string::npos) ? "" : o.first.substr(sep1));
+        const string name2 = o.second.substr(0, sep2) + suffix + ((sep2 == string::npos) ? "" : o.second.substr(sep2));
+        shared_ptr<const Transformer> t1 = Transformer::string2transformer(k, p, name1);
+        shared_ptr<const Transformer> t2 = Transformer::string2transformer(k, p, name2);
+        shared_ptr<const Transformer> t = build(k, p, "composition", "=(" + name1 + "*" + name2 + ")");
+        check_transformer(*t, kmers);
+        for (const string &kmer: kmers) {
+          // The first operand is applied first.
+          const string s1 = t1->getTransformedKmer((*t1)(kmer));
+          assert(t->getTransformedKmer((*t)(kmer)) == t2->getTransformedKmer((*t2)(s1)));
+        }
+        ++nb;
+      }
+      // Nested compositions are flattened.
+      const string inner = "composition" + suffix + "=(zigzag" + suffix + "*inthash" + suffix + ")";
+      shared_ptr<const Transformer> t = build(k, p, "composition", "=(inverse" + suffix + "*" + inner + ")");
+      check_transformer(*t, kmers);
+      ++nb;
+    }
+  }
+  cout << "The " << nb << " composition transformers give the expected results." << endl << endl;
+}
+
+void test_static_transformer() {
+  cout << "*** Static transformer ***" << endl;
+  // The specialized (k, p) pairs (see static_transformer.cpp).
+  const vector<size_t> specialized_kmer_lengths = { 15, 21, 25, 31 };
+  const size_t max_prefix_length = 13;
+  size_t nb = 0, nb_specialized = 0;
+  for (size_t k: { 2, 5, 11, 15, 16, 21, 25, 31, 32 }) {
+    const vector<string> kmers = test_kmers(k);
+    vector<uint64_t> packed;
+    for (const string &kmer: kmers) {
+      packed.push_back(pack(kmer));
+    }
+    vector<Transformer::EncodedKmer> expected(kmers.size()), encoded(kmers.size());
+    for (size_t p = 1; p < k; ++p) {
+      // The inthash transformer has no specialized implementation.
+      for (const char *method: { "identity", "canonical", "Gab=12345,6789", "Gab", "inthash" }) {
+        const string name = method;
+        const size_t sep = name.find('=');
+        shared_ptr<const Transformer> t = build(k, p, name.substr(0, sep), (sep == string::npos) ? "" : name.substr(sep));
+        const StaticTransformer st(t);
+        const bool has_kernel = (t->getKernel().kind != Transformer::Kernel::GENERIC);
+        const bool specialized_pair = ((find(specialized_kmer_lengths.begin(), specialized_kmer_lengths.end(), k)
+                                        != specialized_kmer_lengths.end())
+                                       && (p <= max_prefix_length));
+        assert(st.specialized() == (has_kernel && specialized_pair));
+        nb_specialized += st.specialized();
+        for (size_t i = 0; i < kmers.size(); ++i) {
+          expected[i] = (*t)(packed[i]);
+          assert(st(packed[i]) == expected[i]);
+        }
+        for (size_t first = 0; first < 9; ++first) {
+          const size_t n = kmers.size() - first;
+          st.transformBatch(packed.data() + first, n, encoded.data());
+          for (size_t i = 0; i < n; ++i) {
+            assert(encoded[i] == expected[first + i]);
+          }
+        }
+        ++nb;
+      }
+    }
+  }
+  cout << "The " << nb << " static transformers (" << nb_specialized << " specialized ones)"
+       << " give the same encodings as the transformers." << endl << endl;
+}
+
+int main() {
+
+  load_plugins();
+
+  test_canonical();
+  test_permutation_bit();
+  test_permutation();
+  test_lyndon();
+  test_bwt();
+  test_minimizer();
+  test_hash();
+  test_composition();
+  test_static_transformer();
+
+  return 0;
+}